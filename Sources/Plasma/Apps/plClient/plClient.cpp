@@ -78,10 +78,12 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 #include "pnMessage/plTimeMsg.h"
 #include "pnSceneObject/plCoordinateInterface.h"
 #include "pnSceneObject/plSceneObject.h"
+#include "pnSceneObject/plTransformHierarchy.h"
 
 #include "plAgeLoader/plAgeLoader.h"
 #include "plAgeLoader/plResPatcher.h"
 #include "plAnimation/plAGAnimInstance.h"
+#include "plAnimation/plAGMasterMod.h"
 #include "plAudio/plAudioSystem.h"
 #include "plAvatar/plArmatureMod.h"
 #include "plAvatar/plAvatarClothing.h"
@@ -1045,6 +1047,10 @@ void plClient::IQueueRoomLoad(const std::vector<plLocation>& locs, bool hold)
 
         fLoadRooms.push_back(new LoadRequest(loc, hold));
 
+        // Get the page data off the disk while the rooms ahead of it are loading
+        plResManager* mgr = static_cast<plResManager*>(hsgResMgr::ResMgr());
+        mgr->PrefetchPage(loc);
+
         if (lastAgeName.empty() || info->GetAge() == lastAgeName)
             lastAgeName = info->GetAge();
         else
@@ -1109,6 +1115,9 @@ void plClient::IUnloadRooms(const std::vector<plLocation>& locs)
         if (!loc.IsValid())
             continue;
 
+        // No point holding on to the page data if the room was still waiting to load
+        static_cast<plResManager*>(hsgResMgr::ResMgr())->CancelPrefetch(loc);
+
         plKey nodeKey;
 
         // First, look in our room list. It *should* be there, which allows us to avoid a
@@ -1311,7 +1320,11 @@ void plClient::IRoomUnloaded(plSceneNode* node)
 
 void plClient::IReadKeyedObjCallback(const plKey& key)
 {
-    fInstance->IIncProgress(1, key->GetName().c_str());
+    // No key means we're waiting on a page read, so just keep the screen fresh
+    if (key)
+        fInstance->IIncProgress(1, key->GetName().c_str());
+    else if (fInstance->fProgressBar)
+        fInstance->fProgressBar->Increment(0);
 }
 
 //============================================================================
@@ -1411,7 +1424,7 @@ bool plClient::StartInit()
     hsStatusMessage("Init client");
     fFlags.SetBit( kFlagIniting );
 
-    pfLocalizationMgr::Initialize("dat");
+    pfLocalizationMgr::Initialize("dat", plFileName::Join(plFileSystem::GetUserDataPath(), "Localization.cache"));
 
     plQuality::SetQuality(fQuality);
     if( (GetClampCap() >= 0) && (GetClampCap() < plQuality::GetCapability()) )
@@ -1604,6 +1617,7 @@ plProfile_CreateTimer("ResMgr", "Update", ResMgr);
 plProfile_CreateTimer("DispatchQueue", "Update", DispatchQueue);
 plProfile_CreateTimer("RenderSetup", "Update", RenderMsg);
 plProfile_CreateTimer("Simulation", "Update", Simulation);
+plProfile_CreateTimer("SimulationFetch", "Update", SimulationFetch);
 plProfile_CreateTimer("NetTime", "Update", UpdateNetTime);
 plProfile_Extern(TimeMsg);
 plProfile_Extern(EvalMsg);
@@ -1633,6 +1647,12 @@ bool plClient::IUpdate()
     if (hsTimer::GetSysSeconds()==0 && hsTimer::IsRealTime() && hsTimer::GetTimeClamp()==0)
         hsTimer::SetRealTime(true);
 
+    // If the simulation is stepping asynchronously, last frame's step has been running
+    // while we drew. Land it before any messages get a chance to touch the physicals.
+    plProfile_BeginTiming(SimulationFetch);
+    plSimulationMgr::GetInstance()->FinishAdvance();
+    plProfile_EndTiming(SimulationFetch);
+
     plProfile_BeginTiming(DispatchQueue);
     plgDispatch::Dispatch()->MsgQueueProcess();
     plProfile_EndTiming(DispatchQueue);
@@ -1673,10 +1693,15 @@ bool plClient::IUpdate()
     plgDispatch::MsgSend(eval);
     plProfile_EndTiming(EvalMsg);
 
+    // Animations queued up during the eval get evaluated together here.
+    plAGMasterMod::ApplyQueuedAnimations();
+
     const ST::string xFormLap1 = ST_LITERAL("Main");
     plProfile_BeginLap(TransformMsg, xFormLap1);
+    plTransformHierarchy::BeginQueue();
     plTransformMsg* xform = new plTransformMsg(nullptr, nullptr, nullptr, nullptr);
     plgDispatch::MsgSend(xform);
+    plTransformHierarchy::UpdateQueued();
     plProfile_EndLap(TransformMsg, xFormLap1);
 
     plCoordinateInterface::SetTransformPhase(plCoordinateInterface::kTransformPhaseDelayed);    
@@ -1692,14 +1717,18 @@ bool plClient::IUpdate()
     if (!plCoordinateInterface::GetDelayedTransformsEnabled())
     {
         plProfile_LapGuard(TransformMsg, ST_LITERAL("Simulation"));
+        plTransformHierarchy::BeginQueue();
         xform = new plTransformMsg(nullptr, nullptr, nullptr, nullptr);
         plgDispatch::MsgSend(xform);
+        plTransformHierarchy::UpdateQueued();
     }
     else
     {
         plProfile_LapGuard(TransformMsg, ST_LITERAL("Delayed"));
+        plTransformHierarchy::BeginQueue();
         xform = new plDelayedTransformMsg(nullptr, nullptr, nullptr, nullptr);
         plgDispatch::MsgSend(xform);
+        plTransformHierarchy::UpdateQueued();
     }
 
     plCoordinateInterface::SetTransformPhase(plCoordinateInterface::kTransformPhaseNormal);
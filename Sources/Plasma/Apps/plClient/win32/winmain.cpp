@@ -117,7 +117,8 @@ enum
     kArgStartUpAgeName,
     kArgPvdFile,
     kArgSkipIntroMovies,
-    kArgRenderer
+    kArgRenderer,
+    kArgPhysXThreads
 };
 
 static const plCmdArgDef s_cmdLineArgs[] = {
@@ -131,6 +132,7 @@ static const plCmdArgDef s_cmdLineArgs[] = {
     { kCmdArgFlagged  | kCmdTypeString,     "PvdFile",         kArgPvdFile },
     { kCmdArgFlagged  | kCmdTypeBool,       "SkipIntroMovies", kArgSkipIntroMovies },
     { kCmdArgFlagged  | kCmdTypeString,     "Renderer",        kArgRenderer },
+    { kCmdArgFlagged  | kCmdTypeInt,        "PhysXThreads",    kArgPhysXThreads },
 };
 
 plClientLoader  gClient;
@@ -1094,6 +1096,9 @@ int WINAPI wWinMain(HINSTANCE hInst, HINSTANCE hPrevInst, LPWSTR lpCmdLine, int
     if (cmdParser.IsSpecified(kArgServerIni))
         serverIni = cmdParser.GetString(kArgServerIni);
 
+    if (cmdParser.IsSpecified(kArgPhysXThreads))
+        plPXSimulation::SetDispatcherThreads(std::max(cmdParser.GetInt(kArgPhysXThreads), 0));
+
     // check to see if we were launched from the patcher
     bool eventExists = false;
     // we check to see if the event exists that the patcher should have created
@@ -47,12 +47,16 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 
 #include <cctype>
 #if HS_BUILD_FOR_WIN32
+#   include "hsWindows.h"
 #   include <io.h>
 #endif
 #include <algorithm>
 #include <string_theory/format>
 
 #if HS_BUILD_FOR_UNIX
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <unistd.h>
 #endif
 
@@ -789,6 +793,112 @@ void hsReadOnlyStream::CopyToMem(void* mem)
 }
 
 
+////////////////////////////////////////////////////////////////////////////////////
+
+hsMappedFileStream::hsMappedFileStream()
+    : hsReadOnlyStream(0, nullptr), fMapping(), fMappingSize()
+{ }
+
+bool hsMappedFileStream::Open(const plFileName& name)
+{
+    Close();
+
+#if HS_BUILD_FOR_WIN32
+    // Windows won't let anyone truncate the file while it's mapped, so
+    // there's nothing to watch out for once the view exists.
+    HANDLE file = CreateFileW(name.WideString().data(), GENERIC_READ, FILE_SHARE_READ,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart > UINT32_MAX) {
+        CloseHandle(file);
+        return false;
+    }
+    fMappingSize = (uint32_t)size.QuadPart;
+
+    // Windows refuses to map an empty file, but an empty stream is just fine
+    if (fMappingSize != 0) {
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+        if (mapping) {
+            fMapping = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+
+            // The view keeps the mapping (and file) alive on its own
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+#else
+    int fd = open(name.AsString().c_str(), O_RDONLY);
+    if (fd == -1)
+        return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size > UINT32_MAX) {
+        close(fd);
+        return false;
+    }
+    fMappingSize = (uint32_t)info.st_size;
+
+    // mmap refuses to map an empty file, but an empty stream is just fine
+    if (fMappingSize != 0) {
+        void* mapping = mmap(nullptr, fMappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED)
+            fMapping = mapping;
+    }
+
+    // The mapping keeps the file alive on its own
+    close(fd);
+#endif
+
+    if (fMappingSize != 0 && !fMapping) {
+        fMappingSize = 0;
+        return false;
+    }
+
+    fStart = fData = static_cast<const char*>(fMapping);
+    fStop = fStart + fMappingSize;
+    fPosition = 0;
+    return true;
+}
+
+uint32_t hsMappedFileStream::Read(uint32_t byteCount, void* buffer)
+{
+    // Come up short at the end, just like hsBufferedStream
+    byteCount = std::min(byteCount, GetSizeLeft());
+    if (byteCount == 0)
+        return 0;
+
+    memcpy(buffer, fData, byteCount);
+    fData += byteCount;
+    fPosition += byteCount;
+    return byteCount;
+}
+
+void hsMappedFileStream::Skip(uint32_t deltaByteCount)
+{
+    deltaByteCount = std::min(deltaByteCount, GetSizeLeft());
+    fData += deltaByteCount;
+    fPosition += deltaByteCount;
+}
+
+void hsMappedFileStream::Close()
+{
+    if (fMapping) {
+#if HS_BUILD_FOR_WIN32
+        UnmapViewOfFile(fMapping);
+#else
+        munmap(fMapping, fMappingSize);
+#endif
+    }
+
+    fMapping = nullptr;
+    fMappingSize = 0;
+    fStart = fData = fStop = nullptr;
+    fPosition = 0;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////
 
 bool hsWriteOnlyStream::AtEnd()
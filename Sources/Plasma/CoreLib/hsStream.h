@@ -281,6 +281,42 @@ public:
     void CopyToMem(void* mem);
 };
 
+// Read-only stream over a memory mapping of an entire file.  Reads come
+// straight out of the OS page cache (which is shared with any other process
+// that has the same file open) instead of going through a FILE* and a copy
+// into our own buffer.  Like hsBufferedStream, reads past the end come back
+// short instead of throwing.
+//
+// The file must not change while it's open.  Windows enforces that for us,
+// but elsewhere a file that gets truncated under the mapping raises SIGBUS on
+// the next read, and there's no way to check for that without racing the
+// writer.  So only map the client's own data files, which are replaced by
+// moving a new file over them (that leaves our mapping of the old one alone)
+// and aren't rewritten in place while the game is running.
+class hsMappedFileStream : public hsReadOnlyStream
+{
+    void*     fMapping;
+    uint32_t  fMappingSize;
+
+public:
+    hsMappedFileStream();
+    hsMappedFileStream(const hsMappedFileStream& other) = delete;
+    hsMappedFileStream(hsMappedFileStream&& other) = delete;
+    ~hsMappedFileStream() { Close(); }
+
+    const hsMappedFileStream& operator=(const hsMappedFileStream& other) = delete;
+    hsMappedFileStream& operator=(hsMappedFileStream&& other) = delete;
+
+    bool Open(const plFileName& name);
+    void Close();
+
+    uint32_t  Read(uint32_t byteCount, void* buffer) override;
+    void      Skip(uint32_t deltaByteCount) override;
+
+    // The start of the mapped file, for callers that want to read it directly
+    const void* GetData() const { return fStart; }
+};
+
 // write only mem stream
 class hsWriteOnlyStream : public hsStream {
 protected:
@@ -0,0 +1,166 @@
+/*==LICENSE==*
+
+CyanWorlds.com Engine - MMOG client, server and tools
+Copyright (C) 2011  Cyan Worlds, Inc.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Additional permissions under GNU GPL version 3 section 7
+
+If you modify this Program, or any covered work, by linking or
+combining it with any of RAD Game Tools Bink SDK, Autodesk 3ds Max SDK,
+NVIDIA PhysX SDK, Microsoft DirectX SDK, OpenSSL library, Independent
+JPEG Group JPEG library, Microsoft Windows Media SDK, or Apple QuickTime SDK
+(or a modified version of those libraries),
+containing parts covered by the terms of the Bink SDK EULA, 3ds Max EULA,
+PhysX SDK EULA, DirectX SDK EULA, OpenSSL and SSLeay licenses, IJG
+JPEG Library README, Windows Media SDK EULA, or QuickTime SDK EULA, the
+licensors of this Program grant you additional
+permission to convey the resulting work. Corresponding Source for a
+non-source form of such a combination shall include the source code for
+the parts of OpenSSL and IJG JPEG Library used as well as that of the covered
+work.
+
+You can contact Cyan Worlds, Inc. by email legal@cyan.com
+ or by snail mail at:
+      Cyan Worlds, Inc.
+      14617 N Newport Hwy
+      Mead, WA   99021
+
+*==LICENSE==*/
+#include "hsWorkerPool.h"
+
+#include "hsThread.h"
+
+#include <algorithm>
+
+hsWorkerPool::hsWorkerPool()
+    : fProc(), fCount(), fNext(), fBusyWorkers(), fBatch(), fShutdown()
+{
+}
+
+hsWorkerPool::~hsWorkerPool()
+{
+    IStopWorkers();
+}
+
+void hsWorkerPool::IStartWorkers(size_t numWorkers)
+{
+    // Workers have to know which batch was last before they start, or one that
+    // is slow off the mark could sleep through the first one it's counted in.
+    fShutdown = false;
+    uint32_t batch = fBatch;
+    fWorkers.reserve(numWorkers);
+    for (size_t i = 0; i < numWorkers; i++)
+        fWorkers.emplace_back(hsThread::StartSimpleThread([this, batch] { IWorkerThread(batch); }));
+}
+
+void hsWorkerPool::IStopWorkers()
+{
+    {
+        std::lock_guard<std::mutex> lock(fMutex);
+        fShutdown = true;
+    }
+    fWorkSignal.notify_all();
+    for (std::thread& worker : fWorkers)
+        worker.join();
+    fWorkers.clear();
+}
+
+void hsWorkerPool::IWorkerThread(uint32_t lastBatch)
+{
+    hsThread::SetThisThreadName(ST_LITERAL("hsWorkerPool"));
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(fMutex);
+            fWorkSignal.wait(lock, [this, lastBatch] { return fShutdown || fBatch != lastBatch; });
+            if (fShutdown)
+                return;
+            lastBatch = fBatch;
+        }
+
+        IEvalBatch();
+
+        bool last;
+        {
+            std::lock_guard<std::mutex> lock(fMutex);
+            last = --fBusyWorkers == 0;
+        }
+        if (last)
+            fDoneSignal.notify_one();
+    }
+}
+
+void hsWorkerPool::IEvalBatch()
+{
+    for (size_t i = fNext++; i < fCount; i = fNext++)
+        (*fProc)(i);
+}
+
+void hsWorkerPool::Run(size_t count, uint32_t numThreads, const WorkProc& proc)
+{
+    size_t numWorkers = numThreads > 1 ? numThreads - 1 : 0;
+    if (numWorkers != fWorkers.size())
+    {
+        IStopWorkers();
+        IStartWorkers(numWorkers);
+    }
+
+    if (fWorkers.empty())
+    {
+        for (size_t i = 0; i < count; i++)
+            proc(i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(fMutex);
+        fProc = &proc;
+        fCount = count;
+        fNext = 0;
+        fBusyWorkers = fWorkers.size();
+        ++fBatch;
+    }
+    fWorkSignal.notify_all();
+
+    IEvalBatch();
+
+    // Every worker checks in for every batch, even if there was nothing left
+    // for it by the time it woke up, so none of them can still be looking at
+    // this batch when the next one starts.
+    std::unique_lock<std::mutex> lock(fMutex);
+    fDoneSignal.wait(lock, [this] { return fBusyWorkers == 0; });
+    fProc = nullptr;
+}
+
+void hsWorkerPool::RunGroups(const std::vector<size_t>& groupSizes, size_t maxPerItem,
+                             uint32_t numThreads, const GroupProc& proc)
+{
+    fGroupItems.clear();
+    for (size_t group = 0; group < groupSizes.size(); group++)
+    {
+        size_t size = groupSizes[group];
+        size_t step = maxPerItem ? maxPerItem : size;
+        for (size_t begin = 0; begin < size; begin += step)
+            fGroupItems.push_back({ group, begin, std::min(begin + step, size) });
+    }
+
+    Run(fGroupItems.size(), numThreads, [this, &proc](size_t i) {
+        const GroupItem& item = fGroupItems[i];
+        for (size_t index = item.fBegin; index < item.fEnd; index++)
+            proc(item.fGroup, index);
+    });
+}
@@ -0,0 +1,114 @@
+/*==LICENSE==*
+
+CyanWorlds.com Engine - MMOG client, server and tools
+Copyright (C) 2011  Cyan Worlds, Inc.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Additional permissions under GNU GPL version 3 section 7
+
+If you modify this Program, or any covered work, by linking or
+combining it with any of RAD Game Tools Bink SDK, Autodesk 3ds Max SDK,
+NVIDIA PhysX SDK, Microsoft DirectX SDK, OpenSSL library, Independent
+JPEG Group JPEG library, Microsoft Windows Media SDK, or Apple QuickTime SDK
+(or a modified version of those libraries),
+containing parts covered by the terms of the Bink SDK EULA, 3ds Max EULA,
+PhysX SDK EULA, DirectX SDK EULA, OpenSSL and SSLeay licenses, IJG
+JPEG Library README, Windows Media SDK EULA, or QuickTime SDK EULA, the
+licensors of this Program grant you additional
+permission to convey the resulting work. Corresponding Source for a
+non-source form of such a combination shall include the source code for
+the parts of OpenSSL and IJG JPEG Library used as well as that of the covered
+work.
+
+You can contact Cyan Worlds, Inc. by email legal@cyan.com
+ or by snail mail at:
+      Cyan Worlds, Inc.
+      14617 N Newport Hwy
+      Mead, WA   99021
+
+*==LICENSE==*/
+
+#ifndef hsWorkerPool_Defined
+#define hsWorkerPool_Defined
+
+#include "HeadSpin.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/** A set of worker threads that stay around between frames, so handing a
+    batch of work to them costs a wakeup rather than creating and joining
+    threads. The calling thread takes its share of each batch and Run()
+    doesn't return until the whole batch is done. */
+class hsWorkerPool
+{
+public:
+    using WorkProc = std::function<void(size_t)>;
+    using GroupProc = std::function<void(size_t group, size_t index)>;
+
+    hsWorkerPool();
+    ~hsWorkerPool();
+
+    hsWorkerPool(const hsWorkerPool&) = delete;
+    hsWorkerPool& operator=(const hsWorkerPool&) = delete;
+
+    /** Call proc for every index in [0, count), spread over numThreads
+        threads, counting the caller. The workers are started (or restarted)
+        whenever numThreads changes. */
+    void Run(size_t count, uint32_t numThreads, const WorkProc& proc);
+
+    /** Like Run(), but the work comes in groups (say, the applicators of
+        one master mod), and each group is handed to a thread as a whole.
+        Only groups bigger than maxPerItem are split up between threads.
+        proc gets the group and the index within it. */
+    void RunGroups(const std::vector<size_t>& groupSizes, size_t maxPerItem,
+                   uint32_t numThreads, const GroupProc& proc);
+
+    size_t GetNumWorkers() const { return fWorkers.size(); }
+
+protected:
+    std::mutex                  fMutex;
+    std::condition_variable     fWorkSignal;
+    std::condition_variable     fDoneSignal;
+    std::vector<std::thread>    fWorkers;
+
+    // The batch being worked on
+    const WorkProc*             fProc;
+    size_t                      fCount;
+    std::atomic<size_t>         fNext;
+    size_t                      fBusyWorkers;
+    uint32_t                    fBatch;
+    bool                        fShutdown;
+
+    // What RunGroups() hands out; kept to save reallocating it every frame
+    struct GroupItem
+    {
+        size_t fGroup;
+        size_t fBegin;
+        size_t fEnd;
+    };
+    std::vector<GroupItem>      fGroupItems;
+
+    void IStartWorkers(size_t numWorkers);
+    void IStopWorkers();
+    void IWorkerThread(uint32_t lastBatch);
+    void IEvalBatch();
+};
+
+#endif // hsWorkerPool_Defined
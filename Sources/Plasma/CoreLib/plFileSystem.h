@@ -317,7 +317,9 @@ namespace plFileSystem
     /** Delete a file from the filesystem. */
     bool Unlink(const plFileName &filename);
 
-    /** Move or rename a file. */
+    /** Move or rename a file, replacing \a to if it already exists.
+     *  Within a single volume, the replacement is atomic.
+     */
     bool Move(const plFileName &from, const plFileName &to);
 
     /** Copy a file to a new location. */
@@ -64,6 +64,7 @@ protected:
     hsMatrix44          fRefParentLocalToWorld;
 
     void IRecalcTransforms() override;
+    bool IHasCustomRecalc() const override { return fFilterMask != 0; }
 public:
     plFilterCoordInterface();
     ~plFilterCoordInterface();
@@ -83,9 +83,11 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 #include "pnSceneObject/plAudioInterface.h"
 #include "pnSceneObject/plCoordinateInterface.h"
 #include "pnSceneObject/plDrawInterface.h"
+#include "pnSceneObject/plTransformHierarchy.h"
 
 #include "plAgeDescription/plAgeDescription.h"
 #include "plAgeLoader/plAgeLoader.h"
+#include "plAnimation/plAGMasterMod.h"
 #include "plAudio/plAudioSystem.h"
 #include "plAudio/plVoiceChat.h"
 #include "plAvatar/plArmatureMod.h"
@@ -5035,6 +5037,15 @@ PF_CONSOLE_CMD(Physics, ExtraProfile, "", "Toggle extra simulation profiling")
     PrintString(str);
 }
 
+PF_CONSOLE_CMD(Physics,
+               SetAsyncStep,
+               "bool enable",
+               "Let the simulation step run alongside the rest of the frame")
+{
+    plSimulationMgr::fAsyncStep = params[0];
+    PrintString(ST::format("Asynchronous simulation step {}", plSimulationMgr::fAsyncStep ? "ENABLED" : "DISABLED"));
+}
+
 PF_CONSOLE_CMD(Physics, 
                ShowControllerDebugDisplay,
                "", 
@@ -5728,6 +5739,28 @@ PF_CONSOLE_CMD( Animation,
     PrintString(ST::format("Potential delay of transform eval is now {}", (enabled ? "ENABLED" : "DISABLED")));
 }
 
+PF_CONSOLE_CMD( Animation,
+               SetEvalThreads,
+               "int threads",
+               "Set how many threads evaluate animations (1 = serial, 0 = one per core)." )
+{
+    int threads = params[0];
+    plAGMasterMod::SetEvalThreads(std::max(threads, 0));
+
+    PrintString(ST::format("Animation eval threads set to {}", plAGMasterMod::GetEvalThreads()));
+}
+
+PF_CONSOLE_CMD( Animation,
+               SetTransformThreads,
+               "int threads",
+               "Set how many threads compute queued transform hierarchies (1 = serial, 0 = one per core)." )
+{
+    int threads = params[0];
+    plTransformHierarchy::SetUpdateThreads(std::max(threads, 0));
+
+    PrintString(ST::format("Transform threads set to {}", plTransformHierarchy::GetUpdateThreads()));
+}
+
 #endif // LIMIT_CONSOLE_COMMANDS
 
 ////////////////////////////////////////////////////////////////////////
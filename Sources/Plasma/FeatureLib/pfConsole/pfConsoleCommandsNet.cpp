@@ -209,6 +209,16 @@ PF_CONSOLE_CMD( Net,        // groupName
     plNetClientMgr::GetInstance()->SetConsoleOutput( params[0] );
 }
 
+PF_CONSOLE_CMD( Net,        // groupName
+               BatchSDLStates,      // fxnName
+               "bool onoff", // paramList
+               "Send each frame's SDL states as one msg (the server must support it)" )    // helpString
+{
+    plNetClientMgr::GetInstance()->SetBatchSDLStates( params[0] );
+    PrintString(ST::format("SDL state batching {}",
+                           plNetClientMgr::GetInstance()->GetBatchSDLStates() ? "ENABLED" : "DISABLED"));
+}
+
 
 
 /////////////
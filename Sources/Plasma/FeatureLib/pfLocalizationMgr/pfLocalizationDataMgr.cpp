@@ -48,6 +48,8 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 
 #include "HeadSpin.h"
 
+#include "hsStream.h"
+
 #include "plFile/plEncryptedStream.h"
 #include "plResMgr/plLocalization.h"
 #include "plStatusLog/plStatusLog.h"
@@ -59,7 +61,11 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 #include <expat.h>
 
 #include <algorithm>
+#include <atomic>
+#include <cstring>
 #include <stack>
+#include <thread>
+#include <unordered_map>
 
 //////////////////////////////////////////////////////////////////////
 //
@@ -109,6 +115,10 @@ protected:
 
     ageMap fData;
 
+    // Parsing may happen off the main thread, so anything we'd like to log
+    // is held here and handed to the status log in file order afterwards.
+    std::vector<ST::string> fLogLines;
+
     void IHandleLocalizationsTag(const tagInfo & parentTag, const tagInfo & thisTag);
 
     void IHandleAgeTag(const tagInfo & parentTag, const tagInfo & thisTag);
@@ -125,13 +135,14 @@ public:
           fCurrentAge(std::move(move.fCurrentAge)), fCurrentSet(std::move(move.fCurrentSet)),
           fCurrentElement(std::move(move.fCurrentElement)),
           fCurrentTranslation(std::move(move.fCurrentTranslation)),
-          fData(std::move(move.fData))
+          fData(std::move(move.fData)), fLogLines(std::move(move.fLogLines))
     {
         move.fParser = nullptr;
     }
 
     bool Parse(const plFileName & fileName); // returns false on failure
     void AddError(const ST::string & errorText);
+    bool HasErrors() const { return !fLogLines.empty(); }
 };
 
 //////////////////////////////////////////////////////////////////////
@@ -368,7 +379,7 @@ bool LocalizationXMLFile::Parse(const plFileName& fileName)
     std::unique_ptr<hsStream> xmlStream = plEncryptedStream::OpenEncryptedFile(fileName);
     if (!xmlStream)
     {
-        pfLocalizationDataMgr::GetLog()->AddLineF("ERROR: Can't open file stream for {}", fileName);
+        fLogLines.emplace_back(ST::format("ERROR: Can't open file stream for {}", fileName));
         return false;
     }
 
@@ -382,8 +393,8 @@ bool LocalizationXMLFile::Parse(const plFileName& fileName)
 
         if (XML_Parse(fParser, Buff, (int)len, done) == XML_STATUS_ERROR)
         {
-            pfLocalizationDataMgr::GetLog()->AddLineF("ERROR: Parse error at line {}: {}",
-                XML_GetCurrentLineNumber(fParser), XML_ErrorString(XML_GetErrorCode(fParser)));
+            fLogLines.emplace_back(ST::format("ERROR: Parse error at line {}: {}",
+                XML_GetCurrentLineNumber(fParser), XML_ErrorString(XML_GetErrorCode(fParser))));
             done = true;
         }
 
@@ -400,8 +411,8 @@ bool LocalizationXMLFile::Parse(const plFileName& fileName)
 
 void LocalizationXMLFile::AddError(const ST::string& errorText)
 {
-    pfLocalizationDataMgr::GetLog()->AddLineF("ERROR (line {}): {}",
-        XML_GetCurrentLineNumber(fParser), errorText);
+    fLogLines.emplace_back(ST::format("ERROR (line {}): {}",
+        XML_GetCurrentLineNumber(fParser), errorText));
     fSkipDepth = fTagStack.size(); // skip this block
     fWeExploded = true;
     return;
@@ -424,20 +435,28 @@ protected:
 
     LocalizationXMLFile::ageMap fData;
 
-    void IMergeElementData(LocalizationXMLFile::element& firstElement, const LocalizationXMLFile::element& secondElement, const plFileName & fileName, const ST::string & path);
-    void IMergeSetData(LocalizationXMLFile::set& firstSet, const LocalizationXMLFile::set& secondSet, const plFileName & fileName, const ST::string & path);
-    void IMergeAgeData(LocalizationXMLFile::age& firstAge, const LocalizationXMLFile::age& secondAge, const plFileName & fileName, const ST::string & path);
-    void IMergeData(); // merge all localization data in the files
+    bool IMergeElementData(LocalizationXMLFile::element& firstElement, const LocalizationXMLFile::element& secondElement, const plFileName & fileName, const ST::string & path);
+    bool IMergeSetData(LocalizationXMLFile::set& firstSet, const LocalizationXMLFile::set& secondSet, const plFileName & fileName, const ST::string & path);
+    bool IMergeAgeData(LocalizationXMLFile::age& firstAge, const LocalizationXMLFile::age& secondAge, const plFileName & fileName, const ST::string & path);
+    bool IMergeData(); // merge all localization data in the files, returns false if there were conflicts
+
+    bool IVerifyElement(const ST::string &ageName, const ST::string &setName, LocalizationXMLFile::set::iterator& curElement);
+    bool IVerifySet(const ST::string &ageName, const ST::string &setName);
+    bool IVerifyAge(const ST::string &ageName);
+    bool IVerifyData(); // verify the localization data once it has been merged in, returns false if anything was discarded
+
+    bool IParseFiles(const std::vector<plFileName>& locFiles); // returns false if any file had errors
 
-    void IVerifyElement(const ST::string &ageName, const ST::string &setName, LocalizationXMLFile::set::iterator& curElement);
-    void IVerifySet(const ST::string &ageName, const ST::string &setName);
-    void IVerifyAge(const ST::string &ageName);
-    void IVerifyData(); // verify the localization data once it has been merged in
+    void IWriteSources(hsStream* stream, const std::vector<plFileName>& locFiles) const;
+    bool ILoadCache(const plFileName& cacheFile, const std::vector<plFileName>& locFiles);
+    bool IWriteCache(const plFileName& cacheFile, const std::vector<plFileName>& locFiles) const;
 
 public:
     LocalizationDatabase() {}
 
-    void Parse(const plFileName & directory);
+    // If cacheFile is valid, the merged data is loaded from it when none of the
+    // .loc files have changed, and written to it after a clean parse otherwise.
+    void Parse(const plFileName & directory, const plFileName & cacheFile = {});
     const LocalizationXMLFile::ageMap& GetData() const { return fData; }
 };
 
@@ -447,8 +466,10 @@ public:
 
 //// IMergeElementData ///////////////////////////////////////////////
 
-void LocalizationDatabase::IMergeElementData(LocalizationXMLFile::element& firstElement, const LocalizationXMLFile::element& secondElement, const plFileName& fileName, const ST::string& path)
+bool LocalizationDatabase::IMergeElementData(LocalizationXMLFile::element& firstElement, const LocalizationXMLFile::element& secondElement, const plFileName& fileName, const ST::string& path)
 {
+    bool clean = true;
+
     // copy the data over, alerting the user to any duplicate translations
     for (const auto& curTranslation : secondElement)
     {
@@ -456,16 +477,21 @@ void LocalizationDatabase::IMergeElementData(LocalizationXMLFile::element& first
         {
             pfLocalizationDataMgr::GetLog()->AddLineF("Duplicate {} translation for {} found in file {}. Ignoring second translation.",
                 curTranslation.first, path, fileName);
+            clean = false;
         }
         else
             firstElement[curTranslation.first] = curTranslation.second;
     }
+
+    return clean;
 }
 
 //// IMergeSetData ///////////////////////////////////////////////////
 
-void LocalizationDatabase::IMergeSetData(LocalizationXMLFile::set& firstSet, const LocalizationXMLFile::set& secondSet, const plFileName& fileName, const ST::string& path)
+bool LocalizationDatabase::IMergeSetData(LocalizationXMLFile::set& firstSet, const LocalizationXMLFile::set& secondSet, const plFileName& fileName, const ST::string& path)
 {
+    bool clean = true;
+
     // Merge all the elements
     for (const auto& curElement : secondSet)
     {
@@ -473,15 +499,19 @@ void LocalizationDatabase::IMergeSetData(LocalizationXMLFile::set& firstSet, con
         if (firstSet.find(curElement.first) == firstSet.end())
             firstSet[curElement.first] = curElement.second;
         else // merge the element in
-            IMergeElementData(firstSet[curElement.first], curElement.second, fileName,
+            clean &= IMergeElementData(firstSet[curElement.first], curElement.second, fileName,
                 ST::format("{}.{}", path, curElement.first));
     }
+
+    return clean;
 }
 
 //// IMergeAgeData ///////////////////////////////////////////////////
 
-void LocalizationDatabase::IMergeAgeData(LocalizationXMLFile::age& firstAge, const LocalizationXMLFile::age& secondAge, const plFileName& fileName, const ST::string& path)
+bool LocalizationDatabase::IMergeAgeData(LocalizationXMLFile::age& firstAge, const LocalizationXMLFile::age& secondAge, const plFileName& fileName, const ST::string& path)
 {
+    bool clean = true;
+
     // Merge all the sets
     for (const auto& curSet : secondAge)
     {
@@ -489,15 +519,18 @@ void LocalizationDatabase::IMergeAgeData(LocalizationXMLFile::age& firstAge, con
         if (firstAge.find(curSet.first) == firstAge.end())
             firstAge[curSet.first] = curSet.second;
         else // merge the data in
-            IMergeSetData(firstAge[curSet.first], curSet.second, fileName,
+            clean &= IMergeSetData(firstAge[curSet.first], curSet.second, fileName,
                 ST::format("{}.{}", path, curSet.first));
     }
+
+    return clean;
 }
 
 //// IMergeData() ////////////////////////////////////////////////////
 
-void LocalizationDatabase::IMergeData()
+bool LocalizationDatabase::IMergeData()
 {
+    bool clean = true;
     for (const auto& file : fFiles)
     {
         for (const auto& curAge : file.fData)
@@ -506,15 +539,17 @@ void LocalizationDatabase::IMergeData()
             if (fData.find(curAge.first) == fData.end())
                 fData[curAge.first] = curAge.second;
             else // otherwise, merge the data in
-                IMergeAgeData(fData[curAge.first], curAge.second, file.fFilename, curAge.first);
+                clean &= IMergeAgeData(fData[curAge.first], curAge.second, file.fFilename, curAge.first);
         }
     }
+    return clean;
 }
 
 //// IVerifyElement() ////////////////////////////////////////////////
 
-void LocalizationDatabase::IVerifyElement(const ST::string &ageName, const ST::string &setName, LocalizationXMLFile::set::iterator& curElement)
+bool LocalizationDatabase::IVerifyElement(const ST::string &ageName, const ST::string &setName, LocalizationXMLFile::set::iterator& curElement)
 {
+    bool clean = true;
     auto languageNames = plLocalization::GetAllLanguageNames();
 
     ST::string elementName = curElement->first;
@@ -531,6 +566,7 @@ void LocalizationDatabase::IVerifyElement(const ST::string &ageName, const ST::s
             pfLocalizationDataMgr::GetLog()->AddLineF("ERROR: The language {} used by {}.{}.{} is not supported. Discarding translation.",
                 curTranslation->first, ageName, setName, elementName);
             curTranslation = theElement.erase(curTranslation);
+            clean = false;
         }
         else
             curTranslation++;
@@ -543,12 +579,15 @@ void LocalizationDatabase::IVerifyElement(const ST::string &ageName, const ST::s
                 langName, ageName, setName, elementName);
         }
     }
+
+    return clean;
 }
 
 //// IVerifySet() ////////////////////////////////////////////////////
 
-void LocalizationDatabase::IVerifySet(const ST::string &ageName, const ST::string &setName)
+bool LocalizationDatabase::IVerifySet(const ST::string &ageName, const ST::string &setName)
 {
+    bool clean = true;
     LocalizationXMLFile::set& theSet = fData[ageName][setName];
     LocalizationXMLFile::set::iterator curElement = theSet.begin();
 
@@ -562,56 +601,312 @@ void LocalizationDatabase::IVerifySet(const ST::string &ageName, const ST::strin
             pfLocalizationDataMgr::GetLog()->AddLineF("ERROR: Default language {} is missing from the translations in element {}.{}.{}. Deleting element.",
                 defaultLanguage, ageName, setName, curElement->first);
             curElement = theSet.erase(curElement);
+            clean = false;
         }
         else
         {
-            IVerifyElement(ageName, setName, curElement);
+            clean &= IVerifyElement(ageName, setName, curElement);
             curElement++;
         }
     }
+
+    return clean;
 }
 
 //// IVerifyAge() ////////////////////////////////////////////////////
 
-void LocalizationDatabase::IVerifyAge(const ST::string &ageName)
+bool LocalizationDatabase::IVerifyAge(const ST::string &ageName)
 {
+    bool clean = true;
     for (const auto& curSet : fData[ageName])
-        IVerifySet(ageName, curSet.first);
+        clean &= IVerifySet(ageName, curSet.first);
+    return clean;
 }
 
 //// IVerifyData() ///////////////////////////////////////////////////
 
-void LocalizationDatabase::IVerifyData()
+bool LocalizationDatabase::IVerifyData()
 {
+    bool clean = true;
     for (const auto& curAge : fData)
-        IVerifyAge(curAge.first);
+        clean &= IVerifyAge(curAge.first);
+    return clean;
+}
+
+//// IParseFiles() //////////////////////////////////////////////////
+
+static constexpr size_t kMinLocFilesPerThread = 4;
+
+bool LocalizationDatabase::IParseFiles(const std::vector<plFileName>& locFiles)
+{
+    fFiles.clear();
+    fFiles.resize(locFiles.size());
+    std::vector<uint8_t> results(locFiles.size());
+
+    // Every file gets its own expat parser and data tree, so the files
+    // themselves can be parsed on as many threads as we like. Merging has
+    // to happen in directory order, though, so that's left for afterwards.
+    uint32_t parseThreads = pfLocalizationDataMgr::GetParseThreads();
+    size_t numThreads = parseThreads ? parseThreads : std::thread::hardware_concurrency();
+    numThreads = std::min(numThreads, locFiles.size() / kMinLocFilesPerThread);
+    if (numThreads > 1)
+    {
+        std::atomic<size_t> nextFile = 0;
+        auto parseRange = [&]() {
+            for (size_t i = nextFile++; i < locFiles.size(); i = nextFile++)
+                results[i] = fFiles[i].Parse(locFiles[i]);
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(numThreads - 1);
+        for (size_t i = 1; i < numThreads; i++)
+            threads.emplace_back(parseRange);
+        parseRange();
+
+        for (std::thread& thread : threads)
+            thread.join();
+    }
+    else
+    {
+        for (size_t i = 0; i < locFiles.size(); i++)
+            results[i] = fFiles[i].Parse(locFiles[i]);
+    }
+
+    bool clean = true;
+    for (size_t i = 0; i < locFiles.size(); i++)
+    {
+        for (const ST::string& line : fFiles[i].fLogLines)
+            pfLocalizationDataMgr::GetLog()->AddLine(line);
+
+        if (!results[i])
+            pfLocalizationDataMgr::GetLog()->AddLineF("WARNING: Errors in file {}", locFiles[i].GetFileName());
+        clean &= results[i] && !fFiles[i].HasErrors();
+
+        pfLocalizationDataMgr::GetLog()->AddLineF("File {} parsed and added to database", locFiles[i].GetFileName());
+    }
+
+    return clean;
 }
 
 //// Parse() /////////////////////////////////////////////////////////
 
-void LocalizationDatabase::Parse(const plFileName & directory)
+void LocalizationDatabase::Parse(const plFileName & directory, const plFileName & cacheFile)
 {
     fDirectory = directory;
     fFiles.clear();
 
     std::vector<plFileName> locFiles = plFileSystem::ListDir(directory, "*.loc");
-    for (const auto& file : locFiles)
-    {
-        LocalizationXMLFile newFile;
-        bool retVal = newFile.Parse(file);
-        if (!retVal)
-            pfLocalizationDataMgr::GetLog()->AddLineF("WARNING: Errors in file {}", file.GetFileName());
 
-        fFiles.emplace_back(std::move(newFile));
-        pfLocalizationDataMgr::GetLog()->AddLineF("File {} parsed and added to database", file.GetFileName());
+    if (cacheFile.IsValid() && ILoadCache(cacheFile, locFiles))
+    {
+        pfLocalizationDataMgr::GetLog()->AddLineF("Loaded {} localization files from cache {}",
+            locFiles.size(), cacheFile);
+        return;
     }
 
-    IMergeData();
-    IVerifyData();
+    bool clean = IParseFiles(locFiles);
+    clean &= IMergeData();
+    clean &= IVerifyData();
+
+    // The per-file trees aren't needed once they've been merged
+    fFiles.clear();
+
+    // Only snapshot data we'd be happy to see again; if anything went wrong,
+    // we want the errors in the log next time, too.
+    if (cacheFile.IsValid() && clean)
+    {
+        if (!IWriteCache(cacheFile, locFiles))
+            pfLocalizationDataMgr::GetLog()->AddLineF("WARNING: Couldn't write localization cache {}", cacheFile);
+    }
 
     return;
 }
 
+//////////////////////////////////////////////////////////////////////
+//// Localization cache //////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////
+//  A binary snapshot of the merged and verified database:
+//
+//    uint32  magic, version
+//    string  source directory
+//    uint32  file count, then per .loc file: name, size (64), mtime (64)
+//    uint32  string count, then each distinct string once
+//    uint32  key count, then per translation the indices of its age,
+//            set, element, language and text strings
+//
+//  Strings are a 32-bit byte length followed by UTF-8. The key table is
+//  written in std::map order, so loading only ever appends to the maps.
+
+static constexpr uint32_t kLocCacheMagic = 0x434F4C50; // 'PLOC'
+static constexpr uint32_t kLocCacheVersion = 1;
+
+static void WriteCacheString(hsStream* stream, const ST::string& str)
+{
+    stream->WriteLE32((uint32_t)str.size());
+    stream->Write((uint32_t)str.size(), str.c_str());
+}
+
+static void WriteCache64(hsStream* stream, uint64_t value)
+{
+    stream->WriteLE32((uint32_t)(value & 0xFFFFFFFF));
+    stream->WriteLE32((uint32_t)(value >> 32));
+}
+
+//// IWriteSources() /////////////////////////////////////////////////
+
+void LocalizationDatabase::IWriteSources(hsStream* stream, const std::vector<plFileName>& locFiles) const
+{
+    WriteCacheString(stream, fDirectory.AsString());
+    stream->WriteLE32((uint32_t)locFiles.size());
+    for (const plFileName& file : locFiles)
+    {
+        plFileInfo info(file);
+        WriteCacheString(stream, file.GetFileName());
+        WriteCache64(stream, (uint64_t)info.FileSize());
+        WriteCache64(stream, info.ModifyTime());
+    }
+}
+
+//// ILoadCache() ////////////////////////////////////////////////////
+
+bool LocalizationDatabase::ILoadCache(const plFileName& cacheFile, const std::vector<plFileName>& locFiles)
+{
+    // IWriteCache() only ever moves a new cache over this one, so it's safe to map
+    hsMappedFileStream stream;
+    if (!stream.Open(cacheFile))
+        return false;
+
+    if (stream.GetEOF() < 2 * sizeof(uint32_t) || stream.ReadLE32() != kLocCacheMagic
+            || stream.ReadLE32() != kLocCacheVersion)
+        return false;
+
+    // The source table must match what's on disk byte for byte
+    hsRAMStream sources;
+    IWriteSources(&sources, locFiles);
+    if (stream.GetSizeLeft() < sources.GetEOF()
+            || memcmp((const char*)stream.GetData() + stream.GetPosition(), sources.GetData(), sources.GetEOF()) != 0)
+        return false;
+    stream.Skip(sources.GetEOF());
+
+    const char* base = (const char*)stream.GetData();
+
+    if (stream.GetSizeLeft() < sizeof(uint32_t))
+        return false;
+    uint32_t numStrings = stream.ReadLE32();
+    std::vector<ST::string> strings;
+    strings.reserve(numStrings);
+    for (uint32_t i = 0; i < numStrings; i++)
+    {
+        if (stream.GetSizeLeft() < sizeof(uint32_t))
+            return false;
+        uint32_t len = stream.ReadLE32();
+        if (stream.GetSizeLeft() < len)
+            return false;
+        strings.emplace_back(ST::string::from_utf8(base + stream.GetPosition(), len, ST::assume_valid));
+        stream.Skip(len);
+    }
+
+    if (stream.GetSizeLeft() < sizeof(uint32_t))
+        return false;
+    uint32_t numKeys = stream.ReadLE32();
+    if (stream.GetSizeLeft() != uint64_t(numKeys) * 5 * sizeof(uint32_t))
+        return false;
+
+    LocalizationXMLFile::ageMap data;
+    LocalizationXMLFile::ageMap::iterator curAge = data.end();
+    LocalizationXMLFile::age::iterator curSet;
+    LocalizationXMLFile::set::iterator curElement;
+    uint32_t lastAge = UINT32_MAX, lastSet = UINT32_MAX, lastElement = UINT32_MAX;
+    for (uint32_t i = 0; i < numKeys; i++)
+    {
+        uint32_t key[5];
+        stream.ReadLE32(std::size(key), key);
+        if (std::any_of(std::begin(key), std::end(key), [numStrings](uint32_t idx) { return idx >= numStrings; }))
+            return false;
+
+        // Keys are sorted, so a new age/set/element always goes on the end
+        if (key[0] != lastAge)
+        {
+            curAge = data.emplace_hint(data.end(), strings[key[0]], LocalizationXMLFile::age());
+            lastAge = key[0];
+            lastSet = UINT32_MAX;
+        }
+        if (key[1] != lastSet)
+        {
+            curSet = curAge->second.emplace_hint(curAge->second.end(), strings[key[1]], LocalizationXMLFile::set());
+            lastSet = key[1];
+            lastElement = UINT32_MAX;
+        }
+        if (key[2] != lastElement)
+        {
+            curElement = curSet->second.emplace_hint(curSet->second.end(), strings[key[2]], LocalizationXMLFile::element());
+            lastElement = key[2];
+        }
+        curElement->second.emplace_hint(curElement->second.end(), strings[key[3]], strings[key[4]]);
+    }
+
+    fData = std::move(data);
+    return true;
+}
+
+//// IWriteCache() ///////////////////////////////////////////////////
+
+bool LocalizationDatabase::IWriteCache(const plFileName& cacheFile, const std::vector<plFileName>& locFiles) const
+{
+    std::vector<const ST::string*> strings;
+    std::unordered_map<ST::string, uint32_t, ST::hash> stringIndices;
+    auto intern = [&](const ST::string& str) {
+        auto result = stringIndices.try_emplace(str, (uint32_t)strings.size());
+        if (result.second)
+            strings.push_back(&result.first->first);
+        return result.first->second;
+    };
+
+    std::vector<uint32_t> keys;
+    for (const auto& curAge : fData)
+    {
+        uint32_t ageIdx = intern(curAge.first);
+        for (const auto& curSet : curAge.second)
+        {
+            uint32_t setIdx = intern(curSet.first);
+            for (const auto& curElement : curSet.second)
+            {
+                uint32_t elementIdx = intern(curElement.first);
+                for (const auto& curTranslation : curElement.second)
+                {
+                    keys.push_back(ageIdx);
+                    keys.push_back(setIdx);
+                    keys.push_back(elementIdx);
+                    keys.push_back(intern(curTranslation.first));
+                    keys.push_back(intern(curTranslation.second));
+                }
+            }
+        }
+    }
+
+    // Write next to the real thing and swap it in, so a crash partway
+    // through can't leave a truncated cache behind
+    plFileName tempFile = ST::format("{}.tmp", cacheFile);
+    {
+        hsUNIXStream stream;
+        if (!stream.Open(tempFile, "wb"))
+            return false;
+
+        stream.WriteLE32(kLocCacheMagic);
+        stream.WriteLE32(kLocCacheVersion);
+        IWriteSources(&stream, locFiles);
+
+        stream.WriteLE32((uint32_t)strings.size());
+        for (const ST::string* str : strings)
+            WriteCacheString(&stream, *str);
+
+        stream.WriteLE32((uint32_t)(keys.size() / 5));
+        stream.WriteLE32(keys.size(), keys.data());
+    }
+
+    return plFileSystem::Move(tempFile, cacheFile);
+}
+
 //////////////////////////////////////////////////////////////////////
 //// pf3PartMap Functions ////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////
@@ -781,15 +1076,17 @@ std::vector<ST::string> pfLocalizationDataMgr::pf3PartMap<mapT>::getNameList(con
 
 pfLocalizationDataMgr   *pfLocalizationDataMgr::fInstance = nullptr;
 plStatusLog             *pfLocalizationDataMgr::fLog = nullptr; // output logfile
+uint32_t                 pfLocalizationDataMgr::fParseThreads = 0;
 
 //// Constructor/Destructor //////////////////////////////////////////
 
-pfLocalizationDataMgr::pfLocalizationDataMgr(const plFileName & path)
+pfLocalizationDataMgr::pfLocalizationDataMgr(const plFileName & path, const plFileName & cacheFile)
 {
     hsAssert(!fInstance, "Tried to create the localization data manager more than once!");
     fInstance = this;
 
     fDataPath = path;
+    fCacheFile = cacheFile;
 
     fDatabase = nullptr;
 }
@@ -910,12 +1207,12 @@ void pfLocalizationDataMgr::IWriteText(const plFileName & filename, const ST::st
 
 //// Initialize //////////////////////////////////////////////////////
 
-void pfLocalizationDataMgr::Initialize(const plFileName & path)
+void pfLocalizationDataMgr::Initialize(const plFileName & path, const plFileName & cacheFile)
 {
     if (fInstance)
         return;
 
-    fInstance = new pfLocalizationDataMgr(path);
+    fInstance = new pfLocalizationDataMgr(path, cacheFile);
     fLog = plStatusLogMgr::GetInstance().CreateStatusLog(30, "LocalizationDataMgr.log",
         plStatusLog::kFilledBackground | plStatusLog::kAlignToTop | plStatusLog::kTimestamp);
     fInstance->SetupData();
@@ -946,7 +1243,7 @@ void pfLocalizationDataMgr::SetupData()
         delete fDatabase;
 
     fDatabase = new LocalizationDatabase();
-    fDatabase->Parse(fDataPath);
+    fDatabase->Parse(fDataPath, fCacheFile);
 
     fLog->AddLine("File reading complete, converting to native data format");
 
@@ -71,6 +71,7 @@ class pfLocalizationDataMgr
 private:
     static pfLocalizationDataMgr*   fInstance;
     static plStatusLog*             fLog;
+    static uint32_t                 fParseThreads;
 
     // These need to match the typedefs in LocalizedXMLFile
     using element = std::map<ST::string, ST::string>;
@@ -113,6 +114,7 @@ protected:
     pf3PartMap<localizedElement> fLocalizedElements;
 
     plFileName fDataPath;
+    plFileName fCacheFile;
 
     ST::string IGetCurrentLanguageName() const; // get the name of the current language
 
@@ -122,16 +124,22 @@ protected:
 
     void IWriteText(const plFileName & filename, const ST::string & ageName, const ST::string & languageName) const; // Write localization text to the specified file
 
-    pfLocalizationDataMgr(const plFileName & path);
+    pfLocalizationDataMgr(const plFileName & path, const plFileName & cacheFile);
 public:
     virtual ~pfLocalizationDataMgr();
 
-    static void Initialize(const plFileName & path);
+    // If cacheFile is valid, a binary snapshot of the parsed database is kept
+    // there and used in place of the .loc files until one of them changes.
+    static void Initialize(const plFileName & path, const plFileName & cacheFile = {});
     static void Shutdown();
     static pfLocalizationDataMgr &Instance() {return *fInstance;}
     static bool InstanceValid() { return fInstance != nullptr; }
     static plStatusLog* GetLog() { return fLog; }
 
+    // Number of threads to parse .loc files on: 0 for one per core, 1 to parse serially
+    static void SetParseThreads(uint32_t threads) { fParseThreads = threads; }
+    static uint32_t GetParseThreads() { return fParseThreads; }
+
     void SetupData();
 
     pfLocalizedString GetElement(const ST::string & name) const;
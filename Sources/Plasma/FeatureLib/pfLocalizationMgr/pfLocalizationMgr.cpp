@@ -73,13 +73,13 @@ pfLocalizationMgr::~pfLocalizationMgr()
 
 //// Initialize //////////////////////////////////////////////////////
 
-void pfLocalizationMgr::Initialize(const plFileName & dataPath)
+void pfLocalizationMgr::Initialize(const plFileName & dataPath, const plFileName & cacheFile)
 {
     if (fInstance)
         return;
 
     fInstance = new pfLocalizationMgr();
-    pfLocalizationDataMgr::Initialize(dataPath); // set up the data manager
+    pfLocalizationDataMgr::Initialize(dataPath, cacheFile); // set up the data manager
 }
 
 //// Shutdown ////////////////////////////////////////////////////////
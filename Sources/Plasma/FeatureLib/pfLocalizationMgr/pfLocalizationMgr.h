@@ -50,8 +50,7 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 #define _pfLocalizationMgr_h
 
 #include "HeadSpin.h"
-
-class plFileName;
+#include "plFileSystem.h"
 
 class pfLocalizationMgr
 {
@@ -62,7 +61,7 @@ protected:
 public:
     virtual ~pfLocalizationMgr();
 
-    static void Initialize(const plFileName & dataPath);
+    static void Initialize(const plFileName & dataPath, const plFileName & cacheFile = {});
     static void Shutdown();
     static pfLocalizationMgr &Instance() {return *fInstance;}
     static bool InstanceValid() { return fInstance != nullptr; }
@@ -41,8 +41,13 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 *==LICENSE==*/
 
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <ctime>
 #include <deque>
+#include <map>
 #include <mutex>
+#include <thread>
 
 #include "pfPatcher.h"
 
@@ -138,12 +143,163 @@ struct pfPatcherQueuedFile
     { }
 
     pfPatcherQueuedFile(const pfPatcherQueuedFile& copy) = delete;
+    pfPatcherQueuedFile(pfPatcherQueuedFile&& move) = default;
 
     pfPatcherQueuedFile& operator =(const pfPatcherQueuedFile& copy) = delete;
+    pfPatcherQueuedFile& operator =(pfPatcherQueuedFile&& move) = default;
 };
 
 // ===================================================
 
+/** Persistent record of the MD5 of local files, keyed by their size and modification
+ *  time, so that files which haven't changed since the last patch needn't be rehashed.
+ *  This is shared by all of the patcher threads.
+ *
+ *  Modification times only have a resolution of one second, so a hash taken in the
+ *  same second the file was written is never trusted: the file could have been
+ *  rewritten later in that second without its size or time changing.
+ *  Names are matched case-sensitively. On a case-insensitive filesystem, that
+ *  costs a rehash rather than handing one file's hash to another.
+ */
+class pfPatcherHashCache
+{
+    static constexpr uint32_t kFileVersion = 2;
+    static constexpr char kFileMagic[] = "PLHC";
+
+    struct Entry
+    {
+        uint32_t fFileSize;
+        uint64_t fModifyTime;
+        uint64_t fHashTime;
+        uint8_t fChecksum[MD5_DIGEST_LENGTH];
+    };
+
+    std::map<ST::string, Entry> fEntries;
+    std::mutex fMutex;
+    plFileName fPath;
+    bool fDirty;
+
+public:
+    pfPatcherHashCache() : fDirty() { }
+
+    const plFileName& GetPath() const { return fPath; }
+    void SetPath(plFileName path) { fPath = std::move(path); }
+
+    void Load()
+    {
+        hsLockGuard(fMutex);
+        fEntries.clear();
+        fDirty = false;
+        if (!fPath.IsValid() || !plFileInfo(fPath).Exists())
+            return;
+
+        hsUNIXStream s;
+        if (!s.Open(fPath, "rb"))
+            return;
+
+        char magic[sizeof(kFileMagic) - 1];
+        if (s.Read(sizeof(magic), magic) != sizeof(magic) || memcmp(magic, kFileMagic, sizeof(magic)) != 0 ||
+            s.ReadLE32() != kFileVersion) {
+            PatcherLogYellow("\tIgnoring unrecognized hash cache '{}'", fPath);
+            return;
+        }
+
+        uint32_t count = s.ReadLE32();
+        for (uint32_t i = 0; i < count && !s.AtEnd(); ++i) {
+            ST::string name = s.ReadSafeString();
+            Entry entry;
+            entry.fFileSize = s.ReadLE32();
+            entry.fModifyTime = s.ReadLE32();
+            entry.fModifyTime |= uint64_t(s.ReadLE32()) << 32;
+            entry.fHashTime = s.ReadLE32();
+            entry.fHashTime |= uint64_t(s.ReadLE32()) << 32;
+            if (s.Read(sizeof(entry.fChecksum), entry.fChecksum) != sizeof(entry.fChecksum))
+                break;
+            fEntries[name] = entry;
+        }
+        PatcherLogWhite("\tLoaded {} cached file hashes", fEntries.size());
+    }
+
+    void Save()
+    {
+        hsLockGuard(fMutex);
+        if (!fDirty || !fPath.IsValid())
+            return;
+
+        // Write it out to the side so a crash (or another patcher) can't leave a half-written cache
+        plFileName tempPath = ST::format("{}.tmp", fPath);
+        {
+            hsUNIXStream s;
+            if (!s.Open(tempPath, "wb")) {
+                PatcherLogRed("\tFailed to write hash cache '{}'", tempPath);
+                return;
+            }
+
+            s.Write(sizeof(kFileMagic) - 1, kFileMagic);
+            s.WriteLE32(kFileVersion);
+            s.WriteLE32((uint32_t)fEntries.size());
+            for (const auto& [name, entry] : fEntries) {
+                s.WriteSafeString(name);
+                s.WriteLE32(entry.fFileSize);
+                s.WriteLE32((uint32_t)entry.fModifyTime);
+                s.WriteLE32((uint32_t)(entry.fModifyTime >> 32));
+                s.WriteLE32((uint32_t)entry.fHashTime);
+                s.WriteLE32((uint32_t)(entry.fHashTime >> 32));
+                s.Write(sizeof(entry.fChecksum), entry.fChecksum);
+            }
+        }
+
+        // Replaces the old cache in one step, so there's always a complete one on disk
+        if (plFileSystem::Move(tempPath, fPath))
+            fDirty = false;
+    }
+
+    /** Retrieves the cached hash of a file if it hasn't changed since it was last hashed. */
+    bool Find(const plFileName& file, const plFileInfo& info, plMD5Checksum& checksum)
+    {
+        hsLockGuard(fMutex);
+        auto it = fEntries.find(file.AsString());
+        if (it == fEntries.end())
+            return false;
+        if (it->second.fFileSize != info.FileSize() || it->second.fModifyTime != info.ModifyTime())
+            return false;
+        if (it->second.fModifyTime >= it->second.fHashTime)
+            return false;
+
+        checksum.SetValue(it->second.fChecksum);
+        return true;
+    }
+
+    void Update(const plFileName& file, const plFileInfo& info, const plMD5Checksum& checksum)
+    {
+        if (!checksum.IsValid())
+            return;
+
+        Entry entry;
+        entry.fFileSize = (uint32_t)info.FileSize();
+        entry.fModifyTime = info.ModifyTime();
+        entry.fHashTime = (uint64_t)time(nullptr);
+        memcpy(entry.fChecksum, checksum.GetValue(), sizeof(entry.fChecksum));
+
+        hsLockGuard(fMutex);
+        fEntries[file.AsString()] = entry;
+        fDirty = true;
+    }
+};
+
+// ===================================================
+
+/** Default location of the local file hash cache */
+static const plFileName kDefaultHashCache = "patcher.cache";
+
+/** Default number of requests allowed in flight to the server at once */
+static constexpr uint32_t kDefaultMaxRequests = 8;
+
+/** Upper bound on the default number of file hashing/processing threads */
+static constexpr uint32_t kDefaultMaxFileThreads = 4;
+
+// ===================================================
+
 /** State for a patcher worker thread started by pfPatcher::Start */
 struct pfPatcherWorker final
 {
@@ -166,7 +322,10 @@ struct pfPatcherWorker final
 
     std::recursive_mutex fRequestMut;
     std::mutex fFileMut;
-    hsSemaphore fFileSignal;
+    std::mutex fCallbackMut;
+    std::condition_variable fFileSignal;
+
+    pfPatcherHashCache fHashCache;
 
     pfPatcher::CompletionFunc fOnComplete;
     pfPatcher::FindBundleExeFunc fFindBundleExe;
@@ -178,13 +337,18 @@ struct pfPatcherWorker final
     pfPatcher::FileDownloadFunc fRedistUpdateDownloaded;
     pfPatcher::FileDownloadFunc fSelfPatch;
 
-    volatile bool fStarted;
-    volatile bool fRequestActive;
+    std::atomic<bool> fStarted;
     volatile bool fWantPython;
     volatile bool fWantSDL;
 
-    uint64_t fCurrBytes;
-    uint64_t fTotalBytes;
+    uint32_t fMaxRequests;      // max net requests in flight at once
+    uint32_t fActiveRequests;   // guarded by fRequestMut
+    uint32_t fNumFileThreads;   // threads hashing and post-processing files
+    uint32_t fActiveFiles;      // guarded by fFileMut
+
+    std::atomic<uint64_t> fCurrBytes;
+    std::atomic<uint64_t> fTotalBytes;
+    std::atomic<float> fDLStartTime;
 
     pfPatcherWorker();
     ~pfPatcherWorker();
@@ -197,11 +361,15 @@ struct pfPatcherWorker final
     void IFileThingDownloadCB(ENetError result, const plFileName& filename, pfPatcherStream* stream);
 
     void EndPatch(ENetError result, const ST::string& msg={});
+    void IRequestFinished();
     bool IssueRequest();
+    void IIssueRequest(const Request& req);
     void Run();
     void IHashFile(pfPatcherQueuedFile& file);
     void IDecompressSound(const pfPatcherQueuedFile& sound) const;
-    void ProcessFile();
+    void ProcessFile(pfPatcherQueuedFile& file);
+    void ProcessFiles();
+    bool IsFinished();
     void WhitelistFile(const plFileName& file, bool justDownloaded, hsStream* s=nullptr);
     void EnqueuePreloaderLists();
 };
@@ -214,36 +382,34 @@ class pfPatcherStream : public plZlibStream
     plFileName fFilename;
     uint32_t fFlags;
 
-    uint64_t fBytesWritten;
-    float fDLStartTime;
-
-    ST::string IMakeStatusMsg() const
+    ST::string IMakeStatusMsg(uint64_t currBytes) const
     {
-        float secs = hsTimer::GetSeconds<float>() - fDLStartTime;
-        auto bytesPerSec = uint64_t(fBytesWritten / secs);
+        // Several files may be downloading at once, so report the speed of the
+        // whole patch rather than that of this file.
+        float secs = hsTimer::GetSeconds<float>() - fParent->fDLStartTime;
+        auto bytesPerSec = secs > 0.f ? uint64_t(currBytes / secs) : 0;
         return plFileSystem::ConvertFileSize(bytesPerSec) + "/s";
     }
 
     void IUpdateProgress(uint32_t count)
     {
-        fBytesWritten += count; // just this file
-        fParent->fCurrBytes += count; // the entire everything
+        uint64_t currBytes = fParent->fCurrBytes += count; // the entire everything
 
         // tick-tick-tick, tick-tick-tock
         if (fParent->fProgressTick)
-            fParent->fProgressTick(fParent->fCurrBytes, fParent->fTotalBytes, IMakeStatusMsg());
+            fParent->fProgressTick(currBytes, fParent->fTotalBytes, IMakeStatusMsg(currBytes));
     }
 
 public:
     pfPatcherStream(pfPatcherWorker* parent, const plFileName& filename, uint64_t size)
-        : fParent(parent), fFilename(filename), fFlags(), fBytesWritten(), fDLStartTime(), plZlibStream()
+        : fParent(parent), fFilename(filename), fFlags(), plZlibStream()
     {
         fParent->fTotalBytes += size;
         fOutput = std::make_unique<hsRAMStream>();
     }
 
     pfPatcherStream(pfPatcherWorker* parent, const pfPatcherQueuedFile& file)
-        : fParent(parent), fFilename(file.fClientPath.Normalize()), fFlags(file.fFlags), fBytesWritten(), fDLStartTime(), plZlibStream()
+        : fParent(parent), fFilename(file.fClientPath.Normalize()), fFlags(file.fFlags), plZlibStream()
     {
         // ugh. eap removed the compressed flag in his fail manifests
         if (file.fServerPath.GetFileExt().compare_i("gz") == 0) {
@@ -256,7 +422,9 @@ public:
 
     void Begin()
     {
-        fDLStartTime = hsTimer::GetSeconds<float>();
+        // The speed shown is measured from the start of the first download
+        float unset = 0.f;
+        fParent->fDLStartTime.compare_exchange_strong(unset, hsTimer::GetSeconds<float>());
         if (!fOutput)
             Open(fFilename, "wb");
     }
@@ -312,7 +480,6 @@ void pfPatcherWorker::IAuthThingDownloadCB(ENetError result, const plFileName& f
 {
     if (IS_NET_SUCCESS(result)) {
         PatcherLogGreen("\tDownloaded Legacy File '{}'", filename);
-        IssueRequest();
 
         // Now, we pass our RAM-backed file to the game code handlers. In the main client,
         // this will trickle down and add a new friend to plStreamSource. This should never
@@ -323,6 +490,7 @@ void pfPatcherWorker::IAuthThingDownloadCB(ENetError result, const plFileName& f
         PatcherLogRed("\tDownloaded Failed: File '{}'", filename);
         EndPatch(result, filename.AsString());
     }
+    IRequestFinished();
 }
 
 void pfPatcherWorker::IGotAuthFileList(ENetError result, const std::vector<NetCliAuthFileInfo>& infos)
@@ -344,11 +512,11 @@ void pfPatcherWorker::IGotAuthFileList(ENetError result, const std::vector<NetCl
                 fRequests.emplace_back(fn.AsString(), Request::kAuthFile, s);
             }
         }
-        IssueRequest();
     } else {
         PatcherLogRed("\tSHIT! Some legacy manifest phailed");
         EndPatch(result, "SecurePreloader failed");
     }
+    IRequestFinished();
 }
 
 void pfPatcherWorker::IHandleManifestDownload(const ST::string& group, const std::vector<NetCliFileManifestEntry>& manifest)
@@ -358,19 +526,17 @@ void pfPatcherWorker::IHandleManifestDownload(const ST::string& group, const std
         hsLockGuard(fFileMut);
         for (const auto& entry : manifest)
             fQueuedFiles.emplace_back(pfPatcherQueuedFile::Type::kManifestHash, entry);
-        fFileSignal.Signal();
     }
-    IssueRequest();
+    fFileSignal.notify_all();
 }
 
 void pfPatcherWorker::IPreloaderManifestDownloadCB(ENetError result, const ST::string& group, const std::vector<NetCliFileManifestEntry>& manifest)
 {
-    if (IS_NET_SUCCESS(result)) {
+    if (IS_NET_SUCCESS(result))
         IHandleManifestDownload(group, manifest);
-    } else {
+    else
         EnqueuePreloaderLists();
-        IssueRequest();
-    }
+    IRequestFinished();
 }
 
 void pfPatcherWorker::IFileManifestDownloadCB(ENetError result, const ST::string& group, const std::vector<NetCliFileManifestEntry>& manifest)
@@ -381,6 +547,7 @@ void pfPatcherWorker::IFileManifestDownloadCB(ENetError result, const ST::string
         PatcherLogRed("\tDownload Failed: Manifest '{}'", group);
         EndPatch(result, group);
     }
+    IRequestFinished();
 }
 
 void pfPatcherWorker::IFileThingDownloadCB(ENetError result, const plFileName& filename, pfPatcherStream* stream)
@@ -396,18 +563,22 @@ void pfPatcherWorker::IFileThingDownloadCB(ENetError result, const plFileName& f
     if (IS_NET_SUCCESS(result)) {
         PatcherLogGreen("\tDownloaded File '{}'", stream->GetFileName());
         WhitelistFile(stream->GetFileName(), true);
-        if (fSelfPatch && stream->IsSelfPatch())
-            fSelfPatch(stream->GetFileName());
-        if (fRedistUpdateDownloaded && stream->IsRedistUpdate())
-            fRedistUpdateDownloaded(stream->GetFileName());
+        {
+            hsLockGuard(fCallbackMut);
+            if (fSelfPatch && stream->IsSelfPatch())
+                fSelfPatch(stream->GetFileName());
+            if (fRedistUpdateDownloaded && stream->IsRedistUpdate())
+                fRedistUpdateDownloaded(stream->GetFileName());
+        }
 
-        // Punt the SFX decompression to the patcher thread (this is the main/draw thread)
+        // Punt the SFX decompression to the patcher threads (this is the main/draw thread)
         if (stream->RequiresSfxCache()) {
-            hsLockGuard(fFileMut);
-            fQueuedFiles.emplace_back(pfPatcherQueuedFile::Type::kSoundDecompress, stream->GetFileName(), stream->GetFlags());
-            fFileSignal.Signal();
+            {
+                hsLockGuard(fFileMut);
+                fQueuedFiles.emplace_back(pfPatcherQueuedFile::Type::kSoundDecompress, stream->GetFileName(), stream->GetFlags());
+            }
+            fFileSignal.notify_one();
         }
-        IssueRequest();
     } else {
         PatcherLogRed("\tDownloaded Failed: File '{}'", stream->GetFileName());
         stream->Unlink();
@@ -415,14 +586,19 @@ void pfPatcherWorker::IFileThingDownloadCB(ENetError result, const plFileName& f
     }
 
     delete stream;
+    IRequestFinished();
 }
 
 // ===================================================
 
 pfPatcherWorker::pfPatcherWorker() :
-    fStarted(false), fCurrBytes(0), fTotalBytes(0), fRequestActive(true),
-    fWantPython(), fWantSDL()
-{ }
+    fStarted(false), fWantPython(), fWantSDL(),
+    fMaxRequests(kDefaultMaxRequests), fActiveRequests(),
+    fNumFileThreads(std::clamp(std::thread::hardware_concurrency(), 1U, kDefaultMaxFileThreads)),
+    fActiveFiles(), fCurrBytes(0), fTotalBytes(0), fDLStartTime(0.f)
+{
+    fHashCache.SetPath(kDefaultHashCache);
+}
 
 pfPatcherWorker::~pfPatcherWorker()
 {
@@ -445,7 +621,7 @@ pfPatcherWorker::~pfPatcherWorker()
 void pfPatcherWorker::EndPatch(ENetError result, const ST::string& msg)
 {
     // Guard against multiple calls
-    if (fStarted) {
+    if (fStarted.exchange(false)) {
         // Send end status
         if (fOnComplete)
             fOnComplete(result, msg);
@@ -459,26 +635,55 @@ void pfPatcherWorker::EndPatch(ENetError result, const ST::string& msg)
         }
     }
 
-    fStarted = false;
-    fFileSignal.Signal();
+    // Taking the file lock ensures no patcher thread can miss this wakeup.
+    { hsLockGuard(fFileMut); }
+    fFileSignal.notify_all();
+}
+
+void pfPatcherWorker::IRequestFinished()
+{
+    {
+        hsLockGuard(fRequestMut);
+        hsAssert(fActiveRequests > 0, "Finished a request that was never issued?");
+        --fActiveRequests;
+    }
+    IssueRequest();
 }
 
 bool pfPatcherWorker::IssueRequest()
 {
-    hsLockGuard(fRequestMut);
-    if (fRequests.empty()) {
-        fRequestActive = false;
-        fFileSignal.Signal(); // make sure the patch thread doesn't deadlock!
-        return false;
-    } else
-        fRequestActive = true;
+    std::unique_lock<std::recursive_mutex> lock(fRequestMut);
+    while (fStarted && !fRequests.empty() && fActiveRequests < fMaxRequests) {
+        // Pull the request out before talking to the network so that a callback
+        // that fires immediately can't trip over it.
+        Request req = std::move(fRequests.front());
+        fRequests.pop_front();
+        ++fActiveRequests;
+
+        hsUnlockGuard(lock);
+        IIssueRequest(req);
+    }
+
+    bool active = fActiveRequests != 0;
+    lock.unlock();
+
+    // make sure the patch threads don't deadlock!
+    if (!active) {
+        { hsLockGuard(fFileMut); }
+        fFileSignal.notify_all();
+    }
+    return active;
+}
 
-    const Request& req = fRequests.front();
+void pfPatcherWorker::IIssueRequest(const Request& req)
+{
     switch (req.fType) {
         case Request::kFile:
             req.fStream->Begin();
-            if (fFileBeginDownload)
+            if (fFileBeginDownload) {
+                hsLockGuard(fCallbackMut);
                 fFileBeginDownload(req.fStream->GetFileName());
+            }
 
             NetCliFileDownloadRequest(req.fName, req.fStream, 0, [this, filename = req.fName, stream = req.fStream](auto result) {
                 IFileThingDownloadCB(result, filename, stream);
@@ -499,8 +704,10 @@ bool pfPatcherWorker::IssueRequest()
         case Request::kAuthFile:
             // ffffffuuuuuu
             req.fStream->Begin();
-            if (fFileBeginDownload)
+            if (fFileBeginDownload) {
+                hsLockGuard(fCallbackMut);
                 fFileBeginDownload(req.fStream->GetFileName());
+            }
 
             NetCliAuthFileRequest(req.fName, req.fStream, [this, filename = req.fName, writer = req.fStream](auto result) {
                 IAuthThingDownloadCB(result, filename, writer);
@@ -518,41 +725,47 @@ bool pfPatcherWorker::IssueRequest()
             break;
         DEFAULT_FATAL(req.fType);
     }
-
-    fRequests.pop_front();
-    return true;
 }
 
 void pfPatcherWorker::Run()
 {
     // So here's the rub:
-    // We have one or many manifests in the fRequests deque. We begin issuing those requests one-by one, starting here.
-    // As we receive the answer, the NetCli thread populates fQueuedFiles and pings the fFileSignal semaphore, then issues the next request...
-    // In this non-UI/non-Net thread, we do the stutter-prone/time-consuming IO/hashing operations. (Typically, the UI thread == Net thread)
-    // As we find files that need updating, we add them to fRequests.
-    // If there is no net request from ME when we find a file, we issue the request
+    // We have one or many manifests in the fRequests deque. We issue up to fMaxRequests of them at once, starting here.
+    // As we receive the answers, the NetCli thread populates fQueuedFiles and wakes the patcher threads, then issues the next request...
+    // In the non-UI/non-Net patcher threads, we do the stutter-prone/time-consuming IO/hashing operations. (Typically, the UI thread == Net thread)
+    // As we find files that need updating, we add them to fRequests and issue them if there is room in the pipe.
     // Once a file is downloaded, the next request is issued.
-    // When there are no files in my deque and no requests in my deque, we exit without errors.
+    // When there are no files in my deque, no requests in my deque, and nothing in flight, we exit without errors.
     PatcherLogWhite("--- Patch Started ({} requests) ---", fRequests.size());
+    fHashCache.Load();
     fStarted = true;
     IssueRequest();
 
-    // Now, work until we're done processing files
-    do {
-        fFileSignal.Wait();
+    std::vector<std::thread> fileThreads;
+    fileThreads.reserve(fNumFileThreads - 1);
+    for (uint32_t i = 1; i < fNumFileThreads; ++i) {
+        fileThreads.emplace_back(hsThread::StartSimpleThread([this, i] {
+            hsThread::SetThisThreadName(ST::format("pfPatcherFile{}", i));
+            ProcessFiles();
+        }));
+    }
 
-        hsLockGuard(fFileMut);
-        if (!fQueuedFiles.empty()) {
-            ProcessFile();
-            continue;
-        }
+    // Now, work until we're done processing files
+    ProcessFiles();
+    for (std::thread& thread : fileThreads)
+        thread.join();
 
-        // This makes sure both queues are empty before exiting.
-        if (!fRequestActive)
-            if(!IssueRequest())
-                break;
-    } while (fStarted);
+    // If we bailed out early, there may still be downloads in flight. Their callbacks
+    // reference us, so we can't go away until they've all come home.
+    {
+        std::unique_lock<std::mutex> lock(fFileMut);
+        fFileSignal.wait(lock, [this] {
+            hsLockGuard(fRequestMut);
+            return fActiveRequests == 0;
+        });
+    }
 
+    fHashCache.Save();
     EndPatch(kNetSuccess);
 }
 
@@ -571,11 +784,16 @@ void pfPatcherWorker::IHashFile(pfPatcherQueuedFile& file)
     // Check to see if ours matches
     plFileName clientPathForComparison = file.fClientPath;
     if ((file.fFlags & kBundle) && fFindBundleExe) {
+        hsLockGuard(fCallbackMut);
         clientPathForComparison = fFindBundleExe(clientPathForComparison);
     }
     plFileInfo mine(clientPathForComparison);
     if (mine.FileSize() == file.fFileSize) {
-        plMD5Checksum cliMD5(clientPathForComparison);
+        plMD5Checksum cliMD5;
+        if (!fHashCache.Find(clientPathForComparison, mine, cliMD5)) {
+            cliMD5.CalcFromFile(clientPathForComparison);
+            fHashCache.Update(clientPathForComparison, mine, cliMD5);
+        }
         if (cliMD5 == file.fChecksum) {
             WhitelistFile(file.fClientPath, false);
             return;
@@ -584,6 +802,7 @@ void pfPatcherWorker::IHashFile(pfPatcherQueuedFile& file)
 
     // It's different... but do we want it?
     if (fFileDownloadDesired) {
+        hsLockGuard(fCallbackMut);
         if (!fFileDownloadDesired(file.fClientPath)) {
             PatcherLogRed("\tDeclined '{}'", file.fClientPath);
             return;
@@ -596,7 +815,12 @@ void pfPatcherWorker::IHashFile(pfPatcherQueuedFile& file)
 
     // If someone registered for SelfPatch notifications, then we should probably
     // let them handle the gruntwork... Otherwise, go nuts!
-    if (fSelfPatch) {
+    bool wantSelfPatch;
+    {
+        hsLockGuard(fCallbackMut);
+        wantSelfPatch = static_cast<bool>(fSelfPatch);
+    }
+    if (wantSelfPatch) {
         if (file.fClientPath == plFileSystem::GetCurrentAppPath().GetFileName()) {
             file.fClientPath += ".tmp"; // don't overwrite myself!
             file.fFlags |= kSelfPatch;
@@ -619,27 +843,63 @@ void pfPatcherWorker::IDecompressSound(const pfPatcherQueuedFile& file) const
         plAudioFileReader::CacheFile(file.fClientPath, false);
 }
 
-void pfPatcherWorker::ProcessFile()
+void pfPatcherWorker::ProcessFile(pfPatcherQueuedFile& file)
 {
-    do {
-        pfPatcherQueuedFile& file = fQueuedFiles.front();
-        switch (file.fType) {
-        case pfPatcherQueuedFile::Type::kManifestHash:
-            IHashFile(file);
-            break;
-        case pfPatcherQueuedFile::Type::kSoundDecompress:
-            IDecompressSound(file);
-            break;
+    switch (file.fType) {
+    case pfPatcherQueuedFile::Type::kManifestHash:
+        IHashFile(file);
+        break;
+    case pfPatcherQueuedFile::Type::kSoundDecompress:
+        IDecompressSound(file);
+        break;
+    }
+}
+
+void pfPatcherWorker::ProcessFiles()
+{
+    std::unique_lock<std::mutex> lock(fFileMut);
+    while (fStarted) {
+        if (fQueuedFiles.empty()) {
+            if (IsFinished())
+                break;
+            fFileSignal.wait(lock);
+            continue;
         }
+
+        pfPatcherQueuedFile file = std::move(fQueuedFiles.front());
         fQueuedFiles.pop_front();
+        ++fActiveFiles;
 
-        if (!fRequestActive)
+        {
+            hsUnlockGuard(lock);
+            ProcessFile(file);
             IssueRequest();
-    } while (!fQueuedFiles.empty());
+        }
+
+        --fActiveFiles;
+    }
+    lock.unlock();
+
+    // Whatever stopped us will stop everyone else, too.
+    fFileSignal.notify_all();
+}
+
+bool pfPatcherWorker::IsFinished()
+{
+    // The caller must hold fFileMut. New work is always queued before the work that
+    // spawned it is retired, so if nothing is queued or active anywhere, we're done.
+    if (!fQueuedFiles.empty() || fActiveFiles != 0)
+        return false;
+
+    hsLockGuard(fRequestMut);
+    return fRequests.empty() && fActiveRequests == 0;
 }
 
 void pfPatcherWorker::WhitelistFile(const plFileName& file, bool justDownloaded, hsStream* stream)
 {
+    // this can be reached from the net thread and any of the patcher threads
+    hsLockGuard(fCallbackMut);
+
     // if this is a newly downloaded file, fire off a completion callback
     if (justDownloaded && fFileDownloaded)
         fFileDownloaded(file);
@@ -680,14 +940,13 @@ void pfPatcherWorker::EnqueuePreloaderLists()
 
 plStatusLog* pfPatcher::GetLog()
 {
-    static plStatusLog* log = nullptr;
-    if (!log)
-    {
-        log = plStatusLogMgr::GetInstance().CreateStatusLog(
-            20,
-            "patcher.log",
-            plStatusLog::kFilledBackground | plStatusLog::kAlignToTop | plStatusLog::kDeleteForMe);
-    }
+    // The patcher's worker and download threads all log here, so leave the
+    // file writes to the status log writer rather than contending for it.
+    static plStatusLog* log = plStatusLogMgr::GetInstance().CreateStatusLog(
+        20,
+        "patcher.log",
+        plStatusLog::kFilledBackground | plStatusLog::kAlignToTop | plStatusLog::kDeleteForMe |
+        plStatusLog::kAsyncLog);
     return log;
 }
 
@@ -699,6 +958,21 @@ pfPatcher& pfPatcher::operator=(pfPatcher&& other) noexcept = default;
 
 // ===================================================
 
+void pfPatcher::SetMaxRequests(uint32_t num)
+{
+    fWorker->fMaxRequests = std::max(num, 1U);
+}
+
+void pfPatcher::SetFileThreads(uint32_t num)
+{
+    fWorker->fNumFileThreads = std::max(num, 1U);
+}
+
+void pfPatcher::SetHashCache(const plFileName& path)
+{
+    fWorker->fHashCache.SetPath(path);
+}
+
 void pfPatcher::OnFindBundleExe(FindBundleExeFunc vb)
 {
     fWorker->fFindBundleExe = std::move(vb);
@@ -736,11 +1010,13 @@ void pfPatcher::OnProgressTick(ProgressTickFunc cb)
 
 void pfPatcher::OnRedistUpdate(FileDownloadFunc cb)
 {
+    hsLockGuard(fWorker->fCallbackMut);
     fWorker->fRedistUpdateDownloaded = std::move(cb);
 }
 
 void pfPatcher::OnSelfPatch(FileDownloadFunc cb)
 {
+    hsLockGuard(fWorker->fCallbackMut);
     fWorker->fSelfPatch = std::move(cb);
 }
 
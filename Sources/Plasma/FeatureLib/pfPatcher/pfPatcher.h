@@ -99,6 +99,22 @@ public:
     pfPatcher& operator=(const pfPatcher& other) = delete;
     pfPatcher& operator=(pfPatcher&& other) noexcept;
 
+    /** Set the maximum number of manifest and file requests that may be in flight to the
+     *  server at once. Defaults to 8; use 1 to download strictly one file at a time.
+     */
+    void SetMaxRequests(uint32_t num);
+
+    /** Set the number of threads used to hash local files and post-process downloads
+     *  (such as decompressing sounds). Defaults to the number of CPU cores, up to 4.
+     */
+    void SetFileThreads(uint32_t num);
+
+    /** Set the file used to remember the hashes of local files between runs, so that files
+     *  whose size and modification time haven't changed aren't hashed again. Defaults to
+     *  "patcher.cache" in the working directory; pass an empty filename to disable it.
+     */
+    void SetHashCache(const plFileName& path);
+
     /** Set a callback that will be fired when the patcher needs to find an executable file
      *  within an executable bundle. This only occurs on the macOS client and is
      *  specific to macOS executable application bundles.
@@ -118,7 +134,7 @@ public:
 
     /** Set a callback that will be fired when the patcher wants to download a file. You are
      *  given the ability to approve or veto the download. With great power comes great responsibility...
-     *  \remarks This will be called from the patcher thread.
+     *  \remarks This will be called from any of the patcher threads, but never from two at once.
      */
     void OnFileDownloadDesired(FileDesiredFunc cb);
 
@@ -134,7 +150,7 @@ public:
     void OnGameCodeDiscovery(GameCodeDiscoverFunc cb);
 
     /** Set a callback that will be fired when the patcher receives a chunk from the server. The status string
-     *  will contain the current download speed.
+     *  will contain the current download speed of the whole patch, as several files may be downloading at once.
      *  \remarks This will be called from the network thread.
      */
     void OnProgressTick(ProgressTickFunc cb);
@@ -394,8 +394,8 @@ bool plPythonFileMod::ILoadPythonCode()
 
     // Finally, try and find the file in the Python packfile
     // ... for the external users .pak file is only used
-    PyObject* pythonCode = PythonPack::OpenPythonPacked(fPythonFile);
-    if (pythonCode && PythonInterface::RunPYC(pythonCode, fModule))
+    pyObjectRef pythonCode = PythonPack::OpenPythonPacked(fPythonFile);
+    if (pythonCode && PythonInterface::RunPYC(pythonCode.Get(), fModule))
         return true;
 
     ST::string errMsg = ST::format("Python file {}.py was not found.", fPythonFile);
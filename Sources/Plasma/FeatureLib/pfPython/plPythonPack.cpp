@@ -42,33 +42,57 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 
 #include <Python.h>
 #include <marshal.h>
+#include <algorithm>
 #include <ctime>
+#include <memory>
 #include <string_theory/format>
+#include <unordered_map>
+#include <vector>
 
 #include "HeadSpin.h"
 #include "hsStream.h"
 
 #include "plPythonPack.h"
 
+#include "plFile/plEncryptedStream.h"
+#include "plFile/plSecureStream.h"
 #include "plFile/plStreamSource.h"
 
-struct plPackOffsetInfo
+struct plPackEntry
 {
+    ST::string fName;
     uint32_t fOffset;
-    uint32_t fStreamIndex; // index of the stream object in the plPythonPack object that the file resides in
+    uint32_t fStreamIndex; // index of the pack in the plPythonPack object that the file resides in
+};
+
+struct plPackFile
+{
+    hsStream* fStream;      // owned by plStreamSource
+    std::unique_ptr<hsMappedFileStream> fMapping; // plain .pak files are mapped instead
+    time_t fModTime;        // to resolve duplicate file issues
 };
 
 class plPythonPack
 {
 protected:
-    std::vector<hsStream*> fPackStreams;
+    std::vector<plPackFile> fPacks;
     bool fPackNotFound;     // No pack file, don't keep trying
 
-    typedef std::map<ST::string, plPackOffsetInfo> FileOffset;
-    FileOffset fFileOffsets;
+    // Sorted by name, built once when the packs are opened
+    std::vector<plPackEntry> fEntries;
+
+    // Unmarshalled code objects, so repeat imports skip the read and unmarshal
+    std::unordered_map<ST::string, PyObject*, ST::hash> fCodeCache;
+
+    // Reused for packs we can't view directly
+    std::vector<char> fReadBuffer;
 
     plPythonPack();
 
+    void IReadIndex(hsStream* stream, uint32_t streamIndex, std::vector<plPackEntry>& entries);
+    const plPackEntry* IFindEntry(const ST::string& pythonName) const;
+    PyObject* IUnmarshal(const plPackEntry& entry, const ST::string& fileName);
+
 public:
     ~plPythonPack();
 
@@ -76,6 +100,7 @@ public:
 
     bool Open();
     void Close();
+    void ClearCache();
 
     PyObject* OpenPacked(const ST::string& sfileName);
     bool IsPackedFile(const ST::string& fileName);
@@ -91,6 +116,11 @@ bool PythonPack::IsItPythonPacked(const ST::string& fileName)
     return plPythonPack::Instance().IsPackedFile(fileName);
 }
 
+void PythonPack::ClearCache()
+{
+    plPythonPack::Instance().ClearCache();
+}
+
 plPythonPack::plPythonPack() : fPackNotFound(false)
 {
 }
@@ -106,9 +136,25 @@ plPythonPack& plPythonPack::Instance()
     return theInstance;
 }
 
+void plPythonPack::IReadIndex(hsStream* stream, uint32_t streamIndex, std::vector<plPackEntry>& entries)
+{
+    stream->Rewind(); // make sure we're at the beginning of the file
+
+    uint32_t numFiles = stream->ReadLE32();
+    entries.reserve(entries.size() + numFiles);
+    for (uint32_t i = 0; i < numFiles; i++)
+    {
+        plPackEntry entry;
+        entry.fName = stream->ReadSafeString();
+        entry.fOffset = stream->ReadLE32();
+        entry.fStreamIndex = streamIndex;
+        entries.emplace_back(std::move(entry));
+    }
+}
+
 bool plPythonPack::Open()
 {
-    if (fPackStreams.size() > 0)
+    if (fPacks.size() > 0)
         return true;
     
     // We already tried and it wasn't there
@@ -120,47 +166,62 @@ bool plPythonPack::Open()
     // Get the names of all the pak files
     std::vector<plFileName> files = plStreamSource::GetInstance()->GetListOfNames("python", "pak");
 
-    std::vector<time_t> modTimes; // the modification time for each of the streams (to resolve duplicate file issues)
-
     // grab all the .pak files in the folder
-    for (int curName = 0; curName < files.size(); curName++)
+    std::vector<plPackEntry> entries;
+    for (const plFileName& fileName : files)
     {
         // obtain the stream
-        hsStream *fPackStream = plStreamSource::GetInstance()->GetFile(files[curName]);
-        if (fPackStream)
-        {
-            fPackStream->Rewind(); // make sure we're at the beginning of the file
-            fPackNotFound = false;
-
-            time_t curModTime = 0;
-            plFileInfo info(files[curName]);
-            if (info.Exists())
-                curModTime = info.ModifyTime();
-            modTimes.push_back(curModTime);
-
-            // read the index data
-            int numFiles = fPackStream->ReadLE32();
-            uint32_t streamIndex = (uint32_t)(fPackStreams.size());
-            for (int i = 0; i < numFiles; i++)
-            {
-                // and pack the index into our own data structure
-                ST::string pythonName = fPackStream->ReadSafeString();
-                uint32_t offset = fPackStream->ReadLE32();
-
-                plPackOffsetInfo offsetInfo;
-                offsetInfo.fOffset = offset;
-                offsetInfo.fStreamIndex = streamIndex;
-
-                if (fFileOffsets.find(pythonName) != fFileOffsets.end())
-                {
-                    uint32_t index = fFileOffsets[pythonName].fStreamIndex;
-                    if (modTimes[index] < curModTime) // is the existing file older then the new one?
-                        fFileOffsets[pythonName] = offsetInfo; // yup, so replace it with the new info
-                }
-                else
-                    fFileOffsets[pythonName] = offsetInfo; // no conflicts, add the info
+        hsStream* packStream = plStreamSource::GetInstance()->GetFile(fileName);
+        if (!packStream)
+            continue;
+
+        fPackNotFound = false;
+
+        plPackFile pack;
+        pack.fStream = packStream;
+        pack.fModTime = 0;
+
+        plFileInfo info(fileName);
+        if (info.Exists()) {
+            pack.fModTime = info.ModifyTime();
+
+            // Unencrypted packs that plStreamSource read off the disk itself are
+            // mapped, so modules are unmarshalled straight out of the OS file cache.
+            // That means they mustn't be rebuilt in place while the client is running
+            // (see hsMappedFileStream). Anything the preloader handed over has to
+            // come from that stream, no matter what happens to be lying around on
+            // disk with the same name.
+#ifndef PLASMA_EXTERNAL_RELEASE
+            if (plStreamSource::GetInstance()->IsDiskFile(fileName)
+                    && !plSecureStream::IsSecureFile(fileName) && !plEncryptedStream::IsEncryptedFile(fileName)) {
+                auto mapping = std::make_unique<hsMappedFileStream>();
+                if (mapping->Open(fileName))
+                    pack.fMapping = std::move(mapping);
             }
-            fPackStreams.push_back(fPackStream);
+#endif // PLASMA_EXTERNAL_RELEASE
+        }
+
+        uint32_t streamIndex = (uint32_t)fPacks.size();
+        IReadIndex(pack.fMapping ? pack.fMapping.get() : pack.fStream, streamIndex, entries);
+        fPacks.emplace_back(std::move(pack));
+    }
+
+    // Sort the whole index by name. The sort is stable, so for duplicates the
+    // pack that was found first wins unless a later one is newer.
+    std::stable_sort(entries.begin(), entries.end(),
+        [](const plPackEntry& lhs, const plPackEntry& rhs) { return lhs.fName < rhs.fName; }
+    );
+
+    fEntries.clear();
+    fEntries.reserve(entries.size());
+    for (plPackEntry& entry : entries)
+    {
+        if (!fEntries.empty() && fEntries.back().fName == entry.fName) {
+            time_t existingTime = fPacks[fEntries.back().fStreamIndex].fModTime;
+            if (existingTime < fPacks[entry.fStreamIndex].fModTime) // is the existing file older then the new one?
+                fEntries.back() = std::move(entry); // yup, so replace it with the new info
+        } else {
+            fEntries.emplace_back(std::move(entry)); // no conflicts, add the info
         }
     }
 
@@ -169,53 +230,103 @@ bool plPythonPack::Open()
 
 void plPythonPack::Close()
 {
-    if (fPackStreams.size() == 0)
+    // If Python has already been finalized, the cached objects are gone with it
+    if (Py_IsInitialized())
+        ClearCache();
+    else
+        fCodeCache.clear();
+
+    if (fPacks.size() == 0)
         return;
-    
-    int i;
-    for (i=0; i<fPackStreams.size(); i++)
-    {
-        // do NOT close or delete the streams, the preloader will do that for us
-        fPackStreams[i] = nullptr;
-    }
 
-    fPackStreams.clear();
-    fFileOffsets.clear();
+    // do NOT close or delete the streams, the preloader will do that for us
+    fPacks.clear();
+    fEntries.clear();
+    fReadBuffer.clear();
+    fReadBuffer.shrink_to_fit();
 }
 
-PyObject* plPythonPack::OpenPacked(const ST::string& fileName)
+void plPythonPack::ClearCache()
 {
-    if (!Open())
+    for (auto& it : fCodeCache)
+        Py_XDECREF(it.second);
+    fCodeCache.clear();
+}
+
+const plPackEntry* plPythonPack::IFindEntry(const ST::string& pythonName) const
+{
+    auto it = std::lower_bound(fEntries.begin(), fEntries.end(), pythonName,
+        [](const plPackEntry& entry, const ST::string& name) { return entry.fName < name; }
+    );
+    if (it != fEntries.end() && it->fName == pythonName)
+        return &(*it);
+    return nullptr;
+}
+
+PyObject* plPythonPack::IUnmarshal(const plPackEntry& entry, const ST::string& fileName)
+{
+    const plPackFile& pack = fPacks[entry.fStreamIndex];
+
+    if (pack.fMapping) {
+        // Read straight out of the mapping, no copy needed
+        hsMappedFileStream* mapping = pack.fMapping.get();
+        uint32_t eof = mapping->GetEOF();
+        if (eof < sizeof(uint32_t) || entry.fOffset > eof - sizeof(uint32_t))
+            return nullptr;
+
+        mapping->SetPosition(entry.fOffset);
+        int32_t size = mapping->ReadLE32();
+        if (size <= 0)
+            return nullptr;
+        if (uint32_t(size) > eof - mapping->GetPosition()) {
+            hsAssert(false, ST::format("Python PackFile {}: Data runs past the end of the pack", fileName).c_str());
+            return nullptr;
+        }
+
+        const char* data = static_cast<const char*>(mapping->GetData()) + mapping->GetPosition();
+        return PyMarshal_ReadObjectFromString(data, size);
+    }
+
+    hsStream* packStream = pack.fStream;
+    packStream->SetPosition(entry.fOffset);
+
+    int32_t size = packStream->ReadLE32();
+    if (size <= 0)
         return nullptr;
 
-    ST::string pythonName = fileName + ".py";
+    if (fReadBuffer.size() < size_t(size))
+        fReadBuffer.resize(size);
+    uint32_t readSize = packStream->Read(size, fReadBuffer.data());
+    hsAssert(readSize <= size, ST::format("Python PackFile {}: Incorrect amount of data, read {} instead of {}",
+             fileName, readSize, size).c_str());
 
-    FileOffset::iterator it = fFileOffsets.find(pythonName);
-    if (it != fFileOffsets.end())
-    {
-        plPackOffsetInfo offsetInfo = (*it).second;
-        hsStream* fPackStream = fPackStreams[offsetInfo.fStreamIndex];
-        
-        fPackStream->SetPosition(offsetInfo.fOffset);
+    // let the python marshal make it back into a code object
+    return PyMarshal_ReadObjectFromString(fReadBuffer.data(), size);
+}
 
-        int32_t size = fPackStream->ReadLE32();
-        if (size > 0)
-        {
-            char *buf = new char[size];
-            uint32_t readSize = fPackStream->Read(size, buf);
-            hsAssert(readSize <= size, ST::format("Python PackFile {}: Incorrect amount of data, read {} instead of {}",
-                     fileName, readSize, size).c_str());
+PyObject* plPythonPack::OpenPacked(const ST::string& fileName)
+{
+    if (!Open())
+        return nullptr;
 
-            // let the python marshal make it back into a code object
-            PyObject *pythonCode = PyMarshal_ReadObjectFromString(buf, size);
+    auto cached = fCodeCache.find(fileName);
+    if (cached != fCodeCache.end()) {
+        Py_INCREF(cached->second);
+        return cached->second;
+    }
 
-            delete [] buf;
+    const plPackEntry* entry = IFindEntry(fileName + ".py");
+    if (!entry)
+        return nullptr;
 
-            return pythonCode;
-        }
+    PyObject* pythonCode = IUnmarshal(*entry, fileName);
+    if (pythonCode) {
+        // Code objects are immutable, so everyone can share the same one
+        Py_INCREF(pythonCode);
+        fCodeCache.emplace(fileName, pythonCode);
     }
 
-    return nullptr;
+    return pythonCode;
 }
 
 bool plPythonPack::IsPackedFile(const ST::string& fileName)
@@ -223,11 +334,5 @@ bool plPythonPack::IsPackedFile(const ST::string& fileName)
     if (!Open())
         return false;
 
-    ST::string pythonName = fileName + ".py";
-
-    FileOffset:: iterator it = fFileOffsets.find(pythonName);
-    if (it != fFileOffsets.end())
-        return true;
-
-    return false;
+    return IFindEntry(fileName + ".py") != nullptr;
 }
@@ -50,6 +50,9 @@ namespace PythonPack
     /** Returns new reference of marshalled python code. */
     PyObject* OpenPythonPacked(const ST::string& fileName);
     bool IsItPythonPacked(const ST::string& fileName);
+
+    /** Releases the cached code objects. Must be called before Python is finalized. */
+    void ClearCache();
 }
 
 #endif // plPythonPack_h_inc
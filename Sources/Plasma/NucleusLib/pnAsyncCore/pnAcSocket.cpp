@@ -81,6 +81,16 @@ static constexpr unsigned kBacklogFailMs = 2 * 60 * 1000;
 
 static constexpr size_t kMinBacklogBytes = 4 * 1024;
 
+// Socket reads start at this size and double whenever a read fills all the
+// free space, so bulk transfers (vault fetches, file downloads) arrive in a
+// few large chunks instead of many MTU-sized ones.
+static constexpr size_t kInitialReadBufferBytes = 16 * 1024;
+static constexpr size_t kMaxReadBufferBytes = 256 * 1024;
+
+// Unconsumed bytes are only shifted to the front of the read buffer once
+// there is less than this much room left behind them.
+static constexpr size_t kMinReadSpaceBytes = kAsyncSocketBufferSize;
+
 struct AsyncIoPool
 {
     asio::io_context                                           fContext;
@@ -154,23 +164,39 @@ struct WriteOperation
     }
 };
 
+static void FreeWriteOp(WriteOperation* op)
+{
+    // Storage was allocated alongside the operation in SocketQueueAsyncWrite
+    op->~WriteOperation();
+    delete[] reinterpret_cast<uint8_t*>(op);
+}
+
 struct AsyncSocketStruct
 {
     std::recursive_mutex        fCritsect;
     tcp::socket                 fSock;
     AsyncNotifySocketCallbacks* fCallbacks;
     unsigned int                fConnectionType;
-    uint8_t                     fBuffer[kAsyncSocketBufferSize];
-    size_t                      fBytesLeft;
+    std::vector<uint8_t>        fReadBuffer;
+    size_t                      fReadStart;     // first byte not yet consumed
+    size_t                      fReadEnd;       // one past the last byte received
     std::list<WriteOperation *> fWriteOps;
+    bool                        fWriteActive;   // an async_write is in flight
     unsigned                    initTimeMs;
     unsigned                    closeTimeMs;
 
     AsyncSocketStruct(ConnectOperation& op)
         : fSock(std::move(op.fSock)), fCallbacks(op.fCallbacks),
           fConnectionType(op.fConnectionType),
-          fBuffer(), fBytesLeft(), initTimeMs(), closeTimeMs()
+          fReadBuffer(kInitialReadBufferBytes), fReadStart(), fReadEnd(),
+          fWriteActive(), initTimeMs(), closeTimeMs()
     { }
+
+    ~AsyncSocketStruct()
+    {
+        for (WriteOperation* op : fWriteOps)
+            FreeWriteOp(op);
+    }
 };
 
 static AsyncIoPool*                 s_ioPool;
@@ -207,11 +233,33 @@ void SocketDestroy(unsigned exitThreadWaitMs)
     }
 }
 
+static bool SocketPrepareReadBuffer(AsyncSocket sock, bool filled)
+{
+    if (sock->fReadStart == sock->fReadEnd) {
+        sock->fReadStart = 0;
+        sock->fReadEnd = 0;
+    }
+
+    // A read that used up all of the free space means the peer is probably
+    // sending faster than we are reading, so give it more room next time.
+    if (filled && sock->fReadBuffer.size() < kMaxReadBufferBytes)
+        sock->fReadBuffer.resize(std::min(sock->fReadBuffer.size() * 2, kMaxReadBufferBytes));
+
+    if (sock->fReadBuffer.size() - sock->fReadEnd < kMinReadSpaceBytes && sock->fReadStart != 0) {
+        size_t bytesLeft = sock->fReadEnd - sock->fReadStart;
+        memmove(sock->fReadBuffer.data(), sock->fReadBuffer.data() + sock->fReadStart, bytesLeft);
+        sock->fReadStart = 0;
+        sock->fReadEnd = bytesLeft;
+    }
+
+    return sock->fReadEnd < sock->fReadBuffer.size();
+}
+
 static void SocketStartAsyncRead(AsyncSocket sock)
 {
     hsLockGuard(sock->fCritsect);
-    uint8_t* start = sock->fBuffer + sock->fBytesLeft;
-    size_t   count = sizeof(sock->fBuffer) - sock->fBytesLeft;
+    uint8_t* start = sock->fReadBuffer.data() + sock->fReadEnd;
+    size_t   count = sock->fReadBuffer.size() - sock->fReadEnd;
     sock->fSock.async_read_some(asio::buffer(start, count),
         [sock](const asio::error_code& err, size_t bytes) {
         if (err) {
@@ -236,32 +284,31 @@ static void SocketStartAsyncRead(AsyncSocket sock)
         if (!bytes)
             return;
 
-        sock->fBytesLeft += bytes;
+        sock->fReadEnd += bytes;
+        bool filled = (sock->fReadEnd == sock->fReadBuffer.size());
 
-        size_t bytesNotified = sock->fBytesLeft;
+        size_t bytesNotified = sock->fReadEnd - sock->fReadStart;
         std::optional<size_t> res;
         if (sock->fCallbacks) {
-            res = sock->fCallbacks->AsyncNotifySocketRead(sock, sock->fBuffer, bytesNotified);
+            res = sock->fCallbacks->AsyncNotifySocketRead(sock, sock->fReadBuffer.data() + sock->fReadStart, bytesNotified);
         }
         if (!res) {
             // No callback, or the callback told us to stop reading
             return;
         }
 
-        // if only some of the bytes were used, then shift
-        // remaining bytes down.  Otherwise, clear the buffer.
+        // Leftover bytes stay where they are until we run short of room
         size_t bytesProcessed = *res;
-        sock->fBytesLeft -= bytesProcessed;
-        if (sock->fBytesLeft != 0) {
-            if ((sock->fBytesLeft > sizeof(sock->fBuffer)) || ((bytesProcessed + sock->fBytesLeft) > sizeof(sock->fBuffer))) {
-                LogMsg(kLogError, "SocketDispatchRead error: {} {} {}",
-                       sock->fBytesLeft, bytesNotified, bytesProcessed);
-                return;
-            }
+        if (bytesProcessed > bytesNotified) {
+            LogMsg(kLogError, "SocketDispatchRead error: {} {}", bytesNotified, bytesProcessed);
+            return;
+        }
+        sock->fReadStart += bytesProcessed;
 
-            if (bytesProcessed != 0) {
-                memmove(sock->fBuffer, sock->fBuffer + bytesProcessed, sock->fBytesLeft);
-            }
+        if (!SocketPrepareReadBuffer(sock, filled)) {
+            LogMsg(kLogError, "SocketDispatchRead error: {} unconsumed bytes fill the read buffer",
+                   sock->fReadEnd - sock->fReadStart);
+            return;
         }
 
         SocketStartAsyncRead(sock);
@@ -433,6 +480,47 @@ void AsyncSocketDisconnect(AsyncSocket conn, bool hardClose)
     conn->closeTimeMs |= 1;
 }
 
+// Gathers everything queued since the last write into one vectored write.
+// Only one write is in flight per socket, so writes can never interleave on
+// the wire; anything queued meanwhile goes out when it completes.
+static void SocketStartAsyncWrite(AsyncSocket conn)
+{
+    std::vector<asio::const_buffer> allWrites;
+    allWrites.reserve(conn->fWriteOps.size());
+    for (WriteOperation* op : conn->fWriteOps) {
+        if (op->bytes - op->bytesCommitted > 0) {
+            allWrites.emplace_back(op->AsBuffer());
+            op->bytesCommitted = op->bytes;
+        }
+    }
+    if (allWrites.empty())
+        return;
+
+    conn->fWriteActive = true;
+    async_write(conn->fSock, allWrites, [conn](const asio::error_code& err, size_t bytes) {
+        hsLockGuard(s_connectCrit);
+        conn->fWriteActive = false;
+        while (bytes != 0) {
+            hsAssert(conn->fWriteOps.size() > 0, "buffer mismatch");
+            WriteOperation* op = conn->fWriteOps.front();
+
+            size_t opBytesWritten = std::min(bytes, op->bytes - op->bytesProcessed);
+            op->bytesProcessed += opBytesWritten;
+            bytes -= opBytesWritten;
+            if (op->bytes == op->bytesProcessed) {
+                conn->fWriteOps.pop_front();
+                FreeWriteOp(op);
+            }
+        }
+
+        // The socket is going away; whatever is left is freed with it
+        if (err)
+            return;
+
+        SocketStartAsyncWrite(conn);
+    });
+}
+
 static bool SocketQueueAsyncWrite(AsyncSocket conn, const void* data, size_t bytes)
 {
     hsLockGuard(s_connectCrit);
@@ -488,28 +576,8 @@ static bool SocketQueueAsyncWrite(AsyncSocket conn, const void* data, size_t byt
         PerfAddCounter(kAsyncPerfSocketBytesWaitQueued, bytes);
     }
 
-    std::vector<asio::const_buffer> allWrites;
-    allWrites.reserve(conn->fWriteOps.size());
-    for (WriteOperation* op : conn->fWriteOps) {
-        if (op->bytes - op->bytesCommitted > 0) {
-            allWrites.emplace_back(op->AsBuffer());
-            op->bytesCommitted = op->bytes;
-        }
-    }
-    async_write(conn->fSock, allWrites, [conn](const asio::error_code& err, size_t bytes) {
-        hsLockGuard(s_connectCrit);
-        while (bytes != 0) {
-            hsAssert(conn->fWriteOps.size() > 0, "buffer mismatch");
-            WriteOperation* op = conn->fWriteOps.front();
-
-            size_t opBytesWritten = std::min(bytes, op->bytes - op->bytesProcessed);
-            op->bytesProcessed += opBytesWritten;
-            bytes -= opBytesWritten;
-            if (op->bytes == op->bytesProcessed) {
-                conn->fWriteOps.pop_front();
-            }
-        }
-    });
+    if (!conn->fWriteActive)
+        SocketStartAsyncWrite(conn);
 
     return true;
 }
@@ -46,6 +46,7 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 #include "pnFactory/plFactory.h"
 #define PLMESSAGE_PRIVATE
 #include "pnMessage/plMessage.h"
+#include "pnMessage/plMessagePool.h"
 #include "pnKeyedObject/hsKeyedObject.h"
 #include "hsTimer.h"
 #include "pnMessage/plTimeMsg.h"
@@ -57,6 +58,8 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 #include "hsThread.h"
 #include "plProfile.h"
 
+#include <algorithm>
+
 #ifdef HS_DEBUGGING
 #include "hsDebug.h"
 #endif
@@ -66,6 +69,9 @@ plProfile_CreateTimer("  TimeMsg", "Update", TimeMsg);
 plProfile_CreateTimer("  EvalMsg", "Update", EvalMsg);
 plProfile_CreateTimer("  TransformMsg", "Update", TransformMsg);
 plProfile_CreateTimer("  CameraMsg", "Update", CameraMsg);
+plProfile_CreateTimer("DeferredInsert", "Update", DeferredInsert);
+plProfile_CreateCounter("Deferred Inserts", "Update", DeferredInserts);
+plProfile_CreateCounterNoReset("Deferred Depth", "Update", DeferredDepth);
 
 class plMsgWrap
 {
@@ -75,12 +81,16 @@ public:
     std::vector<plKey>              fReceivers;
 
     plMessage*                      fMsg;
+    uint32_t                        fSequence;
 
     plMsgWrap(plMessage* msg)
-        : fMsg(msg), fNext(), fBack()
+        : fMsg(msg), fNext(), fBack(), fSequence()
     { hsRefCnt_SafeRef(msg); }
     virtual ~plMsgWrap() { hsRefCnt_SafeUnRef(fMsg); }
 
+    // One of these is made for every message sent, so recycle them.
+    PLMESSAGE_POOLED();
+
     plMsgWrap&      ClearReceivers() { fReceivers.clear(); return *this; }
     plMsgWrap&      AddReceiver(plKey rcv)
                     {
@@ -92,6 +102,8 @@ public:
     size_t          GetNumReceivers() const { return fReceivers.size(); }
 };
 
+PLMESSAGE_POOLED_IMPL(plMsgWrap);
+
 int32_t                 plDispatch::fNumBufferReq = 0;
 bool                    plDispatch::fMsgActive = false;
 plMsgWrap*              plDispatch::fMsgCurrent = nullptr;
@@ -104,8 +116,19 @@ std::mutex              plDispatch::fMsgCurrentMutex; // mutex for fMsgCurrent
 std::mutex              plDispatch::fMsgDispatchLock; // mutex for IMsgDispatch
 
 
+// Heap ordering for the deferred queue. std::push_heap keeps the "largest"
+// element at the front, so this answers "does a fire after b" to put the
+// earliest timestamp on top. Ties go to whichever was sent first.
+static bool DeferredFiresAfter(const plMsgWrap* a, const plMsgWrap* b)
+{
+    if (a->fMsg->fTimeStamp != b->fMsg->fTimeStamp)
+        return a->fMsg->fTimeStamp > b->fMsg->fTimeStamp;
+    // Wrap-safe comparison so a long session doesn't reorder a tie.
+    return int32_t(a->fSequence - b->fSequence) > 0;
+}
+
 plDispatch::plDispatch()
-: fOwner(), fFutureMsgQueue(), fQueuedMsgOn(true)
+: fOwner(), fFutureMsgSequence(), fQueuedMsgOn(true)
 {
 }
 
@@ -125,13 +148,13 @@ void plDispatch::BeginShutdown()
 
 void plDispatch::ITrashUndelivered()
 {
-    while( fFutureMsgQueue )
+    for (plMsgWrap* nuke : fFutureMsgQueue)
     {
-        plMsgWrap* nuke = fFutureMsgQueue;
-        fFutureMsgQueue = fFutureMsgQueue->fNext;
         hsRefCnt_SafeUnRef(nuke->fMsg);
         delete nuke;
+        plProfile_Dec(DeferredDepth);
     }
+    fFutureMsgQueue.clear();
 
     // If we're the main dispatch, any unsent messages at this
     // point are just trashed. Slave dispatches just go away and
@@ -180,41 +203,41 @@ plMsgWrap* plDispatch::IDequeue(plMsgWrap** head, plMsgWrap** tail)
 
 bool plDispatch::ISortToDeferred(plMessage* msg)
 {
+    plProfile_BeginTiming(DeferredInsert);
+
     plMsgWrap* msgWrap = new plMsgWrap(msg);
-    if( !fFutureMsgQueue )
-    {
-        if( IGetOwner() )
-            plgDispatch::Dispatch()->RegisterForExactType(plTimeMsg::Index(), IGetOwnerKey());
+    msgWrap->fSequence = fFutureMsgSequence++;
 
-        IInsertToQueue(&fFutureMsgQueue, msgWrap);
-        return false;
-    }
-    if( fFutureMsgQueue->fMsg->fTimeStamp > msgWrap->fMsg->fTimeStamp )
-    {
-        IInsertToQueue(&fFutureMsgQueue, msgWrap);
-        return false;
-    }
-    plMsgWrap* after = fFutureMsgQueue;
-    while( after->fNext && (after->fNext->fMsg->fTimeStamp < msgWrap->fMsg->fTimeStamp) )
-        after = after->fNext;
+    if (fFutureMsgQueue.empty() && IGetOwner())
+        plgDispatch::Dispatch()->RegisterForExactType(plTimeMsg::Index(), IGetOwnerKey());
+
+    fFutureMsgQueue.push_back(msgWrap);
+    std::push_heap(fFutureMsgQueue.begin(), fFutureMsgQueue.end(), DeferredFiresAfter);
 
-    IInsertToQueue(&after->fNext, msgWrap);
+    plProfile_Inc(DeferredInserts);
+    plProfile_Inc(DeferredDepth);
+    plProfile_EndTiming(DeferredInsert);
 
     return false;
 }
 
 void plDispatch::ICheckDeferred(double secs)
 {
-    while( fFutureMsgQueue && (fFutureMsgQueue->fMsg->fTimeStamp < secs) )
+    while (!fFutureMsgQueue.empty() && (fFutureMsgQueue.front()->fMsg->fTimeStamp < secs))
     {
-        plMsgWrap* send = IDequeue(&fFutureMsgQueue, nullptr);
+        // Pop before sending, the receivers may well defer more messages on us.
+        std::pop_heap(fFutureMsgQueue.begin(), fFutureMsgQueue.end(), DeferredFiresAfter);
+        plMsgWrap* send = fFutureMsgQueue.back();
+        fFutureMsgQueue.pop_back();
+        plProfile_Dec(DeferredDepth);
+
         MsgSend(send->fMsg);
         delete send;
     }
 
     uint16_t timeIdx = plTimeMsg::Index();
     if( IGetOwner()
-        && !fFutureMsgQueue 
+        && fFutureMsgQueue.empty()
         && 
             ( 
                 (timeIdx >= fRegisteredExactTypes.size())
@@ -227,7 +250,7 @@ void plDispatch::ICheckDeferred(double secs)
 
 bool plDispatch::IListeningForExactType(uint16_t hClass)
 {
-    if( (hClass == plTimeMsg::Index()) && fFutureMsgQueue )
+    if( (hClass == plTimeMsg::Index()) && !fFutureMsgQueue.empty() )
         return true;
 
     return false;
@@ -45,6 +45,7 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 
 #include <list>
 #include <mutex>
+#include <vector>
 #include "plgDispatch.h"
 #include "hsThread.h"
 #include "pnKeyedObject/hsKeyedObject.h"
@@ -71,7 +72,8 @@ protected:
 
     hsKeyedObject*                  fOwner;
 
-    plMsgWrap*                      fFutureMsgQueue;
+    std::vector<plMsgWrap*>         fFutureMsgQueue;    // min-heap on (timestamp, sequence)
+    uint32_t                        fFutureMsgSequence; // keeps equal timestamps in send order
     static int32_t                  fNumBufferReq;
     static plMsgWrap*               fMsgCurrent;
     static std::mutex               fMsgCurrentMutex; // mutex for above
@@ -84,16 +84,11 @@ static void Rc4Codec (
     unsigned        bytes,
     void *          data
 ) {
-    // RC4 uses the same algorithm to both encrypt and decrypt
-    uint8_t * temp = (uint8_t *)malloc(bytes);
-
+    // RC4 uses the same algorithm to both encrypt and decrypt, and OpenSSL
+    // allows the input and output to be the same buffer.
     IGNORE_WARNINGS_BEGIN("deprecated-declarations")
-    RC4((RC4_KEY *)key->handle, bytes, (const unsigned char *)data, temp);
+    RC4((RC4_KEY *)key->handle, bytes, (const unsigned char *)data, (unsigned char *)data);
     IGNORE_WARNINGS_END
-
-    memcpy(data, temp, bytes);
-
-    free(temp);
 }
 
 } using namespace Crypt;
@@ -0,0 +1,106 @@
+/*==LICENSE==*
+
+CyanWorlds.com Engine - MMOG client, server and tools
+Copyright (C) 2011  Cyan Worlds, Inc.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Additional permissions under GNU GPL version 3 section 7
+
+If you modify this Program, or any covered work, by linking or
+combining it with any of RAD Game Tools Bink SDK, Autodesk 3ds Max SDK,
+NVIDIA PhysX SDK, Microsoft DirectX SDK, OpenSSL library, Independent
+JPEG Group JPEG library, Microsoft Windows Media SDK, or Apple QuickTime SDK
+(or a modified version of those libraries),
+containing parts covered by the terms of the Bink SDK EULA, 3ds Max EULA,
+PhysX SDK EULA, DirectX SDK EULA, OpenSSL and SSLeay licenses, IJG
+JPEG Library README, Windows Media SDK EULA, or QuickTime SDK EULA, the
+licensors of this Program grant you additional
+permission to convey the resulting work. Corresponding Source for a
+non-source form of such a combination shall include the source code for
+the parts of OpenSSL and IJG JPEG Library used as well as that of the covered
+work.
+
+You can contact Cyan Worlds, Inc. by email legal@cyan.com
+ or by snail mail at:
+      Cyan Worlds, Inc.
+      14617 N Newport Hwy
+      Mead, WA   99021
+
+*==LICENSE==*/
+
+#include "plMessagePool.h"
+
+#include "HeadSpin.h"
+#include "hsLockGuard.h"
+#include "plProfile.h"
+
+#include <new>
+
+plProfile_CreateCounter("Pooled Allocs", "Message", MsgPoolAllocs);
+plProfile_CreateCounter("Pool Heap Allocs", "Message", MsgPoolHeapAllocs);
+
+plMessagePool::plMessagePool(size_t blockSize, size_t maxFree)
+    : fFree(), fBlockSize(blockSize), fNumFree(), fMaxFree(maxFree)
+{
+    hsAssert(blockSize >= sizeof(FreeBlock), "plMessagePool block too small to recycle");
+}
+
+plMessagePool::~plMessagePool()
+{
+    while (fFree) {
+        FreeBlock* block = fFree;
+        fFree = block->fNext;
+        ::operator delete(block);
+    }
+}
+
+void* plMessagePool::Alloc(size_t size)
+{
+    {
+        // The profile counters are only safe to touch under the lock
+        hsLockGuard(fMutex);
+        if (size == fBlockSize) {
+            plProfile_Inc(MsgPoolAllocs);
+            if (fFree) {
+                FreeBlock* block = fFree;
+                fFree = block->fNext;
+                --fNumFree;
+                return block;
+            }
+        }
+        plProfile_Inc(MsgPoolHeapAllocs);
+    }
+
+    return ::operator new(size);
+}
+
+void plMessagePool::Free(void* ptr, size_t size)
+{
+    if (!ptr)
+        return;
+
+    if (size == fBlockSize) {
+        hsLockGuard(fMutex);
+        if (fNumFree < fMaxFree) {
+            FreeBlock* block = static_cast<FreeBlock*>(ptr);
+            block->fNext = fFree;
+            fFree = block;
+            ++fNumFree;
+            return;
+        }
+    }
+
+    ::operator delete(ptr);
+}
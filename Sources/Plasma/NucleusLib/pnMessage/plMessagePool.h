@@ -0,0 +1,95 @@
+/*==LICENSE==*
+
+CyanWorlds.com Engine - MMOG client, server and tools
+Copyright (C) 2011  Cyan Worlds, Inc.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Additional permissions under GNU GPL version 3 section 7
+
+If you modify this Program, or any covered work, by linking or
+combining it with any of RAD Game Tools Bink SDK, Autodesk 3ds Max SDK,
+NVIDIA PhysX SDK, Microsoft DirectX SDK, OpenSSL library, Independent
+JPEG Group JPEG library, Microsoft Windows Media SDK, or Apple QuickTime SDK
+(or a modified version of those libraries),
+containing parts covered by the terms of the Bink SDK EULA, 3ds Max EULA,
+PhysX SDK EULA, DirectX SDK EULA, OpenSSL and SSLeay licenses, IJG
+JPEG Library README, Windows Media SDK EULA, or QuickTime SDK EULA, the
+licensors of this Program grant you additional
+permission to convey the resulting work. Corresponding Source for a
+non-source form of such a combination shall include the source code for
+the parts of OpenSSL and IJG JPEG Library used as well as that of the covered
+work.
+
+You can contact Cyan Worlds, Inc. by email legal@cyan.com
+ or by snail mail at:
+      Cyan Worlds, Inc.
+      14617 N Newport Hwy
+      Mead, WA   99021
+
+*==LICENSE==*/
+
+#ifndef plMessagePool_inc
+#define plMessagePool_inc
+
+#include <cstddef>
+#include <mutex>
+
+// Thread-safe free list for small objects that get created and thrown away
+// every frame (per-frame time messages, dispatch wrappers).  Blocks are only
+// recycled when the requested size matches the pool's block size, so a
+// pooled class whose subclasses add members still works; the subclasses
+// just go straight to the heap.
+class plMessagePool
+{
+protected:
+    struct FreeBlock { FreeBlock* fNext; };
+
+    std::mutex  fMutex;
+    FreeBlock*  fFree;
+    size_t      fBlockSize;
+    size_t      fNumFree;
+    size_t      fMaxFree;
+
+public:
+    plMessagePool(size_t blockSize, size_t maxFree = kDefaultMaxFree);
+    ~plMessagePool();
+
+    plMessagePool(const plMessagePool&) = delete;
+    plMessagePool& operator=(const plMessagePool&) = delete;
+
+    void*   Alloc(size_t size);
+    void    Free(void* ptr, size_t size);
+
+    static constexpr size_t kDefaultMaxFree = 256;
+};
+
+// Opt-in pooled allocation for a message class.  Put PLMESSAGE_POOLED in the
+// class declaration and PLMESSAGE_POOLED_IMPL in its .cpp.  The sized delete
+// gets the dynamic size through the virtual destructor, so it is safe to
+// delete through a plMessage pointer (which is what hsRefCnt::UnRef does).
+#define PLMESSAGE_POOLED()                                                  \
+    static plMessagePool& IGetPool();                                       \
+    static void* operator new(size_t size) { return IGetPool().Alloc(size); } \
+    static void operator delete(void* ptr, size_t size) { IGetPool().Free(ptr, size); }
+
+#define PLMESSAGE_POOLED_IMPL(classname)                                    \
+    plMessagePool& classname::IGetPool()                                    \
+    {                                                                       \
+        /* Never destroyed: messages can outlive static teardown */         \
+        static plMessagePool* pool = new plMessagePool(sizeof(classname));  \
+        return *pool;                                                       \
+    }
+
+#endif // plMessagePool_inc
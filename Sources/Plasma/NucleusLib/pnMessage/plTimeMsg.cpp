@@ -46,6 +46,10 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 #include "hsStream.h"
 #include "hsTimer.h"
 
+PLMESSAGE_POOLED_IMPL(plTimeMsg);
+PLMESSAGE_POOLED_IMPL(plEvalMsg);
+PLMESSAGE_POOLED_IMPL(plTransformMsg);
+
 plTimeMsg::plTimeMsg()
 : plMessage(nullptr, nullptr, nullptr), fSeconds(), fDelSecs()
 {
@@ -95,6 +99,8 @@ plEvalMsg::~plEvalMsg()
 {
 }
 
+uint32_t plTransformMsg::fNumBCast = 0;
+
 plTransformMsg::plTransformMsg()
 {
 }
@@ -105,8 +111,17 @@ plTransformMsg::plTransformMsg(const plKey &s,
 : plTimeMsg(s, r, t, d)
 {
     SetBCastFlag(plMessage::kClearAfterBCast);
+    ++fNumBCast;
 }
 
 plTransformMsg::~plTransformMsg()
 {
+}
+
+uint32_t plDelayedTransformMsg::fNumDelayedBCast = 0;
+
+plDelayedTransformMsg::plDelayedTransformMsg(const plKey &s, const plKey &r, const double* t, const float* del)
+: plTransformMsg(s, r, t, del)
+{
+    ++fNumDelayedBCast;
 }
\ No newline at end of file
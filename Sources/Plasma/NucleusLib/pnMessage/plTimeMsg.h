@@ -44,6 +44,7 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 #define plTimeMsg_inc
 
 #include "plMessage.h"
+#include "plMessagePool.h"
 
 class plTimeMsg : public plMessage
 {
@@ -60,6 +61,7 @@ public:
 
     CLASSNAME_REGISTER(plTimeMsg);
     GETINTERFACE_ANY(plTimeMsg, plMessage);
+    PLMESSAGE_POOLED();
 
     plTimeMsg& SetSeconds(double s) { fSeconds = s; return *this; }
     plTimeMsg& SetDelSeconds(float d) { fDelSecs = d; return *this; }
@@ -83,6 +85,7 @@ public:
 
     CLASSNAME_REGISTER(plEvalMsg);
     GETINTERFACE_ANY(plEvalMsg, plTimeMsg);
+    PLMESSAGE_POOLED();
 
     // IO
     void Read(hsStream* stream, hsResMgr* mgr) override {
@@ -96,6 +99,9 @@ public:
 
 class plTransformMsg : public plTimeMsg
 {
+protected:
+    static uint32_t fNumBCast;
+
 public:
     plTransformMsg();
     plTransformMsg(const plKey &s, 
@@ -105,6 +111,12 @@ public:
 
     CLASSNAME_REGISTER(plTransformMsg);
     GETINTERFACE_ANY(plTransformMsg, plTimeMsg);
+    PLMESSAGE_POOLED();
+
+    // Bumped for each of these created to be broadcast. The broadcast clears all
+    // registrations for the type, so anyone registered at an older count no
+    // longer is, whether or not the message actually reached them.
+    static uint32_t GetNumBCast() { return fNumBCast; }
 
     // IO
     void Read(hsStream* stream, hsResMgr* mgr) override {
@@ -120,12 +132,17 @@ public:
 // it's broadcast.
 class plDelayedTransformMsg : public plTransformMsg
 {
+protected:
+    static uint32_t fNumDelayedBCast;
+
 public:
     plDelayedTransformMsg() : plTransformMsg() {}
-    plDelayedTransformMsg(const plKey &s, const plKey &r, const double* t, const float* del) : plTransformMsg(s, r, t, del) {}
+    plDelayedTransformMsg(const plKey &s, const plKey &r, const double* t, const float* del);
 
     CLASSNAME_REGISTER(plDelayedTransformMsg);
     GETINTERFACE_ANY(plDelayedTransformMsg, plTransformMsg);
+
+    static uint32_t GetNumBCast() { return fNumDelayedBCast; }
 };
 
 #endif // plTimeMsg_inc
@@ -172,10 +172,9 @@ namespace pnNetCli {
 ***/
 
 //============================================================================
+// Encrypts data in place, so callers must hand over a buffer they own.
 static void PutBufferOnWire (NetCli * cli, void * data, unsigned bytes) {
 
-    uint8_t * temp = nullptr;
-
 #if !defined(PLASMA_EXTERNAL_RELEASE) && defined(HS_BUILD_FOR_WIN32)
     // Write to the netlog
     if (s_netlog) {
@@ -192,18 +191,10 @@ static void PutBufferOnWire (NetCli * cli, void * data, unsigned bytes) {
     }
 #endif // PLASMA_EXTERNAL_RELEASE
 
-    if (cli->mode == kNetCliModeEncrypted && cli->cryptOut) {
-        temp = (uint8_t *)malloc(bytes);
-
-        memcpy(temp, data, bytes);
-        CryptEncrypt(cli->cryptOut, bytes, temp);
-        data = temp;
-    }
+    if (cli->mode == kNetCliModeEncrypted && cli->cryptOut)
+        CryptEncrypt(cli->cryptOut, bytes, data);
     if (cli->sock)
         AsyncSocketSend(cli->sock, data, bytes);
-        
-    // free heap buffer (if any)
-    free(temp);
 }
 
 //============================================================================
@@ -238,8 +229,7 @@ static void AddToSendBuffer (
             unsigned const copy = std::min(bytes, left);
 
             // copy the data into the buffer
-            for (unsigned i = 0; i < copy; ++i)
-                cli->sendCurr[i] = src[i];
+            memcpy(cli->sendCurr, src, copy);
             cli->sendCurr += copy;
             ASSERT(cli->sendCurr - cli->sendBuffer <= sizeof(cli->sendBuffer));
 
@@ -915,7 +905,7 @@ void NetCliSend (
 //============================================================================
 bool NetCliDispatch (
     NetCli *        cli,
-    const uint8_t      data[],
+    uint8_t         data[],
     unsigned        bytes,
     void *          param
 ) {
@@ -924,16 +914,9 @@ bool NetCliDispatch (
 
     do {
         if (cli->mode == kNetCliModeEncrypted) {
-            // Decrypt data...
-            uint8_t * temp = nullptr;
-
-            if (cli->cryptIn) {
-                temp = (uint8_t *)malloc(bytes);
-
-                memcpy(temp, data, bytes);
-                CryptDecrypt(cli->cryptIn, bytes, temp);
-                data = temp;
-            }
+            // Decrypt data in the socket's own buffer
+            if (cli->cryptIn)
+                CryptDecrypt(cli->cryptIn, bytes, data);
 
             // Add data to accumulator and dispatch
             cli->input.Add(bytes, data);
@@ -955,9 +938,6 @@ bool NetCliDispatch (
             }
 #endif // PLASMA_EXTERNAL_RELEASE
 
-            // free heap buffer (if any)
-            free(temp);
-
             cli->input.Compact();
             return cli->recvDispatch;
         }
@@ -333,9 +333,10 @@ void NetCliSend (
     unsigned            count
 );
 
+// The buffer is decrypted in place, so its contents are undefined afterwards
 bool NetCliDispatch (
     NetCli *        cli,
-    const uint8_t      buffer[],
+    uint8_t         buffer[],
     unsigned        bytes,
     void *          param
 );
@@ -51,6 +51,7 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 #include "pnMessage/plIntRefMsg.h"
 #include "pnNetCommon/plSDLTypes.h"
 #include "plSceneObject.h"
+#include "plTransformHierarchy.h"
 #include "hsResMgr.h"
 #include "plgDispatch.h"
 #include "pnKeyedObject/plKey.h"
@@ -64,7 +65,10 @@ bool plCoordinateInterface::fDelayedTransformsEnabled = true;
 
 plCoordinateInterface::plCoordinateInterface()
 : fParent(),
-  fReason(kReasonUnknown)
+  fReason(kReasonUnknown),
+  fTransformRegistration(),
+  fDelayedTransformRegistration(),
+  fHierarchyIndex()
 {
     fLocalToParent.Reset();
     fParentToLocal.Reset();
@@ -95,14 +99,24 @@ void plCoordinateInterface::ISetSceneNode(const plKey& newNode)
 void plCoordinateInterface::ISetOwner(plSceneObject* so)
 {
     plObjInterface::ISetOwner(so);
-    
+    IInvalidateHierarchy();
+
+    // Any registration we had was for the old owner's key
+    fState &= ~(kRegisteredTransform | kRegisteredDelayedTransform);
     IDirtyTransform();
     fReason |= kReasonUnknown;
 }
 
 void plCoordinateInterface::ISetParent(plCoordinateInterface* par)
 {
+    IInvalidateHierarchy();
     fParent = par;
+    IInvalidateHierarchy();
+
+    // Not a root any more. One that's in the middle of a pass stays around
+    // (marked stale) until the pass is done with it.
+    if (fParent && fHierarchy && !fHierarchy->IsBusy())
+        fHierarchy.reset();
 
     // This won't have any effect if my owner is NetGroupConstant
     if( fParent )
@@ -126,6 +140,7 @@ void plCoordinateInterface::IRemoveChild(size_t i)
             childCI->ISetParent(nullptr);
     }
     fChildren.erase(fChildren.begin() + i);
+    IInvalidateHierarchy();
 }
 
 void plCoordinateInterface::IRemoveChild(plSceneObject* child)
@@ -147,6 +162,7 @@ void plCoordinateInterface::ISetChild(plSceneObject* child, hsSsize_t which)
     if (size_t(which + 1) > fChildren.size())
         fChildren.resize(which + 1);
     fChildren[which] = child;
+    IInvalidateHierarchy();
 
     // If we can't delay our transform update, neither can any of our parents.
     if (!childCI->GetProperty(kDelayedTransformEval))
@@ -257,19 +273,52 @@ plCoordinateInterface* plCoordinateInterface::IGetRoot()
     return fParent ? fParent->IGetRoot() : this;
 }
 
+plTransformHierarchy* plCoordinateInterface::IGetHierarchy()
+{
+    if (!fHierarchy)
+        fHierarchy = std::make_unique<plTransformHierarchy>(this, true);
+    return fHierarchy.get();
+}
+
+void plCoordinateInterface::IInvalidateHierarchy()
+{
+    for (plCoordinateInterface* ci = this; ci; ci = ci->fParent)
+    {
+        if (ci->fHierarchy)
+            ci->fHierarchy->Invalidate();
+    }
+}
+
 void plCoordinateInterface::IRegisterForTransformMessage(bool delayed)
 {
     if( IGetOwner() )
     {
+        // Every dirtied transform in the hierarchy lands here, and the dispatcher
+        // does a linear search of its receivers for each registration, so only
+        // go to it once per message. The messages are kClearAfterBCast, so once
+        // another one has been created our registration is as good as gone,
+        // even if it never made it to us.
         if ((delayed || fTransformPhase == kTransformPhaseDelayed) && fDelayedTransformsEnabled)
-            plgDispatch::Dispatch()->RegisterForExactType(plDelayedTransformMsg::Index(), IGetOwner()->GetKey());
-        else
+        {
+            if( !(fState & kRegisteredDelayedTransform) || fDelayedTransformRegistration != plDelayedTransformMsg::GetNumBCast() )
+            {
+                fState |= kRegisteredDelayedTransform;
+                fDelayedTransformRegistration = plDelayedTransformMsg::GetNumBCast();
+                plgDispatch::Dispatch()->RegisterForExactType(plDelayedTransformMsg::Index(), IGetOwner()->GetKey());
+            }
+        }
+        else if( !(fState & kRegisteredTransform) || fTransformRegistration != plTransformMsg::GetNumBCast() )
+        {
+            fState |= kRegisteredTransform;
+            fTransformRegistration = plTransformMsg::GetNumBCast();
             plgDispatch::Dispatch()->RegisterForExactType(plTransformMsg::Index(), IGetOwner()->GetKey());
+        }
     }
 }
 
 void plCoordinateInterface::IUnRegisterForTransformMessage()
 {
+    fState &= ~kRegisteredTransform;
     if( IGetOwner() )
         plgDispatch::Dispatch()->UnRegisterForExactType(plTransformMsg::Index(), IGetOwner()->GetKey());
 }
@@ -279,7 +328,16 @@ void plCoordinateInterface::IDirtyTransform()
 {
     fState |= kTransformDirty;
 
-    IGetRoot()->IRegisterForTransformMessage(GetProperty(kDelayedTransformEval));
+    // Mark the path up to the root, so the transform pass only walks down into
+    // the parts of the hierarchy that actually changed.
+    plCoordinateInterface* root = this;
+    while (root->fParent)
+    {
+        root = root->fParent;
+        root->fState |= kChildTransformDirty;
+    }
+
+    root->IRegisterForTransformMessage(GetProperty(kDelayedTransformEval));
 }
 
 void plCoordinateInterface::MultTransformLocal(const hsMatrix44& move, const hsMatrix44& invMove)
@@ -333,6 +391,12 @@ uint16_t plCoordinateInterface::GetReasons()
 void plCoordinateInterface::ClearReasons()
 {
     fReason = 0;
+
+    // Transform passes only walk down into marked subtrees, so make sure the
+    // next one gets here to merge our parent's reasons back in.
+    fState |= kReasonsPending;
+    for (plCoordinateInterface* parent = fParent; parent; parent = parent->fParent)
+        parent->fState |= kChildTransformDirty;
 }
 
 void plCoordinateInterface::SetLocalToParent(const hsMatrix44& l2p, const hsMatrix44& p2l)
@@ -369,15 +433,9 @@ void plCoordinateInterface::WarpToWorld(const hsMatrix44& l2w, const hsMatrix44&
     }
 }
 
-plProfile_CreateCounter("CITrans", "Object", CITrans);
 plProfile_CreateCounter("   CIRecalc", "Object", CIRecalc);
-plProfile_CreateCounter("   CIDirty", "Object", CIDirty);
-plProfile_CreateCounter("   CISet", "Object", CISet);
 
-plProfile_CreateTimer("CITransT", "Object", CITransT);
 plProfile_CreateTimer("   CIRecalcT", "Object", CIRecalcT);
-plProfile_CreateTimer("   CIDirtyT", "Object", CIDirtyT);
-plProfile_CreateTimer("   CISetT", "Object", CISetT);
 
 void plCoordinateInterface::IRecalcTransforms()
 {
@@ -398,56 +456,8 @@ void plCoordinateInterface::IRecalcTransforms()
 
 void plCoordinateInterface::ITransformChanged(bool force, uint16_t reasons, bool checkForDelay)
 {
-    plProfile_IncCount(CITrans, 1);
-    plProfile_BeginTiming(CITransT);
-
-    // inherit reasons for transform change from our parents
-    fReason |= reasons;
-    
-    uint16_t propagateReasons = fReason;
-
-    bool process = !(checkForDelay && GetProperty(kDelayedTransformEval)) || !fDelayedTransformsEnabled;
-
-    if (process)
-    {
-        if( fState & kTransformDirty )
-            force = true;
-    }
-
-    if( force )
-    {
-        IRecalcTransforms();
-
-        plProfile_IncCount(CISet, 1);
-        plProfile_BeginTiming(CISetT);
-        if( IGetOwner() )
-        {
-            IGetOwner()->ISetTransform(fLocalToWorld, fWorldToLocal);
-        }
-        plProfile_EndTiming(CISetT);
-        fState &= ~kTransformDirty;     
-    }
-
-    plProfile_EndTiming(CITransT);
-    if (process)
-    {
-        for (plSceneObject* child : fChildren)
-        {
-            if (child && child->GetVolatileCoordinateInterface())
-                child->GetVolatileCoordinateInterface()->ITransformChanged(force, propagateReasons, checkForDelay);
-        }
-    }
-    else if (force)
-    {
-        plProfile_IncCount(CIDirty, 1);
-        plProfile_BeginTiming(CITransT);
-        // Our parent is dirty and we're bailing out on evaluating right now.
-        // Need to ensure we'll be evaluated in the delay pass
-        plProfile_BeginTiming(CIDirtyT);
-        IDirtyTransform();
-        plProfile_EndTiming(CIDirtyT);
-        plProfile_EndTiming(CITransT);
-    }       
+    // Done on our root's flattened copy of the hierarchy; see plTransformHierarchy
+    plTransformHierarchy::Update(this, force, reasons, checkForDelay);
 }
 
 void plCoordinateInterface::FlushTransform(bool fromRoot)
@@ -47,8 +47,11 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 #include "plObjInterface.h"
 #include "hsMatrix44.h"
 
+#include <memory>
+
 class hsStream;
 class hsResMgr;
+class plTransformHierarchy;
 
 
 class plCoordinateInterface : public plObjInterface
@@ -73,6 +76,10 @@ protected:
     enum {
         kTransformDirty     = 0x1,
         kWarp               = 0x2,
+        kChildTransformDirty        = 0x4,  // something below us is dirty, transform passes need to walk down
+        kRegisteredTransform        = 0x8,  // registered for the plTransformMsg numbered fTransformRegistration
+        kRegisteredDelayedTransform = 0x10, // registered for the plDelayedTransformMsg numbered fDelayedTransformRegistration
+        kReasonsPending             = 0x20, // we or our children are missing reasons, the next pass needs to visit us
 
         kMaxState           = 0xffff
     };
@@ -97,6 +104,9 @@ protected:
     uint16_t                                fState;
     uint16_t                                fReason;        // why we've changed position (if we have)
 
+    uint32_t                                fTransformRegistration;         // plTransformMsg::GetNumBCast() when we registered
+    uint32_t                                fDelayedTransformRegistration;  // plDelayedTransformMsg::GetNumBCast() when we registered
+
     std::vector<plSceneObject*>             fChildren;
     plCoordinateInterface*                  fParent;    // if this changes, marks us as dirty
 
@@ -106,6 +116,9 @@ protected:
     hsMatrix44                              fLocalToWorld;
     hsMatrix44                              fWorldToLocal;
 
+    std::unique_ptr<plTransformHierarchy>   fHierarchy;         // only on roots, built on first use
+    uint32_t                                fHierarchyIndex;    // where we were in our root's, last it looked
+
     void ISetOwner(plSceneObject* so) override;
 
     virtual void ISetParent(plCoordinateInterface* par); // don't use, use AddChild on parent
@@ -125,14 +138,18 @@ protected:
     virtual void IUpdateDelayProp(); // Called whenever a child is added/removed
 
     virtual void IRecalcTransforms(); // Called by ITransformChanged when we need to re-examine our relationship with our parent.
+    virtual bool IHasCustomRecalc() const { return false; } // true if IRecalcTransforms() isn't just parent times local
     virtual void ITransformChanged(bool force, uint16_t reasons, bool checkForDelay); // called by SceneObject on TransformChanged messsage
 
     void                    IDirtyTransform();
     void                    IRegisterForTransformMessage(bool delayed);
     void                    IUnRegisterForTransformMessage();
     plCoordinateInterface*  IGetRoot();
+    plTransformHierarchy*   IGetHierarchy();
+    void                    IInvalidateHierarchy();
 
     friend class plSceneObject;
+    friend class plTransformHierarchy;
 
 public:
     plCoordinateInterface();
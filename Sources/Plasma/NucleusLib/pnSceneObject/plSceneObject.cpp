@@ -45,6 +45,7 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 #include "plDrawInterface.h"
 #include "plSimulationInterface.h"
 #include "plCoordinateInterface.h"
+#include "plTransformHierarchy.h"
 #include "plAudioInterface.h"
 #include "pnDispatch/plDispatch.h"
 #include "pnFactory/plFactory.h"
@@ -474,8 +475,8 @@ bool plSceneObject::MsgReceive(plMessage* msg)
     {
         if( fCoordinateInterface )
         {
-            // flush any dirty transforms
-            fCoordinateInterface->ITransformChanged(false, 0, trans->ClassIndex() == plTransformMsg::Index());
+            // flush any dirty transforms, along with everybody else's when the client is batching them
+            plTransformHierarchy::QueueUpdate(fCoordinateInterface, trans->ClassIndex() == plTransformMsg::Index());
         }
         return true;
     }
@@ -80,6 +80,7 @@ class plSceneObject : public plSynchedObject {
 
     friend class plModifier;
     friend class plCoordinateInterface;
+    friend class plTransformHierarchy;
     friend class plObjInterface;
     friend class plMaxNode;
     friend class plMaxNodeBase;
@@ -0,0 +1,522 @@
+/*==LICENSE==*
+
+CyanWorlds.com Engine - MMOG client, server and tools
+Copyright (C) 2011  Cyan Worlds, Inc.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Additional permissions under GNU GPL version 3 section 7
+
+If you modify this Program, or any covered work, by linking or
+combining it with any of RAD Game Tools Bink SDK, Autodesk 3ds Max SDK,
+NVIDIA PhysX SDK, Microsoft DirectX SDK, OpenSSL library, Independent
+JPEG Group JPEG library, Microsoft Windows Media SDK, or Apple QuickTime SDK
+(or a modified version of those libraries),
+containing parts covered by the terms of the Bink SDK EULA, 3ds Max EULA,
+PhysX SDK EULA, DirectX SDK EULA, OpenSSL and SSLeay licenses, IJG
+JPEG Library README, Windows Media SDK EULA, or QuickTime SDK EULA, the
+licensors of this Program grant you additional
+permission to convey the resulting work. Corresponding Source for a
+non-source form of such a combination shall include the source code for
+the parts of OpenSSL and IJG JPEG Library used as well as that of the covered
+work.
+
+You can contact Cyan Worlds, Inc. by email legal@cyan.com
+ or by snail mail at:
+      Cyan Worlds, Inc.
+      14617 N Newport Hwy
+      Mead, WA   99021
+
+*==LICENSE==*/
+
+#include "HeadSpin.h"
+#include "plTransformHierarchy.h"
+#include "plCoordinateInterface.h"
+#include "plSceneObject.h"
+#include "hsMatrixMath.h"
+#include "hsWorkerPool.h"
+
+#include "plProfile.h"
+
+#include <algorithm>
+#include <thread>
+
+plProfile_CreateCounter("CITrans", "Object", CITrans);
+plProfile_CreateCounter("   CIDirty", "Object", CIDirty);
+plProfile_CreateCounter("   CISet", "Object", CISet);
+plProfile_CreateCounter("   CISkipped", "Object", CISkipped);
+plProfile_CreateCounter("   CIQueued", "Object", CIQueued);
+
+plProfile_CreateTimer("CITransT", "Object", CITransT);
+plProfile_CreateTimer("   CIDirtyT", "Object", CIDirtyT);
+plProfile_CreateTimer("   CISetT", "Object", CISetT);
+
+plProfile_Extern(CIRecalc);
+plProfile_Extern(CIRecalcT);
+
+uint32_t plTransformHierarchy::fUpdateThreads = 1;
+
+// Don't bother waking the workers for less than this many recalculated nodes per thread
+static constexpr size_t kMinRecalcsPerThread = 256;
+
+static std::vector<plTransformHierarchy*> s_updateQueue;
+static bool s_queueOpen = false;
+
+static hsWorkerPool& GetTransformPool()
+{
+    static hsWorkerPool s_pool;
+    return s_pool;
+}
+
+plTransformHierarchy::plTransformHierarchy(plCoordinateInterface* top, bool owned)
+    : fTop(top), fOwned(owned), fValid(), fPlanned(), fApplying(), fQueued(),
+      fQueuedCheckForDelay(), fCheckForDelay(), fTopHasParent(), fBegin(), fEnd(),
+      fStartReasons()
+{
+}
+
+plTransformHierarchy::~plTransformHierarchy()
+{
+    if (fQueued)
+        std::replace(s_updateQueue.begin(), s_updateQueue.end(), this, (plTransformHierarchy*)nullptr);
+}
+
+//// Topology ////////////////////////////////////////////////////////////////
+
+void plTransformHierarchy::IBuild()
+{
+    fNodes.clear();
+    fParents.clear();
+    fSubtreeEnds.clear();
+    IAddNode(fTop, -1);
+
+    size_t count = fNodes.size();
+    fLocalToParent.resize(count);
+    fParentToLocal.resize(count);
+    fLocalToWorld.resize(count);
+    fWorldToLocal.resize(count);
+    fFlags.assign(count, 0);
+    fReasons.resize(count);
+
+    fValid = true;
+    fPlanned = false;
+}
+
+void plTransformHierarchy::IAddNode(plCoordinateInterface* node, int32_t parent)
+{
+    uint32_t index = (uint32_t)fNodes.size();
+    fNodes.push_back(node);
+    fParents.push_back(parent);
+    fSubtreeEnds.push_back(0);
+    if (fOwned)
+        node->fHierarchyIndex = index;
+
+    for (plSceneObject* child : node->fChildren)
+    {
+        plCoordinateInterface* childCI = child ? child->GetVolatileCoordinateInterface() : nullptr;
+        if (childCI)
+            IAddNode(childCI, (int32_t)index);
+    }
+    fSubtreeEnds[index] = (uint32_t)fNodes.size();
+}
+
+//// Plan ////////////////////////////////////////////////////////////////////
+//  Works out what the recursive walk would have done for the subtree at
+//  begin, without changing anything on the nodes. Returns how many nodes
+//  ICompute() has to do.
+
+size_t plTransformHierarchy::IPlan(size_t begin, bool force, uint16_t reasons, bool checkForDelay)
+{
+    fBegin = begin;
+    fEnd = fSubtreeEnds[begin];
+    fStartReasons = reasons;
+    fCheckForDelay = checkForDelay;
+    std::fill(fFlags.begin() + fBegin, fFlags.begin() + fEnd, 0);
+
+    plCoordinateInterface* topParent = fNodes[fBegin]->fParent;
+    fTopHasParent = topParent != nullptr;
+    if (topParent)
+    {
+        fTopParentToWorld = topParent->GetLocalToWorld();
+        fWorldToTopParent = topParent->GetWorldToLocal();
+    }
+
+    bool delayEnabled = plCoordinateInterface::fDelayedTransformsEnabled;
+    size_t numCompute = 0;
+    for (size_t i = fBegin; i < fEnd; )
+    {
+        plCoordinateInterface* ci = fNodes[i];
+
+        bool forceIn = force;
+        uint16_t reasonsIn = reasons;
+        bool parentSerial = false;
+        if (i != fBegin)
+        {
+            // Only processed nodes walk down into their children
+            int32_t parent = fParents[i];
+            if ((fFlags[parent] & (kVisit | kProcess)) != (kVisit | kProcess))
+            {
+                i = fSubtreeEnds[i];
+                continue;
+            }
+
+            forceIn = (fFlags[parent] & kRecalc) != 0;
+            reasonsIn = fReasons[parent];
+            parentSerial = (fFlags[parent] & kSerial) != 0;
+
+            // If the parent isn't forcing us, we only have work to do if we're
+            // dirty (or have something dirty below us), or are missing some of
+            // its reasons. A visit leaves a subtree holding all of its parent's
+            // reasons, and anything that spoils that is marked kReasonsPending,
+            // so a clean child that already has our reasons has nothing below
+            // it to update either.
+            if (!forceIn &&
+                !(ci->fState & (plCoordinateInterface::kTransformDirty |
+                                plCoordinateInterface::kChildTransformDirty |
+                                plCoordinateInterface::kReasonsPending)) &&
+                !(reasonsIn & ~ci->fReason))
+            {
+                plProfile_Inc(CISkipped);
+                i = fSubtreeEnds[i];
+                continue;
+            }
+        }
+
+        uint8_t flags = kVisit;
+        bool process = !(checkForDelay && ci->GetProperty(plCoordinateInterface::kDelayedTransformEval)) || !delayEnabled;
+        if (process)
+            flags |= kProcess;
+
+        if (forceIn || (process && (ci->fState & plCoordinateInterface::kTransformDirty)))
+        {
+            flags |= kRecalc;
+            if (parentSerial || ci->IHasCustomRecalc())
+                flags |= kSerial;
+            else
+            {
+                fLocalToParent[i] = ci->fLocalToParent;
+                fParentToLocal[i] = ci->fParentToLocal;
+                numCompute++;
+            }
+        }
+        else
+        {
+            // Our children read their parent's transforms from here
+            fLocalToWorld[i] = ci->fLocalToWorld;
+            fWorldToLocal[i] = ci->fWorldToLocal;
+        }
+
+        fReasons[i] = ci->fReason | reasonsIn;
+        fFlags[i] = flags;
+        i++;
+    }
+
+    return numCompute;
+}
+
+//// Compute /////////////////////////////////////////////////////////////////
+//  Parents come before their children, so this is one pass straight through
+//  the arrays. Touches nothing else, so it's safe on any thread.
+
+void plTransformHierarchy::ICompute()
+{
+    for (size_t i = fBegin; i < fEnd; )
+    {
+        uint8_t flags = fFlags[i];
+        if (!(flags & kVisit))
+        {
+            i = fSubtreeEnds[i];
+            continue;
+        }
+
+        if ((flags & (kRecalc | kSerial)) == kRecalc)
+        {
+            if (i != fBegin)
+            {
+                int32_t parent = fParents[i];
+                fLocalToWorld[i] = IMatrixMul34(fLocalToWorld[parent], fLocalToParent[i]);
+                fWorldToLocal[i] = IMatrixMul34(fParentToLocal[i], fWorldToLocal[parent]);
+            }
+            else if (fTopHasParent)
+            {
+                fLocalToWorld[i] = IMatrixMul34(fTopParentToWorld, fLocalToParent[i]);
+                fWorldToLocal[i] = IMatrixMul34(fParentToLocal[i], fWorldToTopParent);
+            }
+            else
+            {
+                fLocalToWorld[i] = fLocalToParent[i];
+                fWorldToLocal[i] = fParentToLocal[i];
+            }
+        }
+        i++;
+    }
+}
+
+bool plTransformHierarchy::IMovedSincePlan(size_t i) const
+{
+    const plCoordinateInterface* ci = fNodes[i];
+    if (ci->fLocalToParent != fLocalToParent[i] || ci->fParentToLocal != fParentToLocal[i])
+        return true;
+
+    if (i != fBegin)
+        return fNodes[fParents[i]]->fLocalToWorld != fLocalToWorld[fParents[i]];
+    if (fTopHasParent)
+        return ci->fParent->GetLocalToWorld() != fTopParentToWorld;
+    return false;
+}
+
+//// Apply ///////////////////////////////////////////////////////////////////
+//  Hands the results back to the nodes, in order. Returns false if the
+//  hierarchy was rearranged underneath us, in which case the rest of the
+//  nodes haven't been touched.
+
+bool plTransformHierarchy::IApply()
+{
+    constexpr uint16_t kStillDirty = plCoordinateInterface::kTransformDirty |
+                                     plCoordinateInterface::kChildTransformDirty |
+                                     plCoordinateInterface::kReasonsPending;
+
+    fApplying = true;
+    bool complete = true;
+    for (size_t i = fBegin; i < fEnd; )
+    {
+        // Somebody's scene object added or removed a node; our copies of the
+        // pointers can't be trusted any more.
+        if (!fValid)
+        {
+            complete = false;
+            break;
+        }
+
+        uint8_t flags = fFlags[i];
+        if (!(flags & kVisit))
+        {
+            i = fSubtreeEnds[i];
+            continue;
+        }
+
+        plCoordinateInterface* ci = fNodes[i];
+        plProfile_IncCount(CITrans, 1);
+
+        // inherit reasons for transform change from our parents
+        ci->fReason |= (i == fBegin) ? fStartReasons : fReasons[fParents[i]];
+        ci->fState &= ~plCoordinateInterface::kReasonsPending;
+        if (flags & kProcess)
+            ci->fState &= ~plCoordinateInterface::kChildTransformDirty;
+
+        if (flags & kRecalc)
+        {
+            // Moved since we planned, by somebody reacting to an earlier node.
+            // Redo it, and the rest of the subtree, the slow way.
+            if (!(flags & kSerial) && IMovedSincePlan(i))
+            {
+                flags |= kSerial;
+                for (size_t j = i + 1; j < fSubtreeEnds[i]; j++)
+                {
+                    if (fFlags[j] & kRecalc)
+                        fFlags[j] |= kSerial;
+                }
+            }
+
+            if (flags & kSerial)
+                ci->IRecalcTransforms();
+            else
+            {
+                plProfile_IncCount(CIRecalc, 1);
+                ci->fLocalToWorld = fLocalToWorld[i];
+                ci->fWorldToLocal = fWorldToLocal[i];
+            }
+
+            plProfile_IncCount(CISet, 1);
+            plProfile_BeginTiming(CISetT);
+            if (ci->IGetOwner())
+                ci->IGetOwner()->ISetTransform(ci->fLocalToWorld, ci->fWorldToLocal);
+            plProfile_EndTiming(CISetT);
+            ci->fState &= ~plCoordinateInterface::kTransformDirty;
+        }
+
+        if (!(flags & kProcess))
+        {
+            // Our children didn't get our reasons this time around
+            if (!ci->fChildren.empty())
+                ci->fState |= plCoordinateInterface::kReasonsPending;
+
+            if (flags & kRecalc)
+            {
+                // Our parent is dirty and we're bailing out on evaluating right now.
+                // Need to ensure we'll be evaluated in the delay pass
+                plProfile_IncCount(CIDirty, 1);
+                plProfile_BeginTiming(CIDirtyT);
+                ci->IDirtyTransform();
+                plProfile_EndTiming(CIDirtyT);
+            }
+        }
+        i++;
+    }
+    fApplying = false;
+    fPlanned = false;
+
+    if (!complete)
+        return false;
+
+    // Anything still dirty below a node is waiting on the delayed pass (or was
+    // dirtied while we were at it), so keep the path to it marked.
+    for (size_t i = fEnd; i-- > fBegin + 1; )
+    {
+        if ((fFlags[i] & kVisit) && (fNodes[i]->fState & kStillDirty))
+            fNodes[fParents[i]]->fState |= plCoordinateInterface::kChildTransformDirty;
+    }
+    return true;
+}
+
+void plTransformHierarchy::IUpdate(size_t begin, bool force, uint16_t reasons, bool checkForDelay)
+{
+    plProfile_BeginTiming(CITransT);
+
+    plCoordinateInterface* start = fNodes[begin];
+    IPlan(begin, force, reasons, checkForDelay);
+
+    plProfile_BeginTiming(CIRecalcT);
+    ICompute();
+    plProfile_EndTiming(CIRecalcT);
+
+    bool complete = IApply();
+    plProfile_EndTiming(CITransT);
+
+    // If the nodes were rearranged under us, the rest of them still need
+    // their transforms, so start over from the same node, wherever it is now.
+    if (!complete)
+        Update(start, true, reasons, checkForDelay);
+}
+
+//// Entry Points ////////////////////////////////////////////////////////////
+
+void plTransformHierarchy::Update(plCoordinateInterface* node, bool force, uint16_t reasons, bool checkForDelay)
+{
+    plTransformHierarchy* hier = node->IGetRoot()->IGetHierarchy();
+    if (!hier->fApplying)
+    {
+        if (!hier->fValid)
+            hier->IBuild();
+
+        size_t index = node->fHierarchyIndex;
+        if (index >= hier->fNodes.size() || hier->fNodes[index] != node)
+            index = std::find(hier->fNodes.begin(), hier->fNodes.end(), node) - hier->fNodes.begin();
+
+        if (index < hier->fNodes.size())
+        {
+            // If this one was queued, the queue will have to start over with it
+            hier->IUpdate(index, force, reasons, checkForDelay);
+            return;
+        }
+    }
+
+    // A flush from inside the hierarchy's own apply (or from a node its
+    // parent doesn't know about); use a copy of just our subtree, so we
+    // don't pull the arrays out from under anybody.
+    plTransformHierarchy sub(node, false);
+    sub.IBuild();
+    sub.IUpdate(0, force, reasons, checkForDelay);
+}
+
+void plTransformHierarchy::BeginQueue()
+{
+    s_queueOpen = true;
+}
+
+void plTransformHierarchy::QueueUpdate(plCoordinateInterface* node, bool checkForDelay)
+{
+    // Only roots register for the messages, but one that has since been
+    // attached to something still gets its update from where it is
+    if (!s_queueOpen || node->fParent)
+    {
+        Update(node, false, 0, checkForDelay);
+        return;
+    }
+
+    plTransformHierarchy* hier = node->IGetHierarchy();
+    if (hier->fQueued)
+        return;
+
+    hier->fQueued = true;
+    hier->fQueuedCheckForDelay = checkForDelay;
+    s_updateQueue.push_back(hier);
+}
+
+void plTransformHierarchy::UpdateQueued()
+{
+    s_queueOpen = false;
+    if (s_updateQueue.empty())
+        return;
+
+    plProfile_BeginTiming(CITransT);
+    plProfile_IncCount(CIQueued, (uint32_t)s_updateQueue.size());
+
+    size_t numCompute = 0;
+    for (plTransformHierarchy* hier : s_updateQueue)
+    {
+        if (!hier)
+            continue;
+        if (!hier->fValid)
+            hier->IBuild();
+        numCompute += hier->IPlan(0, false, 0, hier->fQueuedCheckForDelay);
+        hier->fPlanned = true;
+    }
+
+    // The hierarchies don't share anything until they're applied, so each
+    // one is a separate piece of work.
+    uint32_t numThreads = fUpdateThreads ? fUpdateThreads : std::max(std::thread::hardware_concurrency(), 1U);
+    plProfile_BeginTiming(CIRecalcT);
+    if (numThreads < 2 || s_updateQueue.size() < 2 || numCompute < 2 * kMinRecalcsPerThread)
+    {
+        for (plTransformHierarchy* hier : s_updateQueue)
+        {
+            if (hier)
+                hier->ICompute();
+        }
+    }
+    else
+    {
+        GetTransformPool().Run(s_updateQueue.size(), numThreads, [](size_t i) {
+            if (s_updateQueue[i])
+                s_updateQueue[i]->ICompute();
+        });
+    }
+    plProfile_EndTiming(CIRecalcT);
+
+    // Applying can drop hierarchies from the queue, so go by index
+    for (size_t i = 0; i < s_updateQueue.size(); i++)
+    {
+        plTransformHierarchy* hier = s_updateQueue[i];
+        if (!hier)
+            continue;
+        hier->fQueued = false;
+
+        if (hier->fPlanned && hier->fValid)
+        {
+            if (!hier->IApply())
+                Update(hier->fTop, true, 0, hier->fCheckForDelay);
+        }
+        else
+        {
+            // Changed (or flushed on its own) since we planned it
+            if (!hier->fValid)
+                hier->IBuild();
+            hier->IUpdate(0, false, 0, hier->fQueuedCheckForDelay);
+        }
+    }
+    s_updateQueue.clear();
+
+    plProfile_EndTiming(CITransT);
+}
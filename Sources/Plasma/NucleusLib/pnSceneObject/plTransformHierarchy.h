@@ -0,0 +1,160 @@
+/*==LICENSE==*
+
+CyanWorlds.com Engine - MMOG client, server and tools
+Copyright (C) 2011  Cyan Worlds, Inc.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Additional permissions under GNU GPL version 3 section 7
+
+If you modify this Program, or any covered work, by linking or
+combining it with any of RAD Game Tools Bink SDK, Autodesk 3ds Max SDK,
+NVIDIA PhysX SDK, Microsoft DirectX SDK, OpenSSL library, Independent
+JPEG Group JPEG library, Microsoft Windows Media SDK, or Apple QuickTime SDK
+(or a modified version of those libraries),
+containing parts covered by the terms of the Bink SDK EULA, 3ds Max EULA,
+PhysX SDK EULA, DirectX SDK EULA, OpenSSL and SSLeay licenses, IJG
+JPEG Library README, Windows Media SDK EULA, or QuickTime SDK EULA, the
+licensors of this Program grant you additional
+permission to convey the resulting work. Corresponding Source for a
+non-source form of such a combination shall include the source code for
+the parts of OpenSSL and IJG JPEG Library used as well as that of the covered
+work.
+
+You can contact Cyan Worlds, Inc. by email legal@cyan.com
+ or by snail mail at:
+      Cyan Worlds, Inc.
+      14617 N Newport Hwy
+      Mead, WA   99021
+
+*==LICENSE==*/
+
+#ifndef plTransformHierarchy_inc
+#define plTransformHierarchy_inc
+
+#include "HeadSpin.h"
+#include "hsMatrix44.h"
+
+#include <vector>
+
+class plCoordinateInterface;
+
+//
+// A flattened copy of one plCoordinateInterface hierarchy, in depth first
+// order so every node comes after its parent and each subtree is a
+// contiguous range. Parents are indices, and the local and world matrices
+// sit in arrays of their own. plCoordinateInterface keeps its API and its
+// copies of the matrices, and hands its transform passes to us.
+//
+// A pass runs in three steps:
+//  - Plan (main thread): walk the range in order, skipping subtrees with
+//    nothing to do, and work out which nodes are visited, processed and
+//    recalculated, exactly as the old recursive walk did. Nothing on the
+//    nodes is changed yet.
+//  - Compute: one linear pass over the arrays computing the world matrices.
+//    It touches nothing but our own arrays, so different hierarchies can
+//    compute at the same time.
+//  - Apply (main thread): in order, hand the results back to the nodes,
+//    update their state and let their scene objects know.
+//
+// Nodes that compute their transforms themselves (see IHasCustomRecalc) are
+// recalculated the old way during the apply, along with everything below
+// them. So is anything whose local transform, or whose parent's world
+// transform, changed between the plan and the apply.
+//
+// Between BeginQueue() and UpdateQueued(), the transform messages queue
+// their roots with QueueUpdate(), and UpdateQueued() plans all of them,
+// computes them together, spread over the worker threads by root, and then
+// applies them one after the other.
+//
+class plTransformHierarchy
+{
+public:
+    plTransformHierarchy(plCoordinateInterface* top, bool owned);
+    ~plTransformHierarchy();
+
+    plTransformHierarchy(const plTransformHierarchy&) = delete;
+    plTransformHierarchy& operator=(const plTransformHierarchy&) = delete;
+
+    // Topology changed; rebuilt before the next pass
+    void Invalidate() { fValid = false; }
+
+    bool IsBusy() const { return fApplying || fQueued; }
+
+    // The pass for plCoordinateInterface::ITransformChanged()
+    static void Update(plCoordinateInterface* node, bool force, uint16_t reasons, bool checkForDelay);
+
+    // The client brackets sending its transform messages with these. The
+    // scene objects' handlers call QueueUpdate(), which just does the update
+    // when nobody has begun a queue.
+    static void BeginQueue();
+    static void QueueUpdate(plCoordinateInterface* node, bool checkForDelay);
+    static void UpdateQueued();
+
+    // How many threads compute queued hierarchies. 1 (the default) computes
+    // them all on the main thread; 0 means one per core.
+    static void SetUpdateThreads(uint32_t threads) { fUpdateThreads = threads; }
+    static uint32_t GetUpdateThreads() { return fUpdateThreads; }
+
+protected:
+    enum
+    {
+        kVisit      = 0x1,  // the pass looks at this node
+        kProcess    = 0x2,  // ...and its children (not held back for the delayed pass)
+        kRecalc     = 0x4,  // ...and recalculates its transforms
+        kSerial     = 0x8,  // ...with IRecalcTransforms() during the apply
+    };
+
+    static uint32_t fUpdateThreads;
+
+    plCoordinateInterface*              fTop;
+    bool                                fOwned;     // fTop's own; indices are cached on the nodes
+    bool                                fValid;
+    bool                                fPlanned;   // planned and computed, waiting to be applied
+    bool                                fApplying;
+    bool                                fQueued;
+    bool                                fQueuedCheckForDelay;
+    bool                                fCheckForDelay;     // of the planned pass
+
+    // Topology
+    std::vector<plCoordinateInterface*> fNodes;
+    std::vector<int32_t>                fParents;
+    std::vector<uint32_t>               fSubtreeEnds;
+
+    // Transforms
+    std::vector<hsMatrix44>             fLocalToParent;
+    std::vector<hsMatrix44>             fParentToLocal;
+    std::vector<hsMatrix44>             fLocalToWorld;
+    std::vector<hsMatrix44>             fWorldToLocal;
+
+    // This pass
+    std::vector<uint8_t>                fFlags;
+    std::vector<uint16_t>               fReasons;   // what each visited node passes down
+    size_t                              fBegin;
+    size_t                              fEnd;
+    uint16_t                            fStartReasons;
+    bool                                fTopHasParent;
+    hsMatrix44                          fTopParentToWorld;
+    hsMatrix44                          fWorldToTopParent;
+
+    void    IBuild();
+    void    IAddNode(plCoordinateInterface* node, int32_t parent);
+    size_t  IPlan(size_t begin, bool force, uint16_t reasons, bool checkForDelay);
+    void    ICompute();
+    bool    IMovedSincePlan(size_t i) const;
+    bool    IApply();
+    void    IUpdate(size_t begin, bool force, uint16_t reasons, bool checkForDelay);
+};
+
+#endif // plTransformHierarchy_inc
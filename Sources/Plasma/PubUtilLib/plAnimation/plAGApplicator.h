@@ -108,6 +108,7 @@ public:
         The applicator can still be forced to apply using the force
         paramater of the Apply function. */
     void Enable(bool on) { fEnabled = on; }
+    bool IsEnabled() const { return fEnabled; }
 
     /** Make a shallow copy of the applicator. Keep the same input channel
         but do not clone the input channel. */
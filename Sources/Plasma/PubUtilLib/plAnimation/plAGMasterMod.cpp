@@ -50,9 +50,12 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 
 // global
 #include "hsResMgr.h"
+#include "hsWorkerPool.h"
 #include "plgDispatch.h"
 
+#include <algorithm>
 #include <string_theory/format>
+#include <thread>
 
 // other
 #include "plInterp/plAnimEaseTypes.h"
@@ -81,13 +84,15 @@ plAGMasterMod::plAGMasterMod()
   fNeedCompile(false),
   fIsGrouped(false),
   fIsGroupMaster(false),
-  fMsgForwarder()
+  fMsgForwarder(),
+  fAnimsQueued(false)
 {
 }
 
 // DTOR
 plAGMasterMod::~plAGMasterMod()
 {
+    IDequeueAnimations();
 }
 
 void plAGMasterMod::Write(hsStream *stream, hsResMgr *mgr)
@@ -195,6 +200,7 @@ void plAGMasterMod::RemoveTarget(plSceneObject* o)
 {
     hsAssert(o == fTarget, "Removing target I don't have");
 
+    IDequeueAnimations();
     DetachAllAnimations();
 
     // remove sdl modifier
@@ -219,6 +225,10 @@ plProfile_CreateTimer("  AffineCompose", "Animation", AffineCompose);
 plProfile_CreateTimer("  AffineApplicator", "Animation", MatrixApplicator);
 plProfile_CreateTimer("AnimatingPhysicals", "Animation", AnimatingPhysicals);
 plProfile_CreateTimer("StoppedAnimPhysicals", "Animation", StoppedAnimPhysicals);
+plProfile_CreateTimer("ApplyQueuedAnims", "Animation", ApplyQueuedAnims);
+plProfile_CreateTimer("  ThreadedAnimEval", "Animation", ThreadedAnimEval);
+plProfile_CreateCounter("QueuedAnimMods", "Animation", QueuedAnimMods);
+plProfile_CreateCounter("ThreadedAnimApps", "Animation", ThreadedAnimApps);
 
 // IEVAL
 bool plAGMasterMod::IEval(double secs, float del, uint32_t dirty)
@@ -231,7 +241,7 @@ bool plAGMasterMod::IEval(double secs, float del, uint32_t dirty)
 
         fFirstEval = false;
     }
-    ApplyAnimations(secs, del);
+    QueueAnimations(secs, del);
     
     // We might get registered for just a single eval. If we don't need to eval anymore, unregister
     if (!fNeedEval) 
@@ -269,6 +279,217 @@ void plAGMasterMod::AdvanceAnimsToTime(double time)
     }
 }
 
+////////////////////////
+// QUEUED ANIMATION EVAL
+////////////////////////
+// With more than one eval thread, master mods queue up during the eval pass
+// and get applied together by ApplyQueuedAnimations(). Anything with side
+// effects (fades, compiles, advancing time converters, which fire callbacks)
+// happens on the main thread first, master by master in queue order. Every
+// plMatrixChannelApplicator whose graph can evaluate without touching shared
+// state then gets its matrices computed on the worker pool. The masters are
+// independent of each other, so each one goes to a worker whole; only very
+// big masters are split up. Last, the masters are applied on the main thread
+// in queue order, each in the order Apply() would use, with the applicators
+// we couldn't evaluate early applied the usual way. A frame with too little
+// animation to be worth waking the workers for just applies each master.
+
+uint32_t plAGMasterMod::fEvalThreads = 1;
+
+// Don't bother waking the workers for less than this many applicators per thread
+static constexpr size_t kMinAnimAppsPerThread = 64;
+
+// Masters with more applicators than this are shared out between threads
+static constexpr size_t kMaxAnimAppsPerItem = 2 * kMinAnimAppsPerThread;
+
+struct plQueuedAnimApp
+{
+    const plAGModifier* fMod;
+    plAGApplicator*     fApp;
+    bool                fThreaded;      // plain matrix applicator; try it on a worker
+    bool                fEvaluated;     // worker filled in fL2P/fP2L
+    hsMatrix44          fL2P;
+    hsMatrix44          fP2L;
+};
+
+struct plQueuedAnimEval
+{
+    plAGMasterMod*  fMaster;
+    double          fTime;
+    float           fElapsed;
+    size_t          fFirstApp;          // Our applicators, once they've been gathered up
+};
+
+static std::vector<plQueuedAnimEval> gQueuedAnimEvals;
+
+static hsWorkerPool& GetAnimEvalPool()
+{
+    static hsWorkerPool s_pool;
+    return s_pool;
+}
+
+void plAGMasterMod::QueueAnimations(double timeNow, float elapsed)
+{
+    if (fEvalThreads == 1)
+    {
+        ApplyAnimations(timeNow, elapsed);
+        return;
+    }
+
+    if (fAnimsQueued)
+    {
+        // Somebody beat us to it this frame; just catch the fades up.
+        for (plQueuedAnimEval& eval : gQueuedAnimEvals)
+        {
+            if (eval.fMaster == this)
+            {
+                eval.fTime = timeNow;
+                eval.fElapsed += elapsed;
+                return;
+            }
+        }
+    }
+
+    plQueuedAnimEval& eval = gQueuedAnimEvals.emplace_back();
+    eval.fMaster = this;
+    eval.fTime = timeNow;
+    eval.fElapsed = elapsed;
+    eval.fFirstApp = 0;
+    fAnimsQueued = true;
+}
+
+void plAGMasterMod::IDequeueAnimations()
+{
+    if (!fAnimsQueued)
+        return;
+
+    auto it = std::find_if(gQueuedAnimEvals.begin(), gQueuedAnimEvals.end(),
+                           [this](const plQueuedAnimEval& eval) { return eval.fMaster == this; });
+    if (it != gQueuedAnimEvals.end())
+        gQueuedAnimEvals.erase(it);
+    fAnimsQueued = false;
+}
+
+void plAGMasterMod::ApplyQueuedAnimations()
+{
+    if (gQueuedAnimEvals.empty())
+        return;
+
+    plProfile_BeginTiming(ApplyQueuedAnims);
+    plProfile_IncCount(QueuedAnimMods, (uint32_t)gQueuedAnimEvals.size());
+
+    // Hold any callbacks until we're done; a receiver that detaches an
+    // animation halfway through would pull the graph out from under us.
+    bool buffering = plgDispatch::Dispatch()->SetMsgBuffering(true);
+
+    uint32_t numThreads = fEvalThreads ? fEvalThreads : std::max(std::thread::hardware_concurrency(), 1U);
+
+    size_t numApps = 0;
+    for (const plQueuedAnimEval& eval : gQueuedAnimEvals)
+    {
+        for (const auto& [name, mod] : eval.fMaster->fChannelMods)
+        {
+            if (mod->IsEnabled())
+                numApps += mod->GetNumApplicators();
+        }
+    }
+
+    // Masters can't be dequeued while we're in here (the buffered messages
+    // are what would do it), so the list holds still.
+    if (numThreads < 2 || numApps < 2 * kMinAnimAppsPerThread)
+    {
+        for (plQueuedAnimEval& eval : gQueuedAnimEvals)
+        {
+            eval.fMaster->fAnimsQueued = false;
+            eval.fMaster->ApplyAnimations(eval.fTime, eval.fElapsed);
+        }
+    }
+    else
+    {
+        static std::vector<plQueuedAnimApp> apps;
+        static std::vector<size_t> numMasterApps;
+        apps.clear();
+        numMasterApps.clear();
+
+        size_t numThreaded = 0;
+        for (plQueuedAnimEval& eval : gQueuedAnimEvals)
+        {
+            plAGMasterMod* master = eval.fMaster;
+            master->fAnimsQueued = false;
+
+            for (int i = 0; i < master->fAnimInstances.size(); i++)
+                master->fAnimInstances[i]->ProcessFade(eval.fElapsed);
+
+            if (master->fNeedCompile)
+                master->Compile(eval.fTime);
+
+            // Advance the time converters of anything that can be seen, so
+            // the workers just read back the current time.
+            for (plAGAnimInstance* instance : master->fAnimInstances)
+            {
+                plAnimTimeConvert* atc = instance->GetTimeConvert();
+                if (atc && instance->GetBlend() != 0.f && instance->GetAmplitude() != 0.f)
+                    atc->WorldToAnimTime(eval.fTime);
+            }
+
+            eval.fFirstApp = apps.size();
+            for (const auto& [name, mod] : master->fChannelMods)
+            {
+                if (!mod->IsEnabled())
+                    continue;
+
+                for (size_t i = 0; i < mod->GetNumApplicators(); i++)
+                {
+                    plQueuedAnimApp& app = apps.emplace_back();
+                    app.fMod = mod;
+                    app.fApp = mod->GetApplicatorByIndex(i);
+                    app.fThreaded = app.fApp->IsEnabled() &&
+                                    app.fApp->ClassIndex() == plMatrixChannelApplicator::Index();
+                    app.fEvaluated = false;
+                    if (app.fThreaded)
+                        numThreaded++;
+                }
+            }
+            numMasterApps.push_back(apps.size() - eval.fFirstApp);
+        }
+        plProfile_IncCount(ThreadedAnimApps, (uint32_t)numThreaded);
+
+        plProfile_BeginTiming(ThreadedAnimEval);
+        GetAnimEvalPool().RunGroups(numMasterApps, kMaxAnimAppsPerItem, numThreads, [](size_t master, size_t i) {
+            const plQueuedAnimEval& eval = gQueuedAnimEvals[master];
+            plQueuedAnimApp& app = apps[eval.fFirstApp + i];
+            if (app.fThreaded)
+            {
+                const plMatrixChannelApplicator* matApp = static_cast<const plMatrixChannelApplicator*>(app.fApp);
+                app.fEvaluated = matApp->EvalThreaded(eval.fTime, app.fL2P, app.fP2L);
+            }
+        });
+        plProfile_EndTiming(ThreadedAnimEval);
+
+        for (size_t master = 0; master < gQueuedAnimEvals.size(); master++)
+        {
+            const plQueuedAnimEval& eval = gQueuedAnimEvals[master];
+            for (size_t i = eval.fFirstApp; i < eval.fFirstApp + numMasterApps[master]; i++)
+            {
+                const plQueuedAnimApp& app = apps[i];
+                if (app.fEvaluated)
+                {
+                    plMatrixChannelApplicator* matApp = static_cast<plMatrixChannelApplicator*>(app.fApp);
+                    matApp->ApplyEvaluated(app.fMod, app.fL2P, app.fP2L);
+                }
+                else
+                    app.fApp->Apply(app.fMod, eval.fTime);
+            }
+        }
+    }
+    gQueuedAnimEvals.clear();
+
+    if (buffering)
+        plgDispatch::Dispatch()->SetMsgBuffering(false);
+
+    plProfile_EndTiming(ApplyQueuedAnims);
+}
+
 void plAGMasterMod::SetNeedCompile(bool needCompile)
 {
     fNeedCompile = true;
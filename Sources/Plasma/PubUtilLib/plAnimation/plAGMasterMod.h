@@ -168,6 +168,22 @@ public:
         certain point before enabling callbacks */
     void AdvanceAnimsToTime(double time);
 
+    /** Apply our animations now or, if threaded evaluation is on, queue
+        them up for ApplyQueuedAnimations() later this frame. Only for
+        callers that don't look at the animated transforms afterwards. */
+    void QueueAnimations(double timeNow, float elapsed);
+
+    /** Apply every master mod queued this frame, in the order they were
+        queued. The masters' channel graphs are evaluated on a pool of
+        worker threads first, a master per thread at a time. Called once
+        per frame after the eval pass. */
+    static void ApplyQueuedAnimations();
+
+    /** How many threads evaluate queued animations. 1 (the default)
+        applies everything immediately, as it's queued; 0 means one per core. */
+    static void SetEvalThreads(uint32_t threads) { fEvalThreads = threads; }
+    static uint32_t GetEvalThreads() { return fEvalThreads; }
+
     /** Change the connectivity in the graph so that inactive animations are bypassed.
         The original connectivity information is kept, so if the activity of different
         animations is changed (such as by changing blend biases or adding new animations,
@@ -219,6 +235,8 @@ protected:
     // Find markers in an anim for environment effects (footsteps)
     virtual void ISetupMarkerCallbacks(plATCAnim *anim, plAnimTimeConvert *atc) {}
 
+    void IDequeueAnimations();
+
     // -- members
     plSceneObject*  fTarget;
 
@@ -249,6 +267,10 @@ protected:
     bool fIsGrouped;
     bool fIsGroupMaster;
     plMsgForwarder* fMsgForwarder;
+
+    bool fAnimsQueued;
+
+    static uint32_t fEvalThreads;
     
     enum {
         kPrivateAnim,
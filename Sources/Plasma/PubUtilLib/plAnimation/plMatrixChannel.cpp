@@ -208,6 +208,12 @@ void plMatrixConstant::Set(const hsMatrix44 &value)
     AP_SET(fAP, gemParts1);
 }
 
+bool plMatrixConstant::AffineValueThreaded(double time, hsAffineParts &parts) const
+{
+    parts = fAP;
+    return true;
+}
+
 void plMatrixConstant::Write(hsStream *stream, hsResMgr *mgr)
 {
     plMatrixChannel::Write(stream, mgr);
@@ -274,6 +280,15 @@ const hsAffineParts & plMatrixTimeScale::AffineValue(double time, bool peek)
     return fAP;
 }
 
+bool plMatrixTimeScale::AffineValueThreaded(double time, hsAffineParts &parts) const
+{
+    float localTime;
+    if (!fTimeSource->ValueThreaded(time, localTime))
+        return false;
+
+    return fChannelIn->AffineValueThreaded(localTime, parts);
+}
+
 // Detach ----------------------------------------------------
 // -------
 plAGChannel * plMatrixTimeScale::Detach(plAGChannel * detach)
@@ -426,6 +441,27 @@ const hsAffineParts & plMatrixBlend::AffineValue(double time, bool peek)
     return fAP;
 }
 
+// AffineValueThreaded -----------------------------------------------------------
+// --------------------
+bool plMatrixBlend::AffineValueThreaded(double time, hsAffineParts &parts) const
+{
+    float blend;
+    if (!fChannelBias->ValueThreaded(time, blend))
+        return false;
+
+    if (blend == 0)
+        return fOptimizedA->AffineValueThreaded(time, parts);
+    if (blend == 1)
+        return fOptimizedB->AffineValueThreaded(time, parts);
+
+    hsAffineParts apA, apB;
+    if (!fChannelA->AffineValueThreaded(time, apA) || !fChannelB->AffineValueThreaded(time, apB))
+        return false;
+
+    hsInterp::LinInterp(&apA, &apB, blend, &parts);
+    return true;
+}
+
 // Detach ----------------------------------------------
 // -------
 plAGChannel * plMatrixBlend::Detach(plAGChannel *remove)
@@ -560,6 +596,16 @@ const hsAffineParts & plMatrixControllerChannel::AffineValue(double time, bool p
     return fAP;
 }
 
+// InterpAffine ----------------------------------------------------------------------
+// -------------
+void plMatrixControllerChannel::InterpAffine(double time, hsAffineParts &parts,
+                                             plControllerCacheInfo *cache) const
+{
+    // The controller only writes the parts it animates; the rest keep our defaults.
+    parts = fAP;
+    fController->Interp((float)time, &parts, cache);
+}
+
 // MakeCacheChannel ------------------------------------------------------------
 // -----------------
 plAGChannel *plMatrixControllerChannel::MakeCacheChannel(plAnimTimeConvert *atc)
@@ -636,6 +682,13 @@ const hsAffineParts & plMatrixControllerCacheChannel::AffineValue(double time, b
     return fControllerChannel->AffineValue(time, peek, fCache);
 }
 
+bool plMatrixControllerCacheChannel::AffineValueThreaded(double time, hsAffineParts &parts) const
+{
+    // The cache is ours alone, so the key search state it holds is safe to update.
+    fControllerChannel->InterpAffine(time, parts, fCache);
+    return true;
+}
+
 // DETACH
 plAGChannel * plMatrixControllerCacheChannel::Detach(plAGChannel * detach)
 {
@@ -765,6 +818,31 @@ void plMatrixChannelApplicator::IApply(const plAGModifier *mod, double time)
     }
 }
 
+// EVALTHREADED
+bool plMatrixChannelApplicator::EvalThreaded(double time, hsMatrix44 &l2p, hsMatrix44 &p2l) const
+{
+    plMatrixChannel *matChan = plMatrixChannel::ConvertNoRef(fChannel);
+    if (!matChan)
+        return false;
+
+    hsAffineParts ap;
+    if (!matChan->AffineValueThreaded(time, ap))
+        return false;
+
+    ap.ComposeMatrix(&l2p);
+    ap.ComposeInverseMatrix(&p2l);
+    return true;
+}
+
+// APPLYEVALUATED
+void plMatrixChannelApplicator::ApplyEvaluated(const plAGModifier *mod, const hsMatrix44 &l2p, const hsMatrix44 &p2l)
+{
+    plProfile_BeginTiming(MatrixApplicator);
+    plCoordinateInterface *CI = IGetCI(mod);
+    CI->SetLocalToParent(l2p, p2l);
+    plProfile_EndTiming(MatrixApplicator);
+}
+
 ///////////////////////////////////////////////////////////////////////////////////////////
 //
 // plMatrixDelayedCorrectionApplicator
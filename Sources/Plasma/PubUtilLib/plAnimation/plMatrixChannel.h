@@ -80,6 +80,11 @@ public:
     virtual void Value(hsMatrix44 &matrix, double time, bool peek = false);
     virtual const hsAffineParts & AffineValue(double time, bool peek = false);
 
+    // Evaluate into the caller's storage without touching state shared with other
+    // graphs, so it's safe to call from a worker thread. Returns false if some node
+    // in this subgraph can't do that; the caller should fall back to AffineValue().
+    virtual bool AffineValueThreaded(double time, hsAffineParts &parts) const { return false; }
+
     // combine it (allocates combine object)
     plAGChannel * MakeCombine(plAGChannel * channelB) override;
 
@@ -112,6 +117,8 @@ public:
     virtual ~plMatrixConstant();
 
     void Set(const hsMatrix44 &value);
+
+    bool AffineValueThreaded(double time, hsAffineParts &parts) const override;
     
     // PLASMA PROTOCOL
     CLASSNAME_REGISTER( plMatrixConstant );
@@ -140,6 +147,7 @@ public:
     bool IsStoppedAt(double time) override;
     const hsMatrix44 & Value(double time, bool peek = false) override;
     const hsAffineParts & AffineValue(double time, bool peek = false) override;
+    bool AffineValueThreaded(double time, hsAffineParts &parts) const override;
 
     plAGChannel * Detach(plAGChannel * channel) override;
 
@@ -193,6 +201,7 @@ public:
     // AG PROTOCOL
     const hsMatrix44 & Value(double time, bool peek = false) override;
     const hsAffineParts & AffineValue(double time, bool peek = false) override;
+    bool AffineValueThreaded(double time, hsAffineParts &parts) const override;
 
     // remove the specified channel from our graph
     plAGChannel * Detach(plAGChannel * channel) override;
@@ -225,6 +234,10 @@ public:
     virtual const hsAffineParts & AffineValue(double time, bool peek, plControllerCacheInfo *cache);    
     const hsMatrix44 & Value(double time, bool peek = false) override;
     virtual const hsMatrix44 & Value(double time, bool peek, plControllerCacheInfo *cache);
+
+    // Interpolate into parts without touching our own result. Only thread safe
+    // with a per-instance cache; without one the controller keeps a shared key index.
+    void InterpAffine(double time, hsAffineParts &parts, plControllerCacheInfo *cache) const;
     
     plAGChannel * MakeCacheChannel(plAnimTimeConvert *atc) override;
 
@@ -257,6 +270,7 @@ public:
     
     const hsMatrix44 & Value(double time, bool peek = false) override;
     const hsAffineParts & AffineValue(double time, bool peek = false) override;
+    bool AffineValueThreaded(double time, hsAffineParts &parts) const override;
     
     plAGChannel * Detach(plAGChannel * channel) override;
     
@@ -313,6 +327,11 @@ protected:
     void IApply(const plAGModifier *mod, double time) override;
 
 public:
+    // Split version of IApply for the threaded eval in plAGMasterMod.
+    // EvalThreaded() may run on a worker; ApplyEvaluated() must run on the main thread.
+    bool EvalThreaded(double time, hsMatrix44 &l2p, hsMatrix44 &p2l) const;
+    void ApplyEvaluated(const plAGModifier *mod, const hsMatrix44 &l2p, const hsMatrix44 &p2l);
+
     CLASSNAME_REGISTER( plMatrixChannelApplicator );
     GETINTERFACE_ANY( plMatrixChannelApplicator, plAGApplicator );
 
@@ -480,6 +480,17 @@ const float & plATCChannel::Value(double time, bool peek)
     return fResult;
 }
 
+// ValueThreaded ------------------------------------------
+// --------------
+bool plATCChannel::ValueThreaded(double time, float &result) const
+{
+    if (fConvert->LastEvalWorldTime() != time)
+        return false;
+
+    result = fConvert->CurrentAnimTime();
+    return true;
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////
 //
 // PLSCALARSDLCHANNEL
@@ -524,6 +535,18 @@ const float & plScalarSDLChannel::Value(double time, bool peek)
     return fResult;
 }
 
+// ValueThreaded ------------------------------------------------
+// --------------
+bool plScalarSDLChannel::ValueThreaded(double time, float &result) const
+{
+    if (!fVar)
+        return false;
+
+    fVar->Get(&result);
+    result *= fLength;
+    return true;
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////
 //
 // APPLICATORS
@@ -83,6 +83,9 @@ public:
     virtual const float & Value(double time, bool peek = false);
     virtual void Value(float &result, double time, bool peek = false);
 
+    // Worker-thread-safe evaluation; see plMatrixChannel::AffineValueThreaded.
+    virtual bool ValueThreaded(double time, float &result) const { return false; }
+
     // combine it (allocates combine object)
     plAGChannel * MakeCombine(plAGChannel * channelB) override;
 
@@ -114,6 +117,8 @@ public:
     void Set(float value) { fResult = value; }
     float Get() { return fResult; }
 
+    bool ValueThreaded(double time, float &result) const override { result = fResult; return true; }
+
     // PLASMA PROTOCOL
     CLASSNAME_REGISTER( plScalarConstant );
     GETINTERFACE_ANY( plScalarConstant, plScalarChannel );
@@ -262,6 +267,10 @@ public:
     bool IsStoppedAt(double time) override;
     const float & Value(double time, bool peek = false) override;
 
+    // Only succeeds once the converter has been advanced to this time on the main
+    // thread, since advancing it fires callbacks.
+    bool ValueThreaded(double time, float &result) const override;
+
     // PLASMA PROTOCOL
     CLASSNAME_REGISTER( plATCChannel );
     GETINTERFACE_ANY( plATCChannel, plScalarChannel );
@@ -284,6 +293,7 @@ public:
 
     bool IsStoppedAt(double time) override;
     const float & Value(double time, bool peek = false) override;
+    bool ValueThreaded(double time, float &result) const override;
 
     void SetVar(plSimpleStateVariable *var) { fVar = var; }
 
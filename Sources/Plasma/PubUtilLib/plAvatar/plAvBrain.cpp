@@ -77,7 +77,7 @@ plArmatureBrain::~plArmatureBrain()
 bool plArmatureBrain::Apply(double timeNow, float elapsed)
 {
     IProcessTasks(timeNow, elapsed);
-    fArmature->ApplyAnimations(timeNow, elapsed);
+    fArmature->QueueAnimations(timeNow, elapsed);
     
     return true;
 }
@@ -79,6 +79,7 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 #include "plCluster.h"
 #include "plSpanTemplate.h"
 #include "plGBufferGroup.h"
+#include "plFaceSorter.h"
 
 #include "plMath/hsRadixSort.h"
 #include "plSurface/hsGMaterial.h"
@@ -1428,6 +1429,7 @@ bool plDrawableSpans::GetSubVisDists(size_t index, float& minDist, float& maxDis
 plProfile_CreateTimer("Face Sort", "Draw", FaceSort);
 plProfile_CreateCounter("Face Sort Calls", "Draw", FaceSortCalls);
 plProfile_CreateCounter("Faces Sorted", "Draw", FacesSorted);
+plProfile_CreateCounter("Faces Reused", "Draw", FacesReused);
 
 void    plDrawableSpans::SortSpan( uint32_t index, plPipeline *pipe )
 {
@@ -1436,17 +1438,16 @@ void    plDrawableSpans::SortSpan( uint32_t index, plPipeline *pipe )
     plProfile_BeginLap(FaceSort, ST_LITERAL("0"));
 
     plIcicle            *span = (plIcicle *)fSpans[ index ];
-    plGBufferTriangle   *list, temp;
+    plGBufferTriangle   *list;
     uint32_t              numTris;
-    int                 i;
+    uint32_t              i;
     hsMatrix44          w2cMatrix = pipe->GetWorldToCamera() * pipe->GetLocalToWorld();
-    float            dist;
 
     ICheckSpanForSortable(index);
 
-    static std::vector<hsRadixSort::Elem>  sortList;
-    static std::vector<uint16_t>           tempTriList;
-    hsRadixSort::Elem                   *elem;
+    static plFaceSorter             sorter;
+    static std::vector<float>       dists;
+    static std::vector<uint16_t>    tempTriList;
 
 
     /// Get some stuff
@@ -1458,9 +1459,8 @@ void    plDrawableSpans::SortSpan( uint32_t index, plPipeline *pipe )
     hsAssert( numTris > 0, "How could we start sorting no triangles??" );
 
     /// Sort the triangles in "list"
-    sortList.resize(numTris);
+    dists.resize(numTris);
     tempTriList.resize(numTris * 3);
-    elem = sortList.data();
 
     plProfile_EndLap(FaceSort, ST_LITERAL("0"));
     plProfile_BeginLap(FaceSort, ST_LITERAL("1"));
@@ -1468,34 +1468,27 @@ void    plDrawableSpans::SortSpan( uint32_t index, plPipeline *pipe )
     hsVector3 vec(w2cMatrix.fMap[2][0], w2cMatrix.fMap[2][1], w2cMatrix.fMap[2][2]);
     float trans = w2cMatrix.fMap[2][3];
 
-    // Fill out the radix sort elements with our data
+    // Camera space depths are our keys
     for( i = 0; i < numTris; i++ )
-    {
-        dist = vec.InnerProduct(list[ i ].fCenter) + trans;
-        elem[ i ].fKey.fFloat = dist;
-        elem[ i ].fBody = (intptr_t)&list[ i ];
-        elem[ i ].fNext = elem + i + 1;
-    }
-    elem[i - 1].fNext = nullptr;
+        dists[ i ] = vec.InnerProduct(list[ i ].fCenter) + trans;
 
     plProfile_EndLap(FaceSort, ST_LITERAL("1"));
     plProfile_BeginLap(FaceSort, ST_LITERAL("2"));
 
     // Do da sort thingy
-    hsRadixSort         rad;
-    hsRadixSort::Elem   *sortedList = rad.Sort( elem, 0 );
+    const uint32_t* order = sorter.Sort(dists.data(), numTris);
 
     plProfile_EndLap(FaceSort, ST_LITERAL("2"));
     plProfile_BeginLap(FaceSort, ST_LITERAL("3"));
 
     uint16_t* indices = tempTriList.data();
     // Stuff into the temp array
-    for( i = 0, elem = sortedList; i < numTris; i++ )
+    for( i = 0; i < numTris; i++ )
     {
-        *indices++ = ((plGBufferTriangle *)elem->fBody)->fIndex1;
-        *indices++ = ((plGBufferTriangle *)elem->fBody)->fIndex2;
-        *indices++ = ((plGBufferTriangle *)elem->fBody)->fIndex3;
-        elem = elem->fNext;
+        const plGBufferTriangle& tri = list[ order[ i ] ];
+        *indices++ = tri.fIndex1;
+        *indices++ = tri.fIndex2;
+        *indices++ = tri.fIndex3;
     }
 
     plProfile_EndLap(FaceSort, ST_LITERAL("3"));
@@ -1505,13 +1498,6 @@ void    plDrawableSpans::SortSpan( uint32_t index, plPipeline *pipe )
     fGroups[ span->fGroupIdx ]->StuffFromTriList( span->fIBufferIdx, span->fIStartIdx, 
                                                   numTris, tempTriList.data());
 
-    /// Optional step in a way: copy back our new, sorted list to our original
-    /// array. This lets us do less sorting next call, since the order should
-    /// remain largely unchanged from the last call. If this turns out NOT to
-    /// be the case, or if the sorting step takes less time than this copy,
-    /// take this out!
-//  memcpy( list, tempTriList.AcquireArray(), numTris * sizeof( plGBufferTriangle ) );
-
     /// All done! (force buffer groups to refresh during next render call)
     fReadyToRender = false;
 
@@ -1722,9 +1708,8 @@ void plDrawableSpans::SortVisibleSpans(const std::vector<int16_t>& visList, plPi
 
     plProfile_BeginTiming(FaceSort);
 
-    static std::vector<hsRadixSort::Elem> sortScratch;
+    static plFaceSorter sorter;
     static std::vector<uint16_t> triList;
-    static std::vector<int32_t> counters;
     static std::vector<uint32_t> startIndex;
     
     if( pipe->IsDebugFlagSet( plPipeDbg::kFlagDontSortFaces ) )
@@ -1769,9 +1754,6 @@ void plDrawableSpans::SortVisibleSpans(const std::vector<int16_t>& visList, plPi
         ICheckSpanForSortable(idx);
         
         startIndex[idx] = totTris * 3;
-        if( span->fProps & plSpan::kPropReverseSort )
-            startIndex[idx] += span->fILength - 3;
-
 
         totTris += span->fILength / 3;
     }
@@ -1781,79 +1763,53 @@ void plDrawableSpans::SortVisibleSpans(const std::vector<int16_t>& visList, plPi
         return;
     }
 
-    plProfile_IncCount(FacesSorted, totTris);
-
-    if( sortScratch.size() < totTris )
-    {
-        sortScratch.resize(totTris);
+    if( triList.size() < 3 * totTris )
         triList.resize(3 * totTris);
-    }
-
-    hsRadixSort::Elem* elem = sortScratch.data();
 
     plProfile_EndLap(FaceSort, ST_LITERAL("0"));
 
-    size_t iVis = 0;
-    while (iVis < visList.size())
+    // Each span's triangles only ever get ordered among themselves, so we sort
+    // span by span. fSortData is left in back to front order, so when the
+    // viewer has hardly moved relative to a span since its last sort, last
+    // frame's order is still good and we skip straight to filling indices.
+    for (int16_t vis : visList)
     {
-        plProfile_BeginLap(FaceSort, ST_LITERAL("1"));
-
-        // Pack them into the sort structure. We probably want to make the 
-        // plGBufferTriangle look like plTriSortData (just add span index) 
-        // which would get rid of this copy and help the data alignment.
-        // Oops, I already did.
-        const int kTriCutoff = 4000;
-        int cnt = 0;
-        while ((iVis < visList.size()) && (cnt < kTriCutoff))
-        {
-            plIcicle* span = (plIcicle*)fSpans[visList[iVis]];
-            
-            int nTris = span->fILength / 3;
-
-            hsPoint3 viewPos = span->fWorldToLocal * pipe->GetViewPositionWorld();
-
-            plGBufferTriangle*      list = span->fSortData;
-            int j;
-            for( j = 0; j < nTris; j++ )
-            {
-                float dist = -(viewPos - list[j].fCenter).MagnitudeSquared();
-                elem[cnt].fKey.fFloat = dist;
-                elem[cnt].fBody = (intptr_t)&list[j];
-                elem[cnt].fNext = elem + cnt + 1;
+        plIcicle* span = (plIcicle*)fSpans[vis];
+        
+        const uint32_t nTris = span->fILength / 3;
+        if( !nTris )
+            continue;
 
-                cnt++;
-            }
-            iVis++;
-        }
-        elem[cnt-1].fNext = nullptr;
+        const hsPoint3 viewPos = span->fWorldToLocal * pipe->GetViewPositionWorld();
 
-        plProfile_EndLap(FaceSort, ST_LITERAL("1"));
         plProfile_BeginLap(FaceSort, ST_LITERAL("2"));
 
-        // Actual sort
-        hsRadixSort         rad;
-        hsRadixSort::Elem* sortedList = rad.Sort( elem, 0 );
+        if( !span->fSortViewValid 
+            || !plFaceSorter::IsCoherent(span->fSortViewPos, viewPos, span->fLocalBounds) )
+        {
+            sorter.SortBackToFront(span->fSortData, nTris, viewPos);
+            span->fSortViewPos = viewPos;
+            span->fSortViewValid = true;
+            plProfile_IncCount(FacesSorted, nTris);
+        }
+        else
+        {
+            plProfile_IncCount(FacesReused, nTris);
+        }
 
         plProfile_EndLap(FaceSort, ST_LITERAL("2"));
         plProfile_BeginLap(FaceSort, ST_LITERAL("3"));
 
-        counters.assign(fSpans.size(), 0);
-
-        while( sortedList )
+        const plGBufferTriangle* data = span->fSortData;
+        uint16_t* idx = &triList[startIndex[vis]];
+        if( span->fProps & plSpan::kPropReverseSort )
+            data += nTris - 1;
+        const int step = span->fProps & plSpan::kPropReverseSort ? -1 : 1;
+        for( uint32_t j = 0; j < nTris; j++, data += step )
         {
-            plGBufferTriangle* data = (plGBufferTriangle*)sortedList->fBody;
-            plIcicle* span = (plIcicle*)fSpans[data->fSpanIndex];
-
-            uint16_t* idx = &triList[startIndex[data->fSpanIndex] + counters[data->fSpanIndex]];
             *idx++ = data->fIndex1;
             *idx++ = data->fIndex2;
             *idx++ = data->fIndex3;
-            if( span->fProps & plSpan::kPropReverseSort )
-                counters[data->fSpanIndex] -= 3;
-            else
-                counters[data->fSpanIndex] += 3;
-            
-            sortedList = sortedList->fNext;
         }
 
         plProfile_EndLap(FaceSort, ST_LITERAL("3"));
@@ -1875,9 +1831,6 @@ void plDrawableSpans::SortVisibleSpans(const std::vector<int16_t>& visList, plPi
 
         hsAssert(kMaxIndexBuffers > span->fIBufferIdx, "Bigger than we counted on num buffers sort.");
 
-        if( span->fProps & plSpan::kPropReverseSort )
-            startIndex[idx] -= span->fILength - 3;
-
         /// Now send them on to the buffer group
         span->fIPackedIdx = span->fIStartIdx = newStarts[span->fGroupIdx][span->fIBufferIdx];
         newStarts[span->fGroupIdx][span->fIBufferIdx] += (int16_t)(span->fILength);
@@ -2918,6 +2871,7 @@ void plDrawableSpans::IMakeSpanSortable(size_t index)
         return;
 
     span->fSortData = list;
+    span->fSortViewValid = false;
 
     /// Mark as sortable
     span->fProps |= plSpan::kPropFacesSortable;
@@ -3407,6 +3361,7 @@ void    plDrawableSpans::AssignEmitterToParticleSystem( uint32_t setIndex, plPar
 
             index += 4;
         }
+        icicle->fSortViewValid = false;
     }
 
     icicle->fLocalBounds = emitter->GetBoundingBox();
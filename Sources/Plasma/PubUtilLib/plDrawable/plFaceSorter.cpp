@@ -0,0 +1,83 @@
+/*==LICENSE==*
+
+CyanWorlds.com Engine - MMOG client, server and tools
+Copyright (C) 2011  Cyan Worlds, Inc.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Additional permissions under GNU GPL version 3 section 7
+
+If you modify this Program, or any covered work, by linking or
+combining it with any of RAD Game Tools Bink SDK, Autodesk 3ds Max SDK,
+NVIDIA PhysX SDK, Microsoft DirectX SDK, OpenSSL library, Independent
+JPEG Group JPEG library, Microsoft Windows Media SDK, or Apple QuickTime SDK
+(or a modified version of those libraries),
+containing parts covered by the terms of the Bink SDK EULA, 3ds Max EULA,
+PhysX SDK EULA, DirectX SDK EULA, OpenSSL and SSLeay licenses, IJG
+JPEG Library README, Windows Media SDK EULA, or QuickTime SDK EULA, the
+licensors of this Program grant you additional
+permission to convey the resulting work. Corresponding Source for a
+non-source form of such a combination shall include the source code for
+the parts of OpenSSL and IJG JPEG Library used as well as that of the covered
+work.
+
+You can contact Cyan Worlds, Inc. by email legal@cyan.com
+ or by snail mail at:
+      Cyan Worlds, Inc.
+      14617 N Newport Hwy
+      Mead, WA   99021
+
+*==LICENSE==*/
+
+#include "HeadSpin.h"
+#include "plFaceSorter.h"
+
+#include <algorithm>
+
+#include "plGBufferGroup.h"
+
+// How far (as a fraction of the distance to the geometry) the viewer may
+// drift before the last order is considered stale.
+static constexpr float kCoherentFraction = 0.01f;
+
+void plFaceSorter::SortBackToFront(plGBufferTriangle* tris, uint32_t numTris, const hsPoint3& viewPos)
+{
+    // Farthest first is just ascending in negative squared distance.
+    fDists.resize(numTris);
+    for (uint32_t i = 0; i < numTris; i++)
+        fDists[i] = -(viewPos - tris[i].fCenter).MagnitudeSquared();
+
+    const uint32_t* order = Sort(fDists.data(), numTris);
+
+    fTriScratch.resize(numTris);
+    for (uint32_t i = 0; i < numTris; i++)
+        fTriScratch[i] = tris[order[i]];
+    std::copy(fTriScratch.begin(), fTriScratch.end(), tris);
+}
+
+bool plFaceSorter::IsCoherent(const hsPoint3& lastViewPos, const hsPoint3& viewPos, const hsBounds3& bounds)
+{
+    if (bounds.GetType() != kBoundsNormal)
+        return false;
+
+    // Measure to the nearest part of the geometry, not its middle. Faces near
+    // the viewer swap order after much smaller moves than the center suggests.
+    // From inside the bounds that distance is zero, so any move at all resorts.
+    hsPoint3 inner, outer;
+    bounds.ClosestPoint(viewPos, inner, outer);
+
+    float moveSq = (viewPos - lastViewPos).MagnitudeSquared();
+    float distSq = (viewPos - inner).MagnitudeSquared();
+    return moveSq <= kCoherentFraction * kCoherentFraction * distSq;
+}
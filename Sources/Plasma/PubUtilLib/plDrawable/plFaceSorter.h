@@ -0,0 +1,82 @@
+/*==LICENSE==*
+
+CyanWorlds.com Engine - MMOG client, server and tools
+Copyright (C) 2011  Cyan Worlds, Inc.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Additional permissions under GNU GPL version 3 section 7
+
+If you modify this Program, or any covered work, by linking or
+combining it with any of RAD Game Tools Bink SDK, Autodesk 3ds Max SDK,
+NVIDIA PhysX SDK, Microsoft DirectX SDK, OpenSSL library, Independent
+JPEG Group JPEG library, Microsoft Windows Media SDK, or Apple QuickTime SDK
+(or a modified version of those libraries),
+containing parts covered by the terms of the Bink SDK EULA, 3ds Max EULA,
+PhysX SDK EULA, DirectX SDK EULA, OpenSSL and SSLeay licenses, IJG
+JPEG Library README, Windows Media SDK EULA, or QuickTime SDK EULA, the
+licensors of this Program grant you additional
+permission to convey the resulting work. Corresponding Source for a
+non-source form of such a combination shall include the source code for
+the parts of OpenSSL and IJG JPEG Library used as well as that of the covered
+work.
+
+You can contact Cyan Worlds, Inc. by email legal@cyan.com
+ or by snail mail at:
+      Cyan Worlds, Inc.
+      14617 N Newport Hwy
+      Mead, WA   99021
+
+*==LICENSE==*/
+
+#ifndef plFaceSorter_inc
+#define plFaceSorter_inc
+
+#include <vector>
+
+#include "hsBounds.h"
+#include "hsGeometry3.h"
+
+#include "plMath/hsRadixSort.h"
+
+class plGBufferTriangle;
+
+//// plFaceSorter Class Definition ///////////////////////////////////////////
+//  Orders triangles for blended spans, using an hsArrayRadixSort over their
+//  depths. Scratch is kept between calls, so hang on to the sorter rather than
+//  making one per span.
+
+class plFaceSorter
+{
+protected:
+    hsArrayRadixSort<float>         fSorter;
+    std::vector<float>              fDists;
+    std::vector<plGBufferTriangle>  fTriScratch;
+
+public:
+    // Returns the indices of keys in ascending key order (equal keys keep
+    // their relative order). Valid until the next call.
+    const uint32_t* Sort(const float* keys, uint32_t count) { return fSorter.Sort(keys, count); }
+
+    // Reorders tris in place so the one farthest from viewPos comes first.
+    // viewPos is in the same space as the triangle centers.
+    void SortBackToFront(plGBufferTriangle* tris, uint32_t numTris, const hsPoint3& viewPos);
+
+    // A back to front order computed from lastViewPos still holds (near enough)
+    // from viewPos if the viewer moved only a small fraction of its distance to
+    // the closest point of the geometry's bounds.
+    static bool IsCoherent(const hsPoint3& lastViewPos, const hsPoint3& viewPos, const hsBounds3& bounds);
+};
+
+#endif // plFaceSorter_inc
@@ -463,6 +463,7 @@ void    plIcicle::Destroy()
     plSpan::Destroy();
     delete [] fSortData;
     fSortData = nullptr;
+    fSortViewValid = false;
 }
 
 //// CanMergeInto ////////////////////////////////////////////////////////////
@@ -507,6 +508,7 @@ plIcicle::plIcicle()
     fTypeMask |= kIcicleSpan;
 
     fSortData = nullptr;
+    fSortViewValid = false;
 }
 
 //////////////////////////////////////////////////////////////////////////////
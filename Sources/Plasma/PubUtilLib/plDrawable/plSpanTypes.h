@@ -254,6 +254,8 @@ class plIcicle : public plVertexSpan
 
         // Run-time-only stuff
         plGBufferTriangle   *fSortData; // Indices & center points for sorting tris in this span (optional)
+        hsPoint3            fSortViewPos;   // Local view position fSortData was last sorted back to front from
+        bool                fSortViewValid; // fSortData is in back to front order from fSortViewPos
 
         plIcicle();
 
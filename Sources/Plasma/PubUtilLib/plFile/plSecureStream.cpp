@@ -39,12 +39,16 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
       Mead, WA   99021
 
 *==LICENSE==*/
+#include <algorithm>
 #include <string>
 #include <string_theory/format>
 #include <ctime>
+#include <mutex>
+#include <thread>
 
 #include "plSecureStream.h"
 #include "hsWindows.h"
+#include "hsWorkerPool.h"
 
 #if !HS_BUILD_FOR_WIN32
 #include <errno.h>
@@ -63,6 +67,33 @@ static const int kFileStartOffset = kMagicStringLen + sizeof(uint32_t);
 
 static const int kMaxBufferedFileSize = 10*1024;
 
+// Unbuffered reads decrypt this much of the file at a time (a multiple of
+// kEncryptChunkSize). Reads at least this big bypass the block altogether.
+static const uint32_t kDecryptBlockSize = 16*1024;
+static const uint32_t kNoBlock = 0xFFFFFFFF;
+
+// Don't bother waking the workers for less than this much data per thread
+static const size_t kMinParallelDecryptBytes = 256*1024;
+// How much each worker takes from a big buffer at a time
+static const size_t kParallelDecryptItemBytes = 64*1024;
+
+std::atomic<uint32_t> plSecureStream::fMaxDecryptThreads(0);
+
+// Shared by every stream. Whoever gets it first uses it, anybody else
+// reading at the same time deciphers on their own thread.
+static hsWorkerPool& GetDecryptPool(std::unique_lock<std::mutex>& lock)
+{
+    static std::mutex s_mutex;
+    static hsWorkerPool s_pool;
+    lock = std::unique_lock<std::mutex>(s_mutex, std::try_to_lock);
+    return s_pool;
+}
+
+static inline uint32_t PaddedSize(uint32_t size)
+{
+    return (size + kEncryptChunkSize - 1) & ~(kEncryptChunkSize - 1);
+}
+
 const char plSecureStream::kKeyFilename[] = "encryption.key";
 
 plSecureStream::plSecureStream(bool deleteOnExit, uint32_t* key) :
@@ -70,6 +101,7 @@ fRef(),
 fActualFileSize(),
 fBufferedStream(),
 fRAMStream(),
+fBlockStart(kNoBlock),
 fOpenMode(kOpenFail),
 fDeleteOnExit(deleteOnExit)
 {
@@ -84,6 +116,7 @@ fRef(),
 fActualFileSize(),
 fBufferedStream(),
 fRAMStream(),
+fBlockStart(kNoBlock),
 fOpenMode(kOpenFail),
 fDeleteOnExit(false)
 {
@@ -162,6 +195,42 @@ void plSecureStream::IDecipher(uint32_t* const v, uint32_t n)
     }
 }
 
+void plSecureStream::IDecipherChunks(uint8_t* data, size_t bytes)
+{
+    hsAssert(bytes % kEncryptChunkSize == 0, "Deciphering a partial chunk");
+    size_t numChunks = bytes / kEncryptChunkSize;
+
+    auto decipherRange = [this, data](size_t first, size_t last) {
+        for (size_t i = first; i < last; ++i)
+            IDecipher((uint32_t*)(data + i * kEncryptChunkSize), kEncryptChunkSize / sizeof(uint32_t));
+    };
+
+    // Every chunk is enciphered on its own, so big buffers split cleanly
+    // across as many threads as we care to throw at them.
+    uint32_t maxThreads = fMaxDecryptThreads;
+    uint32_t poolThreads = maxThreads ? maxThreads : std::max(std::thread::hardware_concurrency(), 1U);
+    if (std::min<size_t>(poolThreads, bytes / kMinParallelDecryptBytes) <= 1) {
+        decipherRange(0, numChunks);
+        return;
+    }
+
+    std::unique_lock<std::mutex> poolLock;
+    hsWorkerPool& pool = GetDecryptPool(poolLock);
+    if (!poolLock.owns_lock()) {
+        decipherRange(0, numChunks);
+        return;
+    }
+
+    size_t chunksPerItem = kParallelDecryptItemBytes / kEncryptChunkSize;
+    size_t numItems = (numChunks + chunksPerItem - 1) / chunksPerItem;
+    // Always the same thread count, so the pool doesn't restart its workers
+    // for every different buffer size; small buffers just have fewer items.
+    pool.Run(numItems, poolThreads, [&](size_t item) {
+        size_t first = item * chunksPerItem;
+        decipherRange(first, std::min(numChunks, first + chunksPerItem));
+    });
+}
+
 bool plSecureStream::Open(const plFileName& name, const char* mode)
 {
     if (strcmp(mode, "rb") == 0)
@@ -216,7 +285,10 @@ bool plSecureStream::Open(const plFileName& name, const char* mode)
             fRef = INVALID_HANDLE_VALUE;
             return false;
         }
+
+        fread(&fActualFileSize, sizeof(uint32_t), 1, fRef);
 #endif
+        fBlockStart = kNoBlock;
 
         // The encrypted stream is inefficient if you do reads smaller than
         // 8 bytes.  Since we do a lot of those, any file under a size threshold
@@ -255,27 +327,18 @@ bool plSecureStream::Open(hsStream* stream)
         return false;
 
     fActualFileSize = stream->ReadLE32();
-    uint32_t trimSize = kMagicStringLen + sizeof(uint32_t) + fActualFileSize;
-    fRAMStream = std::make_unique<hsRAMStream>();
-    while (!stream->AtEnd())
-    {
-        // Don't write out any garbage
-        uint32_t size;
-        if ((trimSize - stream->GetPosition()) < kEncryptChunkSize)
-            size = (trimSize - stream->GetPosition());
-        else
-            size = kEncryptChunkSize;
 
-        uint8_t buf[kEncryptChunkSize];
-        stream->Read(kEncryptChunkSize, &buf);
-        IDecipher((uint32_t*)&buf, kEncryptChunkSize / sizeof(uint32_t));
-        fRAMStream->Write(size, &buf);
-    }
+    // Pull in everything at once and decipher it in bulk
+    std::vector<uint8_t> data(PaddedSize(fActualFileSize));
+    uint32_t numRead = stream->Read(uint32_t(data.size()), data.data());
+    data.resize(numRead - (numRead % kEncryptChunkSize));
+    IDecipherChunks(data.data(), data.size());
+
+    // Don't keep any of the padding
+    data.resize(std::min(data.size(), size_t(fActualFileSize)));
 
     stream->SetPosition(pos);
-    fRAMStream->Rewind();
-    fPosition = 0;
-    fBufferedStream = true;
+    IBufferDecrypted(std::move(data));
     fOpenMode = kOpenRead;
     return true;
 }
@@ -290,10 +353,9 @@ uint32_t plSecureStream::IRead(uint32_t bytes, void* buffer)
     bool success = ReadFile(fRef, buffer, bytes, &numItemsDword, nullptr);
     numItems = numItemsDword;
 #elif HS_BUILD_FOR_UNIX
-    numItems = fread(buffer, bytes, 1, fRef);
-    bool success = numItems != 0;
+    numItems = fread(buffer, 1, bytes, fRef);
+    bool success = !ferror(fRef);
 #endif
-    fPosition += numItems;
     if (numItems < bytes)
     {
         if (!success)
@@ -308,24 +370,75 @@ uint32_t plSecureStream::IRead(uint32_t bytes, void* buffer)
     return static_cast<uint32_t>(numItems);
 }
 
+bool plSecureStream::ISeekEncrypted(uint32_t offset)
+{
+    if (fRef == INVALID_HANDLE_VALUE)
+        return false;
+#if HS_BUILD_FOR_WIN32
+    return SetFilePointer(fRef, kFileStartOffset + offset, nullptr, FILE_BEGIN) != INVALID_SET_FILE_POINTER;
+#elif HS_BUILD_FOR_UNIX
+    return fseek(fRef, kFileStartOffset + offset, SEEK_SET) == 0;
+#endif
+}
+
+bool plSecureStream::ILoadBlock(uint32_t position)
+{
+    uint32_t blockStart = position - (position % kDecryptBlockSize);
+    if (blockStart == fBlockStart)
+        return true;
+
+    fBlockStart = kNoBlock;
+    if (blockStart >= fActualFileSize)
+        return false;
+
+    // The file is padded out to a whole chunk, so the padded read is safe
+    uint32_t plainBytes = std::min(kDecryptBlockSize, fActualFileSize - blockStart);
+    fBlock.resize(PaddedSize(plainBytes));
+    if (!ISeekEncrypted(blockStart) || IRead(uint32_t(fBlock.size()), fBlock.data()) != fBlock.size())
+        return false;
+
+    IDecipherChunks(fBlock.data(), fBlock.size());
+    fBlock.resize(plainBytes);
+    fBlockStart = blockStart;
+    return true;
+}
+
+uint32_t plSecureStream::IReadDirect(uint32_t bytes, void* buffer)
+{
+    // Only whole chunks can be deciphered in place
+    bytes -= bytes % kEncryptChunkSize;
+    if (!ISeekEncrypted(fPosition))
+        return 0;
+
+    uint32_t numRead = IRead(bytes, buffer);
+    numRead -= numRead % kEncryptChunkSize;
+    IDecipherChunks(static_cast<uint8_t*>(buffer), numRead);
+    return numRead;
+}
+
 void plSecureStream::IBufferFile()
 {
-    fRAMStream = std::make_unique<hsRAMStream>();
-    char buf[1024];
-    while (!AtEnd())
-    {
-        uint32_t numRead = Read(1024, buf);
-        fRAMStream->Write(numRead, buf);
-    }
-    fRAMStream->Rewind();
+    // Read and decipher the whole thing in one go
+    std::vector<uint8_t> data(PaddedSize(fActualFileSize));
+    uint32_t numRead = ISeekEncrypted(0) ? IRead(uint32_t(data.size()), data.data()) : 0;
+    data.resize(numRead - (numRead % kEncryptChunkSize));
+    IDecipherChunks(data.data(), data.size());
+    data.resize(std::min(data.size(), size_t(fActualFileSize)));
+    IBufferDecrypted(std::move(data));
 
-    fBufferedStream = true;
 #if HS_BUILD_FOR_WIN32
     CloseHandle(fRef);
 #elif HS_BUILD_FOR_UNIX
     fclose(fRef);
 #endif
     fRef = INVALID_HANDLE_VALUE;
+}
+
+void plSecureStream::IBufferDecrypted(std::vector<uint8_t> data)
+{
+    fBufferedData = std::move(data);
+    fRAMStream = std::make_unique<hsReadOnlyStream>(int(fBufferedData.size()), fBufferedData.data());
+    fBufferedStream = true;
     fPosition = 0;
 }
 
@@ -334,24 +447,25 @@ bool plSecureStream::AtEnd()
     if (fBufferedStream)
         return fRAMStream->AtEnd();
     else
-        return (GetPosition() == fActualFileSize);
+        return (GetPosition() >= fActualFileSize);
 }
 
 void plSecureStream::Skip(uint32_t delta)
 {
     if (fBufferedStream)
     {
+        uint32_t pos = fRAMStream->GetPosition();
+        uint32_t eof = fRAMStream->GetEOF();
+        if (fOpenMode == kOpenRead)
+            delta = std::min(delta, pos < eof ? eof - pos : 0);
+
         fRAMStream->Skip(delta);
         fPosition = fRAMStream->GetPosition();
     }
     else if (fRef != INVALID_HANDLE_VALUE)
     {
+        // Nothing is read until the next Read() needs it
         fPosition += delta;
-#if HS_BUILD_FOR_WIN32
-        SetFilePointer(fRef, delta, nullptr, FILE_CURRENT);
-#elif HS_BUILD_FOR_UNIX
-        fseek(fRef, delta, SEEK_CUR);
-#endif
     }
 }
 
@@ -365,11 +479,6 @@ void plSecureStream::Rewind()
     else if (fRef != INVALID_HANDLE_VALUE)
     {
         fPosition = 0;
-#if HS_BUILD_FOR_WIN32
-        SetFilePointer(fRef, kFileStartOffset, nullptr, FILE_BEGIN);
-#elif HS_BUILD_FOR_UNIX
-        fseek(fRef, kFileStartOffset, SEEK_SET);
-#endif
     }
 }
 
@@ -382,11 +491,7 @@ void plSecureStream::FastFwd()
     }
     else if (fRef != INVALID_HANDLE_VALUE)
     {
-#if HS_BUILD_FOR_WIN32
-        fPosition = SetFilePointer(fRef, kFileStartOffset + fActualFileSize, nullptr, FILE_BEGIN);
-#elif HS_BUILD_FOR_UNIX
-        fPosition = fseek(fRef, 0, SEEK_END);
-#endif
+        fPosition = fActualFileSize;
     }
 }
 
@@ -409,70 +514,45 @@ uint32_t plSecureStream::Read(uint32_t bytes, void* buffer)
 {
     if (fBufferedStream)
     {
+        // Short reads at the end are fine, like they are for unbuffered files
+        uint32_t pos = fRAMStream->GetPosition();
+        uint32_t eof = fRAMStream->GetEOF();
+        bytes = std::min(bytes, pos < eof ? eof - pos : 0);
+
         uint32_t numRead = fRAMStream->Read(bytes, buffer);
         fPosition = fRAMStream->GetPosition();
         return numRead;
     }
 
-    uint32_t startPos = fPosition;
-
-    // Offset into the first buffer (0 if we are aligned on a chunk, which means no extra block read)
-    uint32_t startChunkPos = startPos % kEncryptChunkSize;
-    // Amount of data in the partial first chunk (0 if we're aligned)
-    uint32_t startAmt = (startChunkPos != 0) ? std::min(kEncryptChunkSize - startChunkPos, bytes) : 0;
-
-    uint32_t totalNumRead = IRead(bytes, buffer);
-
-    uint32_t numMidChunks = (totalNumRead - startAmt) / kEncryptChunkSize;
-    uint32_t endAmt = (totalNumRead - startAmt) % kEncryptChunkSize;
+    if (fPosition >= fActualFileSize)
+        return 0;
+    bytes = std::min(bytes, fActualFileSize - fPosition);
 
-    // If the start position is in the middle of a chunk we need to rewind and
-    // read that whole chunk in and decrypt it.
-    if (startChunkPos != 0)
+    uint8_t* dest = static_cast<uint8_t*>(buffer);
+    uint32_t totalNumRead = 0;
+    while (totalNumRead < bytes)
     {
-        // Move to the start of this chunk
-        SetPosition(startPos-startChunkPos);
-
-        // Read in the chunk and decrypt it
-        char buf[kEncryptChunkSize];
-        (void)IRead(kEncryptChunkSize, &buf);   // numRead
-        IDecipher((uint32_t*)&buf, kEncryptChunkSize / sizeof(uint32_t));
+        uint32_t left = bytes - totalNumRead;
 
-        // Copy the relevant portion to the output buffer
-        memcpy(buffer, &buf[startChunkPos], startAmt);
-
-        SetPosition(startPos+totalNumRead);
-    }
-
-    if (numMidChunks != 0)
-    {
-        uint32_t* bufferPos = (uint32_t*)(((char*)buffer)+startAmt);
-        for (int i = 0; i < numMidChunks; i++)
+        // Big chunk-aligned reads are deciphered right where they land
+        if ((fPosition % kEncryptChunkSize) == 0 && left >= kDecryptBlockSize)
         {
-            // Decrypt chunk
-            IDecipher(bufferPos, kEncryptChunkSize / sizeof(uint32_t));
-            bufferPos += (kEncryptChunkSize / sizeof(uint32_t));
+            uint32_t numRead = IReadDirect(left, dest + totalNumRead);
+            if (numRead == 0)
+                break;
+            totalNumRead += numRead;
+            fPosition += numRead;
+            continue;
         }
-    }
 
-    if (endAmt != 0)
-    {
-        // Read in the final chunk and decrypt it
-        char buf[kEncryptChunkSize];
-        SetPosition(startPos + startAmt + numMidChunks*kEncryptChunkSize);
-        (void)IRead(kEncryptChunkSize, &buf);   // numRead
-        IDecipher((uint32_t*)&buf, kEncryptChunkSize / sizeof(uint32_t));
-
-        memcpy(((char*)buffer)+totalNumRead-endAmt, &buf, endAmt);
+        if (!ILoadBlock(fPosition))
+            break;
 
-        SetPosition(startPos+totalNumRead);
-    }
-
-    // If we read into the padding at the end, update the total read to not include that
-    if (totalNumRead > 0 && startPos + totalNumRead > fActualFileSize)
-    {
-        totalNumRead -= (startPos + totalNumRead) - fActualFileSize;
-        SetPosition(fActualFileSize);
+        uint32_t offset = fPosition - fBlockStart;
+        uint32_t amt = std::min(left, uint32_t(fBlock.size()) - offset);
+        memcpy(dest + totalNumRead, fBlock.data() + offset, amt);
+        totalNumRead += amt;
+        fPosition += amt;
     }
 
     return totalNumRead;
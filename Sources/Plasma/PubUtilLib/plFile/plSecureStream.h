@@ -45,7 +45,9 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 #include "HeadSpin.h"
 #include "hsStream.h"
 
+#include <atomic>
 #include <memory>
+#include <vector>
 
 #if HS_BUILD_FOR_WIN32
     typedef void* HANDLE;
@@ -70,6 +72,12 @@ protected:
     bool fBufferedStream;
 
     std::unique_ptr<hsStream> fRAMStream;
+    std::vector<uint8_t> fBufferedData; // decrypted contents backing fRAMStream when reading
+
+    // Unbuffered reads decrypt the file one block at a time, so only the
+    // parts of the file that are actually read ever get deciphered.
+    std::vector<uint8_t> fBlock;
+    uint32_t fBlockStart;               // plaintext offset of fBlock, kNoBlock if empty
 
     plFileName fWriteFileName;
 
@@ -79,11 +87,16 @@ protected:
     bool fDeleteOnExit;
 
     void IBufferFile();
+    void IBufferDecrypted(std::vector<uint8_t> data);
 
     uint32_t IRead(uint32_t bytes, void* buffer);
+    bool ISeekEncrypted(uint32_t offset);
+    bool ILoadBlock(uint32_t position);
+    uint32_t IReadDirect(uint32_t bytes, void* buffer);
 
     void IEncipher(uint32_t* const v, uint32_t n);
     void IDecipher(uint32_t* const v, uint32_t n);
+    void IDecipherChunks(uint8_t* data, size_t bytes);
 
     bool IWriteEncrypted(hsStream* sourceStream, const plFileName& outputFile);
 
@@ -114,6 +127,11 @@ public:
 
     uint32_t GetActualFileSize() const {return fActualFileSize;}
 
+    // Large reads are deciphered on up to this many threads at once.
+    // 0 (the default) picks based on the number of cores, 1 disables it.
+    static void SetMaxDecryptThreads(uint32_t threads) { fMaxDecryptThreads = threads; }
+    static uint32_t GetMaxDecryptThreads() { return fMaxDecryptThreads; }
+
     static bool FileEncrypt(const plFileName& fileName, uint32_t* key = nullptr);
     static bool FileDecrypt(const plFileName& fileName, uint32_t* key = nullptr);
 
@@ -138,6 +156,9 @@ public:
     static bool GetSecureEncryptionKey(const plFileName& filename, uint32_t* key, unsigned length);
 
     static const char kKeyFilename[];
+
+private:
+    static std::atomic<uint32_t> fMaxDecryptThreads;
 };
 
 #endif // plSecureStream_h_inc
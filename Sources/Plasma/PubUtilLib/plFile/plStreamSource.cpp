@@ -78,6 +78,7 @@ hsStream* plStreamSource::GetFile(const plFileName& filename)
             fFileData[sFilename].fFilename = sFilename;
             fFileData[sFilename].fDir = sFilename.StripFileName();
             fFileData[sFilename].fExt = sFilename.GetFileExt();
+            fFileData[sFilename].fFromDisk = true;
             if (plSecureStream::IsSecureFile(filename))
             {
                 std::unique_ptr<hsStream> ss;
@@ -101,6 +102,14 @@ hsStream* plStreamSource::GetFile(const plFileName& filename)
     return fFileData[sFilename].fStream.get();
 }
 
+bool plStreamSource::IsDiskFile(const plFileName& filename)
+{
+    hsLockGuard(fMutex);
+
+    auto it = fFileData.find(filename.Normalize('/'));
+    return it != fFileData.end() && it->second.fFromDisk;
+}
+
 std::vector<plFileName> plStreamSource::GetListOfNames(const plFileName& dir, const ST::string& ext)
 {
     plFileName sDir = dir.Normalize('/');
@@ -59,6 +59,9 @@ private:
         plFileName      fDir; // parent directory
         ST::string      fExt;
         std::unique_ptr<hsStream> fStream;
+        bool            fFromDisk; // opened by us rather than handed over with InsertFile
+
+        fileData() : fFromDisk() { }
     };
     std::map<plFileName, fileData, plFileName::less_i> fFileData; // key is filename
     std::mutex fMutex;
@@ -77,6 +80,10 @@ public:
     hsStream* GetFile(const plFileName& filename); // internal builds will read from disk if it doesn't exist
     std::vector<plFileName> GetListOfNames(const plFileName& dir, const ST::string& ext); // internal builds merge from disk
 
+    // True if GetFile opened this file straight off the disk (internal builds only),
+    // rather than it being handed to us by the preloader
+    bool IsDiskFile(const plFileName& filename);
+
     // For other classes to insert files (takes ownership of the stream if successful)
     bool InsertFile(const plFileName& filename, std::unique_ptr<hsStream>&& stream);
 
@@ -888,7 +888,6 @@ void    hsDXTSoftwareCodec::IUncompressMipmapDXT5To16Weird( plMipmap *destBMap,
 void    hsDXTSoftwareCodec::IUncompressMipmapDXT5To32( plMipmap *destBMap, plMipmap *srcBMap )
 {
     uint16_t      *srcData;
-    uint32_t      *destData, destBlock[ 16 ];
     uint32_t      blockSize;
     uint32_t      x, y, bMapStride;
     uint32_t      colors[ 4 ];
@@ -992,42 +991,11 @@ void    hsDXTSoftwareCodec::IUncompressMipmapDXT5To32( plMipmap *destBMap, plMip
         
         cBitSrc1 = hsToLE16( srcData[ 2 ] );
         cBitSrc2 = hsToLE16( srcData[ 3 ] );
-        
-        for( j = 0; j < 8; j++ )
-        {
-            destBlock[ j ] = alphas[ aBitSrc1 & 0x07 ] | colors[ cBitSrc1 & 0x03 ];
-            aBitSrc1 >>= 3;
-            cBitSrc1 >>= 2;
-            destBlock[ j + 8 ] = alphas[ aBitSrc2 & 0x07 ] | colors[ cBitSrc2 & 0x03 ];
-            aBitSrc2 >>= 3;
-            cBitSrc2 >>= 2;
 
-            destBlock[ j ] = hsToLE32( destBlock[ j ] );
-            destBlock[ j + 8 ] = hsToLE32( destBlock[ j + 8 ] );
-        }
-        
-        /// Now copy the block to the destination bitmap
-        /// (Trust me, this is actually *faster* than memcpy for some reason
-        destData = destBMap->GetAddr32( x, y );
-        destData[ 0 ] = destBlock[ 0 ];
-        destData[ 1 ] = destBlock[ 1 ];
-        destData[ 2 ] = destBlock[ 2 ];
-        destData[ 3 ] = destBlock[ 3 ];
-        destData += bMapStride;
-        destData[ 0 ] = destBlock[ 4 ];
-        destData[ 1 ] = destBlock[ 5 ];
-        destData[ 2 ] = destBlock[ 6 ];
-        destData[ 3 ] = destBlock[ 7 ];
-        destData += bMapStride;
-        destData[ 0 ] = destBlock[ 8 ];
-        destData[ 1 ] = destBlock[ 9 ];
-        destData[ 2 ] = destBlock[ 10 ];
-        destData[ 3 ] = destBlock[ 11 ];
-        destData += bMapStride;
-        destData[ 0 ] = destBlock[ 12 ];
-        destData[ 1 ] = destBlock[ 13 ];
-        destData[ 2 ] = destBlock[ 14 ];
-        destData[ 3 ] = destBlock[ 15 ];
+        /// Expand the 16 pixels straight into the destination bitmap
+        expand_block32.call( destBMap->GetAddr32( x, y ), bMapStride, colors,
+                             (uint32_t)cBitSrc1 | ( (uint32_t)cBitSrc2 << 16 ),
+                             alphas, (uint64_t)aBitSrc1 | ( (uint64_t)aBitSrc2 << 24 ) );
 
         /// Increment and loop!
         srcData += blockSize - 4;       /// JUUUST in case our block size is diff
@@ -1401,11 +1369,10 @@ void    hsDXTSoftwareCodec::IUncompressMipmapDXT1To32( plMipmap *destBMap,
                                                    plMipmap *srcBMap )
 {
     uint16_t      *srcData, tempW1, tempW2;
-    uint32_t      *destData, destBlock[ 16 ];
     uint32_t      blockSize;
     uint32_t      bitSource, bitSource2, x, y, bMapStride;
     uint32_t      colors[ 4 ];
-    int32_t       numBlocks, i, j;
+    int32_t       numBlocks, i;
 
 
     /// Setup some nifty stuff
@@ -1447,39 +1414,9 @@ void    hsDXTSoftwareCodec::IUncompressMipmapDXT1To32( plMipmap *destBMap,
         bitSource = hsToLE16( srcData[ 2 ] );
         bitSource2 = hsToLE16( srcData[ 3 ] );
 
-        for( j = 0; j < 8; j++ )
-        {
-            destBlock[ j ] = colors[ bitSource & 0x03 ];
-            bitSource >>= 2;
-            destBlock[ j + 8 ] = colors[ bitSource2 & 0x03 ];
-            bitSource2 >>= 2;
-
-            destBlock[ j ] = hsToLE32( destBlock[ j ] );
-            destBlock[ j + 8 ] = hsToLE32( destBlock[ j + 8 ] );
-        }
-        
-        /// Now copy the block to the destination bitmap
-        /// (Trust me, this is actually *faster* than memcpy for some reason
-        destData = destBMap->GetAddr32( x, y );
-        destData[ 0 ] = destBlock[ 0 ];
-        destData[ 1 ] = destBlock[ 1 ];
-        destData[ 2 ] = destBlock[ 2 ];
-        destData[ 3 ] = destBlock[ 3 ];
-        destData += bMapStride;
-        destData[ 0 ] = destBlock[ 4 ];
-        destData[ 1 ] = destBlock[ 5 ];
-        destData[ 2 ] = destBlock[ 6 ];
-        destData[ 3 ] = destBlock[ 7 ];
-        destData += bMapStride;
-        destData[ 0 ] = destBlock[ 8 ];
-        destData[ 1 ] = destBlock[ 9 ];
-        destData[ 2 ] = destBlock[ 10 ];
-        destData[ 3 ] = destBlock[ 11 ];
-        destData += bMapStride;
-        destData[ 0 ] = destBlock[ 12 ];
-        destData[ 1 ] = destBlock[ 13 ];
-        destData[ 2 ] = destBlock[ 14 ];
-        destData[ 3 ] = destBlock[ 15 ];
+        /// Expand the 16 pixels straight into the destination bitmap
+        expand_block32.call( destBMap->GetAddr32( x, y ), bMapStride, colors,
+                             bitSource | ( bitSource2 << 16 ), nullptr, 0 );
 
         /// Increment and loop!
         srcData += blockSize;
@@ -1492,6 +1429,46 @@ void    hsDXTSoftwareCodec::IUncompressMipmapDXT1To32( plMipmap *destBMap,
     }
 }
 
+//// expand_block32 //////////////////////////////////////////////////////////
+//
+//  Shared tail of the 32-bit decoders: looks up each pixel's palette entries
+//  and writes the 4x4 block. Every path must produce exactly what the scalar
+//  one does, since they only differ in how the lookups are done.
+
+void    hsDXTSoftwareCodec::expand_block32_fpu( uint32_t *dest, uint32_t stride,
+                                                const uint32_t colors[ 4 ], uint32_t colorBits,
+                                                const uint32_t *alphas, uint64_t alphaBits )
+{
+    for( int y = 0; y < 4; y++ )
+    {
+        for( int x = 0; x < 4; x++ )
+        {
+            uint32_t pixel = colors[ colorBits & 0x03 ];
+            colorBits >>= 2;
+            if( alphas != nullptr )
+            {
+                pixel |= alphas[ alphaBits & 0x07 ];
+                alphaBits >>= 3;
+            }
+            dest[ x ] = hsToLE32( pixel );
+        }
+        dest += stride;
+    }
+}
+
+// CPU-optimized functions requiring dispatch
+hsCpuFunctionDispatcher<hsDXTSoftwareCodec::expand_block32_ptr> hsDXTSoftwareCodec::expand_block32 {
+    &hsDXTSoftwareCodec::expand_block32_fpu,
+    nullptr,            // SSE1
+    &hsDXTSoftwareCodec::expand_block32_sse2,
+    nullptr,            // SSE3
+    nullptr,            // SSSE3
+    nullptr,            // SSE41
+    nullptr,            // SSE42
+    nullptr,            // AVX
+    &hsDXTSoftwareCodec::expand_block32_avx2
+};
+
 //// IUncompressMipmapDXT1ToInten /////////////////////////////////////////////
 //
 //  UncompressBitmap internal call for DXT1 compression. DXT1 is a simple on/off
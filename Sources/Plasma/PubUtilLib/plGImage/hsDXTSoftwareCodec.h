@@ -44,6 +44,7 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 
 #include "HeadSpin.h"
 #include "hsCodec.h"
+#include "hsCpuID.h"
 
 class plMipmap;
 typedef struct hsColor32 hsRGBAColor32;
@@ -66,6 +67,25 @@ public:
     // Colorize a compressed mipmap
     bool    ColorizeCompMipmap(plMipmap *bMap, const uint8_t *colorMask) override;
 
+    // Expands one 4x4 block of palette indices into RGB8888 pixels, given the
+    // already decoded color (and optionally DXT5 alpha) palettes. colorBits
+    // holds 2 bits and alphaBits 3 bits per pixel, in raster order. alphas is
+    // nullptr for DXT1, whose colors already carry their alpha.
+    typedef void(*expand_block32_ptr)(uint32_t* dest, uint32_t stride,
+                                      const uint32_t colors[4], uint32_t colorBits,
+                                      const uint32_t* alphas, uint64_t alphaBits);
+    static hsCpuFunctionDispatcher<expand_block32_ptr> expand_block32;
+
+    static void expand_block32_fpu(uint32_t* dest, uint32_t stride,
+                                   const uint32_t colors[4], uint32_t colorBits,
+                                   const uint32_t* alphas, uint64_t alphaBits);
+    static void expand_block32_sse2(uint32_t* dest, uint32_t stride,
+                                    const uint32_t colors[4], uint32_t colorBits,
+                                    const uint32_t* alphas, uint64_t alphaBits);
+    static void expand_block32_avx2(uint32_t* dest, uint32_t stride,
+                                    const uint32_t colors[4], uint32_t colorBits,
+                                    const uint32_t* alphas, uint64_t alphaBits);
+
 private:
     enum {
         kFourColorEncoding,
@@ -0,0 +1,80 @@
+/*==LICENSE==*
+
+CyanWorlds.com Engine - MMOG client, server and tools
+Copyright (C) 2011  Cyan Worlds, Inc.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Additional permissions under GNU GPL version 3 section 7
+
+If you modify this Program, or any covered work, by linking or
+combining it with any of RAD Game Tools Bink SDK, Autodesk 3ds Max SDK,
+NVIDIA PhysX SDK, Microsoft DirectX SDK, OpenSSL library, Independent
+JPEG Group JPEG library, Microsoft Windows Media SDK, or Apple QuickTime SDK
+(or a modified version of those libraries),
+containing parts covered by the terms of the Bink SDK EULA, 3ds Max EULA,
+PhysX SDK EULA, DirectX SDK EULA, OpenSSL and SSLeay licenses, IJG
+JPEG Library README, Windows Media SDK EULA, or QuickTime SDK EULA, the
+licensors of this Program grant you additional
+permission to convey the resulting work. Corresponding Source for a
+non-source form of such a combination shall include the source code for
+the parts of OpenSSL and IJG JPEG Library used as well as that of the covered
+work.
+
+You can contact Cyan Worlds, Inc. by email legal@cyan.com
+ or by snail mail at:
+      Cyan Worlds, Inc.
+      14617 N Newport Hwy
+      Mead, WA   99021
+
+*==LICENSE==*/
+
+#include "hsDXTSoftwareCodec.h"
+
+#ifdef HAVE_AVX2
+#   include <immintrin.h>
+#endif
+
+// Two rows per pass: per-lane shifts pull out each pixel's index, and the
+// palettes (4 colors repeated, or all 8 alphas) fit a single permute.
+void hsDXTSoftwareCodec::expand_block32_avx2(uint32_t* dest, uint32_t stride,
+                                             const uint32_t colors[4], uint32_t colorBits,
+                                             const uint32_t* alphas, uint64_t alphaBits)
+{
+#ifdef HAVE_AVX2
+    const __m256i colorShift = _mm256_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14);
+    const __m256i alphaShift = _mm256_setr_epi32(0, 3, 6, 9, 12, 15, 18, 21);
+    const __m256i colorPal = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(colors)));
+    __m256i alphaPal = _mm256_setzero_si256();
+    if (alphas)
+        alphaPal = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(alphas));
+
+    for (int y = 0; y < 4; y += 2) {
+        __m256i idx = _mm256_srlv_epi32(_mm256_set1_epi32(colorBits & 0xFFFF), colorShift);
+        __m256i pixels = _mm256_permutevar8x32_epi32(colorPal, _mm256_and_si256(idx, _mm256_set1_epi32(0x03)));
+        colorBits >>= 16;
+
+        if (alphas) {
+            idx = _mm256_srlv_epi32(_mm256_set1_epi32((uint32_t)(alphaBits & 0xFFFFFF)), alphaShift);
+            pixels = _mm256_or_si256(pixels, _mm256_permutevar8x32_epi32(alphaPal, _mm256_and_si256(idx, _mm256_set1_epi32(0x07))));
+            alphaBits >>= 24;
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm256_castsi256_si128(pixels));
+        dest += stride;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm256_extracti128_si256(pixels, 1));
+        dest += stride;
+    }
+#endif
+}
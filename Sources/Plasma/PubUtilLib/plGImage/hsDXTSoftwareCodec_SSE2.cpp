@@ -0,0 +1,91 @@
+/*==LICENSE==*
+
+CyanWorlds.com Engine - MMOG client, server and tools
+Copyright (C) 2011  Cyan Worlds, Inc.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Additional permissions under GNU GPL version 3 section 7
+
+If you modify this Program, or any covered work, by linking or
+combining it with any of RAD Game Tools Bink SDK, Autodesk 3ds Max SDK,
+NVIDIA PhysX SDK, Microsoft DirectX SDK, OpenSSL library, Independent
+JPEG Group JPEG library, Microsoft Windows Media SDK, or Apple QuickTime SDK
+(or a modified version of those libraries),
+containing parts covered by the terms of the Bink SDK EULA, 3ds Max EULA,
+PhysX SDK EULA, DirectX SDK EULA, OpenSSL and SSLeay licenses, IJG
+JPEG Library README, Windows Media SDK EULA, or QuickTime SDK EULA, the
+licensors of this Program grant you additional
+permission to convey the resulting work. Corresponding Source for a
+non-source form of such a combination shall include the source code for
+the parts of OpenSSL and IJG JPEG Library used as well as that of the covered
+work.
+
+You can contact Cyan Worlds, Inc. by email legal@cyan.com
+ or by snail mail at:
+      Cyan Worlds, Inc.
+      14617 N Newport Hwy
+      Mead, WA   99021
+
+*==LICENSE==*/
+
+#include "hsDXTSoftwareCodec.h"
+
+#ifdef HAVE_SSE2
+#   include <emmintrin.h>
+#endif
+
+// SSE2 has no per-lane shifts or shuffles, so each row's palette indices are
+// masked in place and matched against every possible index instead.
+void hsDXTSoftwareCodec::expand_block32_sse2(uint32_t* dest, uint32_t stride,
+                                             const uint32_t colors[4], uint32_t colorBits,
+                                             const uint32_t* alphas, uint64_t alphaBits)
+{
+#ifdef HAVE_SSE2
+    const __m128i colorMask = _mm_setr_epi32(0x03, 0x03 << 2, 0x03 << 4, 0x03 << 6);
+    const __m128i alphaMask = _mm_setr_epi32(0x07, 0x07 << 3, 0x07 << 6, 0x07 << 9);
+
+    __m128i colorIdx[4], colorPal[4];
+    for (int i = 0; i < 4; i++) {
+        colorIdx[i] = _mm_setr_epi32(i, i << 2, i << 4, i << 6);
+        colorPal[i] = _mm_set1_epi32(colors[i]);
+    }
+
+    __m128i alphaIdx[8], alphaPal[8];
+    if (alphas) {
+        for (int i = 0; i < 8; i++) {
+            alphaIdx[i] = _mm_setr_epi32(i, i << 3, i << 6, i << 9);
+            alphaPal[i] = _mm_set1_epi32(alphas[i]);
+        }
+    }
+
+    for (int y = 0; y < 4; y++) {
+        __m128i bits = _mm_and_si128(_mm_set1_epi32(colorBits & 0xFF), colorMask);
+        __m128i pixels = _mm_setzero_si128();
+        for (int i = 0; i < 4; i++)
+            pixels = _mm_or_si128(pixels, _mm_and_si128(colorPal[i], _mm_cmpeq_epi32(bits, colorIdx[i])));
+        colorBits >>= 8;
+
+        if (alphas) {
+            bits = _mm_and_si128(_mm_set1_epi32((uint32_t)(alphaBits & 0xFFF)), alphaMask);
+            for (int i = 0; i < 8; i++)
+                pixels = _mm_or_si128(pixels, _mm_and_si128(alphaPal[i], _mm_cmpeq_epi32(bits, alphaIdx[i])));
+            alphaBits >>= 12;
+        }
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), pixels);
+        dest += stride;
+    }
+#endif
+}
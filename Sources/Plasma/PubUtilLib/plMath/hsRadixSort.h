@@ -43,6 +43,13 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 #ifndef hsRadixSort_inc
 #define hsRadixSort_inc
 
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Linked list radix sort. Kept for the exporter and the space tree maker;
+// new code should use hsArrayRadixSort below.
 class hsRadixSortElem 
 {
 public:
@@ -88,4 +95,117 @@ public:
 
 };
 
+//// hsArrayRadixSort ////////////////////////////////////////////////////////
+//  LSD radix sort over a contiguous array of 32 bit keys (float, signed or
+//  unsigned int), producing the order as indices into the key array. The sort
+//  is stable in both directions. All the digit histograms are built in a
+//  single pre-pass, which also lets us skip any digit that is the same for
+//  every key. kDigitBits of 8 takes four passes over 256 buckets; 11 takes
+//  three over 2048, which wins once there are enough keys to fill the buckets.
+//  Scratch is kept between calls, so keep the sorter around.
+
+template <typename KeyT, uint32_t kDigitBits = 8>
+class hsArrayRadixSort
+{
+    static_assert(sizeof(KeyT) == sizeof(uint32_t), "Only 32 bit keys are supported");
+    static_assert(kDigitBits >= 4 && kDigitBits <= 16, "Unreasonable digit size");
+
+    static constexpr uint32_t kNumBuckets = 1 << kDigitBits;
+    static constexpr uint32_t kNumPasses = (32 + kDigitBits - 1) / kDigitBits;
+
+    std::vector<uint32_t> fKeys;
+    std::vector<uint32_t> fKeyScratch;
+    std::vector<uint32_t> fOrder;
+    std::vector<uint32_t> fOrderScratch;
+    std::vector<uint32_t> fHist;
+
+    // Maps a key onto an unsigned int that compares the same way.
+    static uint32_t IToSortable(KeyT key)
+    {
+        uint32_t bits;
+        memcpy(&bits, &key, sizeof(bits));
+        if constexpr (std::is_floating_point_v<KeyT>)
+            return bits ^ ((uint32_t)((int32_t)bits >> 31) | 0x80000000);
+        else if constexpr (std::is_signed_v<KeyT>)
+            return bits ^ 0x80000000;
+        else
+            return bits;
+    }
+
+public:
+    // Returns the indices of keys in ascending (or descending, if reverse)
+    // key order. Valid until the next call.
+    const uint32_t* Sort(const KeyT* keys, size_t count, bool reverse = false)
+    {
+        fKeys.resize(count);
+        fKeyScratch.resize(count);
+        fOrder.resize(count);
+        fOrderScratch.resize(count);
+        fHist.assign(kNumPasses * kNumBuckets, 0);
+
+        for (size_t i = 0; i < count; i++)
+        {
+            uint32_t key = IToSortable(keys[i]);
+            fKeys[i] = key;
+            fOrder[i] = (uint32_t)i;
+            for (uint32_t pass = 0; pass < kNumPasses; pass++)
+                fHist[pass * kNumBuckets + ((key >> (pass * kDigitBits)) & (kNumBuckets - 1))]++;
+        }
+
+        uint32_t* keyIn = fKeys.data();
+        uint32_t* keyOut = fKeyScratch.data();
+        uint32_t* orderIn = fOrder.data();
+        uint32_t* orderOut = fOrderScratch.data();
+
+        for (uint32_t pass = 0; pass < kNumPasses && count > 1; pass++)
+        {
+            const uint32_t shift = pass * kDigitBits;
+            uint32_t* counts = &fHist[pass * kNumBuckets];
+
+            // Every key has the same digit here, so this pass wouldn't move anything.
+            if (counts[(keyIn[0] >> shift) & (kNumBuckets - 1)] == count)
+                continue;
+
+            uint32_t offset = 0;
+            if (reverse)
+            {
+                for (uint32_t b = kNumBuckets; b-- > 0; )
+                {
+                    uint32_t n = counts[b];
+                    counts[b] = offset;
+                    offset += n;
+                }
+            }
+            else
+            {
+                for (uint32_t b = 0; b < kNumBuckets; b++)
+                {
+                    uint32_t n = counts[b];
+                    counts[b] = offset;
+                    offset += n;
+                }
+            }
+
+            for (size_t i = 0; i < count; i++)
+            {
+                uint32_t key = keyIn[i];
+                uint32_t dst = counts[(key >> shift) & (kNumBuckets - 1)]++;
+                keyOut[dst] = key;
+                orderOut[dst] = orderIn[i];
+            }
+
+            std::swap(keyIn, keyOut);
+            std::swap(orderIn, orderOut);
+        }
+
+        return orderIn;
+    }
+
+    // Convenience for sorting a std::vector of keys.
+    const uint32_t* Sort(const std::vector<KeyT>& keys, bool reverse = false)
+    {
+        return Sort(keys.data(), keys.size(), reverse);
+    }
+};
+
 #endif // hsRadixSort_inc
@@ -154,12 +154,19 @@ void plNCAgeJoiner::IDispatchMsgReceiveCallback () {
 
 //============================================================================
 void plNCAgeJoiner::IResMgrProgressBarCallback (const plKey& key) {
+    if (!s_instance)
+        return;
+
+    // No key means the ResMgr is waiting on a page read, so just keep the screen fresh
+    if (!key) {
+        s_instance->progressBar->Increment(0);
+        return;
+    }
+
 #ifndef PLASMA_EXTERNAL_RELEASE
-    if (s_instance)
-        s_instance->progressBar->SetStatusText(key->GetName());
+    s_instance->progressBar->SetStatusText(key->GetName());
 #endif
-    if (s_instance)
-        s_instance->progressBar->Increment(1);
+    s_instance->progressBar->Increment(1);
 }
 
 //============================================================================
@@ -206,6 +206,7 @@ void plNCAgeLeaver::ExecNextOp () {
         //====================================================================
         case kUnloadAge: {
             nc->BeginTask();
+            nc->IFlushSDLStateBatch();
             NetCliGameDisconnect();
 
             // Cull nodes that were part of this age vault (but not shared by the player's vault)
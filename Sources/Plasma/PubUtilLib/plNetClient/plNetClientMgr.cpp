@@ -107,7 +107,8 @@ plNetClientMgr::plNetClientMgr()
       fMsgRecorder(), fLastLocalTime(), fListenListMode(kListenList_Distance),
       fAgeSDLObjectKey(), fExperimentalLevel(), fOverrideAgeTimeOfDayPercent(-1.f),
       fNumInitialSDLStates(), fRequiredNumInitialSDLStates(), fDisableMsg(), fIsOwner(true),
-      fIniPlayerID(), fPingServerType()
+      fIniPlayerID(), fPingServerType(), fBatchSDLStates(), fSDLStatsStart(),
+      fSDLStatesQueued(), fSDLStateBytes(), fSDLMsgsSent(), fSDLBytesSent()
 {   
 #ifndef HS_DEBUGGING
     // release code will timeout inactive players on servers by default
@@ -131,6 +132,9 @@ plNetClientMgr::~plNetClientMgr()
         SetInstance(nullptr);       // we're going down boys
     IClearPendingLoads();
     delete fTaskProgBar;
+
+    for (plNetMsgSDLState* msg : fSDLStateBatch)
+        hsRefCnt_SafeUnRef(msg);
 }
 
 //
@@ -148,6 +152,7 @@ void plNetClientMgr::Shutdown()
 
     // Finally, pump the dispatch system so all the new refs get delivered.
     plgDispatch::Dispatch()->MsgQueueProcess();
+    IFlushSDLStateBatch();
 
     if (fMsgRecorder)
     {
@@ -431,7 +436,11 @@ void plNetClientMgr::Update(double secs)
         SetFlagsBit(kDisableOnNextUpdate, false);
         IDisableNet();
     }
-    
+
+    // Whatever SDL state the last frame produced goes out now, in one piece.
+    IFlushSDLStateBatch();
+    IUpdateSDLSendStats();
+
     // Pump net messages
     NetCommUpdate();
 
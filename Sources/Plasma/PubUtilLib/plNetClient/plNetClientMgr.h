@@ -79,6 +79,7 @@ class plNetVoiceListMsg;
 class plStateDataRecord;
 class plCCRPetitionMsg;
 class plNetMsgPagingRoom;
+class plNetMsgSDLState;
 
 
 class plNetClientMgr : public plNetClientApp
@@ -127,6 +128,18 @@ private:
     // pending room page msgs
     std::vector<plNetMsgPagingRoom*>    fPendingPagingRoomMsgs;
 
+    // SDL state msgs held back to go out together as one plNetMsgSDLStateBatch
+    std::vector<plNetMsgSDLState*>  fSDLStateBatch;
+    bool                            fBatchSDLStates;
+
+    // SDL traffic over the current second: what a msg per state would have cost,
+    // and what actually went out
+    double      fSDLStatsStart;
+    uint32_t    fSDLStatesQueued;
+    uint32_t    fSDLStateBytes;
+    uint32_t    fSDLMsgsSent;
+    uint32_t    fSDLBytesSent;
+
     plNetTransport fTransport;
 
     // groups of objects in the game.  Each group is mastered by a single client.
@@ -188,6 +201,8 @@ private:
     void IShowRelevanceRegions();
     
     void ISendDirtyState(double secs);
+    void IFlushSDLStateBatch();
+    void IUpdateSDLSendStats();
     void ISendMembersListRequest();
     void ISendRoomsReset();
     void ISendCCRPetition(plCCRPetitionMsg* petMsg);    
@@ -262,6 +277,11 @@ public:
 
     void SetLocalPlayerKey(plKey l, bool pageOut=false);
     void SetNullSend(bool on);        // turn null send on/off
+
+    // Hold SDL state msgs back and send each frame's worth as one batch. The server
+    // has to understand plNetMsgSDLStateBatch, so this is off by default.
+    void SetBatchSDLStates(bool on);
+    bool GetBatchSDLStates() const { return fBatchSDLStates; }
     void SetPingServer(uint8_t serverType) { fPingServerType = serverType; }
     
     // getters
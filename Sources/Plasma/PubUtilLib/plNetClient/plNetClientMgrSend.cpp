@@ -45,6 +45,7 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 #include "plCreatableIndex.h"
 #include "hsResMgr.h"
 #include "hsTimer.h"
+#include "plProfile.h"
 
 #include <string_theory/char_buffer>
 
@@ -74,6 +75,11 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 
 #include "pfMessage/pfKIMsg.h"  // TMP
 
+plProfile_CreateCounterNoReset("SDL States/sec", "Network", SDLStatesPerSec);
+plProfile_CreateCounterNoReset("SDL State Bytes/sec", "Network", SDLStateBytesPerSec);
+plProfile_CreateCounterNoReset("SDL Msgs Sent/sec", "Network", SDLMsgsPerSec);
+plProfile_CreateCounterNoReset("SDL Bytes Sent/sec", "Network", SDLBytesPerSec);
+
 //
 // request members list from server
 //
@@ -412,7 +418,32 @@ void plNetClientMgr::SendMsg(plNetMessage* msg)
     IPrepMsg(msg);
     
 //  hsLogEntry( DebugMsg( "<SND> {} {}", msg->ClassName(), msg->AsStdString()) );
-    
+
+    plNetMsgSDLState* sdlMsg = plNetMsgSDLState::ConvertNoRef(msg);
+    if (sdlMsg && fBatchSDLStates && !fMsgRecorder)
+    {
+        // NetCommSendMsg would have done this if the state went out on its own
+        sdlMsg->SetPlayerID(GetPlayerID());
+
+        hsRefCnt_SafeRef(sdlMsg);
+        fSDLStateBatch.push_back(sdlMsg);
+        if (fSDLStateBatch.size() == plNetMsgSDLStateBatch::kMaxStates)
+            IFlushSDLStateBatch();
+        return;
+    }
+
+    // Don't let anything overtake the states queued before it
+    IFlushSDLStateBatch();
+
+    if (sdlMsg)
+    {
+        uint32_t bytes = sdlMsg->GetPackSize();
+        fSDLStatesQueued++;
+        fSDLStateBytes += bytes;
+        fSDLMsgsSent++;
+        fSDLBytesSent += bytes;
+    }
+
     fTransport.SendMsg(msg);
 
     // Debug
@@ -421,3 +452,72 @@ void plNetClientMgr::SendMsg(plNetMessage* msg)
     if (plNetMsgGameMessage::ConvertNoRef(msg))
         SetFlagsBit(kSendingActions);
 }
+
+//
+// Send the SDL state msgs that have been held back, as a single msg if there's more than one
+//
+void plNetClientMgr::IFlushSDLStateBatch()
+{
+    if (fSDLStateBatch.empty())
+        return;
+
+    if (!GetFlagsBit(kDisabled))
+    {
+        if (fSDLStateBatch.size() == 1)
+        {
+            uint32_t bytes = fSDLStateBatch[0]->GetPackSize();
+            fSDLStatesQueued++;
+            fSDLStateBytes += bytes;
+            fSDLMsgsSent++;
+            fSDLBytesSent += bytes;
+
+            fTransport.SendMsg(fSDLStateBatch[0]);
+        }
+        else
+        {
+            plNetMsgSDLStateBatch batch;
+            batch.SetStates(fSDLStateBatch);
+            batch.SetTimeSent(plUnifiedTime::GetCurrent());
+
+            // The stream is a count, then each state behind its length
+            uint32_t stateBytes = batch.StreamInfo()->GetStreamLen() - sizeof(uint16_t);
+            stateBytes -= uint32_t(fSDLStateBatch.size() * sizeof(uint32_t));
+            fSDLStatesQueued += uint32_t(fSDLStateBatch.size());
+            fSDLStateBytes += stateBytes;
+            fSDLMsgsSent++;
+            fSDLBytesSent += batch.GetPackSize();
+
+            fTransport.SendMsg(&batch);
+        }
+    }
+
+    for (plNetMsgSDLState* msg : fSDLStateBatch)
+        hsRefCnt_SafeUnRef(msg);
+    fSDLStateBatch.clear();
+}
+
+void plNetClientMgr::IUpdateSDLSendStats()
+{
+    double now = hsTimer::GetSeconds();
+    if (now - fSDLStatsStart < 1.0)
+        return;
+
+    double elapsed = now - fSDLStatsStart;
+    plProfile_Set(SDLStatesPerSec, uint32_t(fSDLStatesQueued / elapsed));
+    plProfile_Set(SDLStateBytesPerSec, uint32_t(fSDLStateBytes / elapsed));
+    plProfile_Set(SDLMsgsPerSec, uint32_t(fSDLMsgsSent / elapsed));
+    plProfile_Set(SDLBytesPerSec, uint32_t(fSDLBytesSent / elapsed));
+
+    fSDLStatsStart = now;
+    fSDLStatesQueued = 0;
+    fSDLStateBytes = 0;
+    fSDLMsgsSent = 0;
+    fSDLBytesSent = 0;
+}
+
+void plNetClientMgr::SetBatchSDLStates(bool on)
+{
+    if (!on)
+        IFlushSDLStateBatch();
+    fBatchSDLStates = on;
+}
@@ -121,6 +121,8 @@ plNetMsgHandler::Status plNetClientMsgHandler::ReceiveMsg(plNetMessage* netMsg)
 
         case CLASS_INDEX_SCOPED(plNetMsgSDLStateBCast):
             MSG_HANDLER_CASE(plNetMsgSDLState)
+
+        MSG_HANDLER_CASE(plNetMsgSDLStateBatch)
             
         case CLASS_INDEX_SCOPED(plNetMsgGameMessageDirected):
         case CLASS_INDEX_SCOPED(plNetMsgLoadClone):
@@ -272,6 +274,28 @@ MSG_HANDLER_DEFN(plNetClientMsgHandler,plNetMsgSDLState)
     return plNetMsgHandler::Status::kHandled;
 }
 
+MSG_HANDLER_DEFN(plNetClientMsgHandler,plNetMsgSDLStateBatch)
+{
+    plNetClientMgr* nc = IGetNetClientMgr();
+    plNetMsgSDLStateBatch* m = plNetMsgSDLStateBatch::ConvertNoRef(netMsg);
+
+    std::vector<plNetMsgSDLState*> states;
+    if (!m->GetStates(states))
+    {
+        nc->ErrorMsg("Bad SDL state batch, ignoring it");
+        return plNetMsgHandler::Status::kError;
+    }
+
+    // Each state is handled just like it had come in separately
+    for (plNetMsgSDLState* state : states)
+    {
+        MSG_HANDLER(plNetMsgSDLState)(state);
+        state->UnRef();
+    }
+
+    return plNetMsgHandler::Status::kHandled;
+}
+
 MSG_HANDLER_DEFN(plNetClientMsgHandler,plNetMsgGameMessage)
 {
     plNetClientMgr* nc = IGetNetClientMgr();
@@ -75,6 +75,7 @@ public:
     MSG_HANDLER_DECL(plNetMsgTerminated)
     MSG_HANDLER_DECL(plNetMsgGroupOwner)
     MSG_HANDLER_DECL(plNetMsgSDLState)
+    MSG_HANDLER_DECL(plNetMsgSDLStateBatch)
     MSG_HANDLER_DECL(plNetMsgGameMessage)
     MSG_HANDLER_DECL(plNetMsgVoice)
     MSG_HANDLER_DECL(plNetMsgMembersList)
@@ -58,6 +58,7 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 #include "hsTimer.h"
 #include "plFileSystem.h"
 #include "plProduct.h"
+#include "plProfile.h"
 
 #include "pnAsyncCore/pnAcIo.h"
 #include "pnAsyncCore/pnAcLog.h"
@@ -732,6 +733,7 @@ struct VaultFetchNodeTrans : NetAuthTrans {
     FNetCliAuthVaultNodeFetched m_callback;
 
     hsRef<NetVaultNode>         m_node;
+    unsigned                    m_nodeBytes;
     
     VaultFetchNodeTrans (
         unsigned                    nodeId,
@@ -3256,6 +3258,9 @@ bool VaultInitAgeTrans::Recv (
 *
 ***/
 
+plProfile_CreateCounter("Nodes Received", "Vault", VaultNodesReceived);
+plProfile_CreateCounter("Node Bytes Received", "Vault", VaultNodeBytesReceived);
+
 //============================================================================
 VaultFetchNodeTrans::VaultFetchNodeTrans (
     unsigned                    nodeId,
@@ -3264,6 +3269,7 @@ VaultFetchNodeTrans::VaultFetchNodeTrans (
 ,   m_nodeId(nodeId)
 ,   m_callback(std::move(callback))
 ,   m_node()
+,   m_nodeBytes()
 {
 }
 
@@ -3285,6 +3291,12 @@ bool VaultFetchNodeTrans::Send () {
 
 //============================================================================
 void VaultFetchNodeTrans::Post () {
+    // Counted here rather than in Recv, which runs on the socket thread
+    if (m_node) {
+        plProfile_Inc(VaultNodesReceived);
+        plProfile_IncCount(VaultNodeBytesReceived, m_nodeBytes);
+    }
+
     m_callback(m_result, m_node.Get());
 }
 
@@ -3296,6 +3308,7 @@ bool VaultFetchNodeTrans::Recv (
     const Auth2Cli_VaultNodeFetched & reply = *(const Auth2Cli_VaultNodeFetched *) msg;
     
     if (IS_NET_SUCCESS(reply.result)) {
+        m_nodeBytes = reply.nodeBytes;
         m_node.Steal(new NetVaultNode);
         if (!m_node->Read(reply.nodeBuffer, reply.nodeBytes)) {
             LogMsg(kLogError, "VaultFetchNodeTrans::Recv: Invalid vault node data - most likely a length field is incorrect");
@@ -750,6 +750,85 @@ void plNetMsgSDLStateBCast::WriteVersion(hsStream* s, hsResMgr* mgr)
     plNetMsgSDLState::WriteVersion(s, mgr);
 }
 
+////////////////////////////////////////////////////////
+// plNetMsgSDLStateBatch
+////////////////////////////////////////////////////////
+
+void plNetMsgSDLStateBatch::SetStates(const std::vector<plNetMsgSDLState*>& states)
+{
+    hsAssert(states.size() <= kMaxStates, "Too many states for one batch");
+
+    // The count goes first, where the stream helper expects the (never compressed) type.
+    hsRAMStream ram;
+    ram.WriteLE16((uint16_t)states.size());
+
+    hsRAMStream stateStream;
+    for (plNetMsgSDLState* state : states)
+    {
+        stateStream.Reset();
+        state->PokeBuffer(&stateStream);
+        ram.WriteLE32(stateStream.GetEOF());
+        ram.Write(stateStream.GetEOF(), stateStream.GetData());
+    }
+
+    fStreamHelper.Clear();
+    fStreamHelper.CopyStream(&ram);
+}
+
+bool plNetMsgSDLStateBatch::GetStates(std::vector<plNetMsgSDLState*>& states) const
+{
+    if (fStreamHelper.GetStreamLen() < sizeof(uint16_t) || fStreamHelper.IsCompressed())
+        return false;
+
+    hsReadOnlyStream stream(fStreamHelper.GetStreamLen(), fStreamHelper.GetStreamBuf());
+    uint16_t numStates = stream.ReadLE16();
+    size_t firstState = states.size();
+    states.reserve(firstState + numStates);
+
+    // A bad batch is thrown out whole; don't leave the caller with part of it
+    auto fail = [&states, firstState]() {
+        for (auto it = states.begin() + firstState; it != states.end(); ++it)
+            (*it)->UnRef();
+        states.resize(firstState);
+        return false;
+    };
+
+    for (uint16_t i = 0; i < numStates; i++)
+    {
+        if (stream.GetSizeLeft() < sizeof(uint32_t))
+            return fail();
+
+        uint32_t len = stream.ReadLE32();
+        if (len < sizeof(ClassIndexType) || len > stream.GetSizeLeft())
+            return fail();
+
+        hsReadOnlyStream stateStream(len, fStreamHelper.GetStreamBuf() + stream.GetPosition());
+        stream.Skip(len);
+
+        ClassIndexType classIdx = stateStream.ReadLE16();
+        stateStream.Rewind();
+        if (classIdx != CLASS_INDEX_SCOPED(plNetMsgSDLState) &&
+            classIdx != CLASS_INDEX_SCOPED(plNetMsgSDLStateBCast))
+            return fail();
+
+        plNetMsgSDLState* state = plNetMsgSDLState::ConvertNoRef(plFactory::Create(classIdx));
+        if (!state)
+            return fail();
+        if (!state->PeekBuffer(&stateStream))
+        {
+            state->UnRef();
+            return fail();
+        }
+        states.push_back(state);
+    }
+    return true;
+}
+
+ST::string plNetMsgSDLStateBatch::AsString() const
+{
+    return ST::format("states:{}, {}", (uint16_t)fStreamHelper.GetStreamType(), plNetMsgStream::AsString());
+}
+
 ////////////////////////////////////////////////////////
 // plNetMsgRoomsList
 ////////////////////////////////////////////////////////
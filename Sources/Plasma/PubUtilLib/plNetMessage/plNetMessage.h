@@ -382,6 +382,31 @@ public:
     void WriteVersion(hsStream* s, hsResMgr* mgr) override;
 };
 
+//
+// Several SDL state msgs sent as one. Most states are too small to be compressed
+// on their own, but the batch as a whole usually is.
+//
+class plNetMsgSDLStateBatch : public plNetMsgStream
+{
+public:
+    enum { kMaxStates = 0xFFFF };
+
+    plNetMsgSDLStateBatch() { SetBit(kNeedsReliableSend); }
+
+    CLASSNAME_REGISTER( plNetMsgSDLStateBatch );
+    GETINTERFACE_ANY(plNetMsgSDLStateBatch, plNetMsgStream);
+
+    // replaces the contents of the stream with these states
+    void SetStates(const std::vector<plNetMsgSDLState*>& states);
+
+    // appends the states, which the caller must UnRef. false if the stream is bad,
+    // in which case nothing is appended.
+    bool GetStates(std::vector<plNetMsgSDLState*>& states) const;
+
+    // debug
+    ST::string AsString() const override;
+};
+
 //
 //  Object state request msg
 //
@@ -84,6 +84,7 @@ REGISTER_CREATABLE(plNetMsgPlayerPage);
 REGISTER_CREATABLE(plNetMsgRelevanceRegions);
 REGISTER_CREATABLE(plNetMsgSDLState);
 REGISTER_CREATABLE(plNetMsgSDLStateBCast);
+REGISTER_CREATABLE(plNetMsgSDLStateBatch);
 REGISTER_CREATABLE(plNetMsgServerToClient);
 REGISTER_CREATABLE(plNetMsgTestAndSet);
 REGISTER_CREATABLE(plNetMsgVoice);
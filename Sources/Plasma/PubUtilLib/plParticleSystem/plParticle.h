@@ -42,6 +42,8 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 #ifndef plParticle_inc
 #define plParticle_inc
 
+#include <algorithm>
+
 #include "hsGeometry3.h"
 #include "hsColorRGBA.h"
 
@@ -89,26 +91,88 @@ public:
     hsPoint3 fUVCoords[4];
 };
 
+// plParticleExt holds the simulation state as a structure of arrays (one array per attribute,
+// all indexed the same as the Core pool), so the integrator can stream positions and velocities
+// as flat runs of floats. The simulation owns the positions here; they're copied out to the
+// cores once per update for the renderer.
 class plParticleExt
 {
 public:
-    //hsPoint3 fOldPos;
-    hsVector3 fVelocity;
-    float fInvMass; // The inverse (1 / mass) is what we actually need for calculations. Storing it this
+    hsPoint3 *fPos;
+    hsVector3 *fVelocity;
+    float *fInvMass; // The inverse (1 / mass) is what we actually need for calculations. Storing it this
                        // way allows us to make an object immovable with an inverse mass of 0 (and save a divide).
-    hsVector3 fAcceleration; // Accumulated from multiple forces.
-    float fLife; // how many seconds before we recycle this? (My particle has more of a life than I do...)
-    float fStartLife;
-    float fScale;
-    float fRadsPerSec;
-    //uint32_t fOrigColor;
+    hsVector3 *fAcceleration; // Accumulated from multiple forces.
+    float *fLife; // how many seconds before we recycle this? (My particle has more of a life than I do...)
+    float *fStartLife;
+    float *fScale;
+    float *fRadsPerSec;
 
     enum // Miscellaneous flags for particles
     {
         kImmortal                   = 0x00000001,
     };
-    uint32_t fMiscFlags;  // I know... 32 bits for a single flag...
+    uint32_t *fMiscFlags;  // I know... 32 bits for a single flag...
                         // Feel free to change this if you've got something to pack it against.
+
+    plParticleExt()
+        : fPos(), fVelocity(), fInvMass(), fAcceleration(), fLife(),
+          fStartLife(), fScale(), fRadsPerSec(), fMiscFlags()
+    { }
+    plParticleExt(const plParticleExt&) = delete;
+    plParticleExt& operator=(const plParticleExt&) = delete;
+    ~plParticleExt() { Free(); }
+
+    void Alloc(uint32_t count)
+    {
+        Free();
+        fPos = new hsPoint3[count];
+        fVelocity = new hsVector3[count];
+        fInvMass = new float[count];
+        fAcceleration = new hsVector3[count];
+        fLife = new float[count];
+        fStartLife = new float[count];
+        fScale = new float[count];
+        fRadsPerSec = new float[count];
+        fMiscFlags = new uint32_t[count];
+    }
+
+    void Free()
+    {
+        delete [] fPos;
+        delete [] fVelocity;
+        delete [] fInvMass;
+        delete [] fAcceleration;
+        delete [] fLife;
+        delete [] fStartLife;
+        delete [] fScale;
+        delete [] fRadsPerSec;
+        delete [] fMiscFlags;
+        fPos = nullptr;
+        fVelocity = nullptr;
+        fInvMass = nullptr;
+        fAcceleration = nullptr;
+        fLife = nullptr;
+        fStartLife = nullptr;
+        fScale = nullptr;
+        fRadsPerSec = nullptr;
+        fMiscFlags = nullptr;
+    }
+
+    // Copies count particles starting at src[srcIdx] into this pool starting at dstIdx.
+    // src may be this pool, as long as the ranges don't overlap.
+    void Copy(uint32_t dstIdx, const plParticleExt& src, uint32_t srcIdx, uint32_t count = 1)
+    {
+        std::copy_n(src.fPos + srcIdx, count, fPos + dstIdx);
+        std::copy_n(src.fVelocity + srcIdx, count, fVelocity + dstIdx);
+        std::copy_n(src.fInvMass + srcIdx, count, fInvMass + dstIdx);
+        std::copy_n(src.fAcceleration + srcIdx, count, fAcceleration + dstIdx);
+        std::copy_n(src.fLife + srcIdx, count, fLife + dstIdx);
+        std::copy_n(src.fStartLife + srcIdx, count, fStartLife + dstIdx);
+        std::copy_n(src.fScale + srcIdx, count, fScale + dstIdx);
+        std::copy_n(src.fRadsPerSec + srcIdx, count, fRadsPerSec + dstIdx);
+        std::copy_n(src.fMiscFlags + srcIdx, count, fMiscFlags + dstIdx);
+    }
 };
 
 #endif
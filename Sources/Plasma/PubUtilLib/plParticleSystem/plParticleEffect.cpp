@@ -503,6 +503,37 @@ bool plParticleLocalWind::ApplyEffect(const plEffectTargetInfo& target, int32_t
     return false;
 }
 
+void plParticleLocalWind::ApplyEffectBatch(const plEffectTargetInfo& target, uint32_t first, uint32_t count)
+{
+    const float kMinToBother = 0;
+    const float baseStrength = 1.f / ( (1.f + fConstancy) * (1.f + fConstancy) );
+
+    const uint8_t* posBase = target.fPos + first * target.fPosStride;
+    uint8_t* velBase = target.fVelocity + first * target.fVelocityStride;
+    const uint8_t* invMassBase = target.fInvMass + first * target.fInvMassStride;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const hsPoint3& pos = *(const hsPoint3*)(posBase + i * target.fPosStride);
+
+        float s, c;
+        hsFastMath::SinCosAppr((pos[0] - fPhase[0]) * fInvScale[0], s, c);
+        c += fConstancy;
+        if( c <= kMinToBother )
+            continue;
+        float strength = baseStrength * c;
+
+        hsFastMath::SinCosAppr((pos[1] - fPhase[1]) * fInvScale[1], s, c);
+        c += fConstancy;
+        if( c <= kMinToBother )
+            continue;
+        strength *= c;
+
+        strength *= *(const float*)(invMassBase + i * target.fInvMassStride);
+
+        *(hsVector3*)(velBase + i * target.fVelocityStride) += fWindVec * strength;
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////
 // Uniform wind - wind changes over time, but not space
 plParticleUniformWind::plParticleUniformWind()
@@ -630,6 +661,21 @@ bool plParticleUniformWind::ApplyEffect(const plEffectTargetInfo& target, int32_
     return false;
 }
 
+void plParticleUniformWind::ApplyEffectBatch(const plEffectTargetInfo& target, uint32_t first, uint32_t count)
+{
+    if (fCurrentStrength == 0)
+        return;
+
+    const hsVector3 wind = fWindVec * fCurrentStrength;
+    uint8_t* velBase = target.fVelocity + first * target.fVelocityStride;
+    const uint8_t* invMassBase = target.fInvMass + first * target.fInvMassStride;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const float invMass = *(const float*)(invMassBase + i * target.fInvMassStride);
+        *(hsVector3*)(velBase + i * target.fVelocityStride) += wind * invMass;
+    }
+}
+
 ////////////////////////////////////////////////////////////////////////
 // Simplified flocking.
 
@@ -857,6 +903,24 @@ bool plParticleFollowSystemEffect::ApplyEffect(const plEffectTargetInfo& target,
     return true;
 }
 
+void plParticleFollowSystemEffect::ApplyEffectBatch(const plEffectTargetInfo& target, uint32_t first, uint32_t count)
+{
+    if (!fEvalThisFrame || fOldW2L.IsIdentity())
+        return;
+
+    // Only particles that existed last frame need carrying along.
+    const uint32_t end = std::min(first + count, target.fFirstNewParticle);
+    if (first >= end)
+        return;
+
+    const hsMatrix44 xform = target.fContext.fSystem->GetTarget(0)->GetLocalToWorld() * fOldW2L;
+    for (uint32_t i = first; i < end; i++)
+    {
+        hsPoint3 &pos = *(hsPoint3*)(target.fPos + i * target.fPosStride);
+        pos = xform * pos;
+    }
+}
+
 void plParticleFollowSystemEffect::EndEffect(const plEffectTargetInfo& target)
 {
     if (fEvalThisFrame)
@@ -66,8 +66,17 @@ public:
     //  EndEffect marks no more particles will be processed with the above
     //      context (invalidating anything cached).
     // Defaults for Prepare and End are no-ops.
+    // Forces and misc effects are applied a whole range at a time through
+    // ApplyEffectBatch (the return value of ApplyEffect is ignored there).
+    // The default just calls ApplyEffect on each particle; effects that can
+    // hoist work out of the loop should override it.
     virtual void PrepareEffect(const plEffectTargetInfo& target) {}
     virtual bool ApplyEffect(const plEffectTargetInfo& target, int32_t i) = 0;
+    virtual void ApplyEffectBatch(const plEffectTargetInfo& target, uint32_t first, uint32_t count)
+    {
+        for (uint32_t i = first; i < first + count; i++)
+            ApplyEffect(target, i);
+    }
     virtual void EndEffect(const plEffectTargetInfo& target) {}
 };
 
@@ -241,6 +250,7 @@ public:
 
     void PrepareEffect(const plEffectTargetInfo& target) override;
     bool ApplyEffect(const plEffectTargetInfo& target, int32_t i) override;
+    void ApplyEffectBatch(const plEffectTargetInfo& target, uint32_t first, uint32_t count) override;
 
     void                SetScale(const hsVector3& v) { fScale = v; }
     const hsVector3&    GetScale() const { return fScale; }
@@ -275,6 +285,7 @@ public:
 
     void PrepareEffect(const plEffectTargetInfo& target) override;
     bool ApplyEffect(const plEffectTargetInfo& target, int32_t i) override;
+    void ApplyEffectBatch(const plEffectTargetInfo& target, uint32_t first, uint32_t count) override;
 
     void        SetFrequencyRange(float minSecsPerCycle, float maxSecsPerCycle);
     void        SetFrequencyRate(float secsPerCycle);
@@ -369,6 +380,7 @@ public:
 
     void PrepareEffect(const plEffectTargetInfo& target) override;
     bool ApplyEffect(const plEffectTargetInfo& target, int32_t i) override;
+    void ApplyEffectBatch(const plEffectTargetInfo& target, uint32_t first, uint32_t count) override;
     void EndEffect(const plEffectTargetInfo& target) override;
     
 protected:
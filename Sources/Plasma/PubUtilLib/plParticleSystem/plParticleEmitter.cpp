@@ -77,20 +77,28 @@ void plParticleEmitter::Init(plParticleSystem *system, uint32_t maxParticles, ui
 {
     IClear();
     fSystem = system;
-    plLayerInterface *layer = system->fTexture->GetLayer(0)->BottomOfStack();
     fMiscFlags = miscFlags | kNeedsUpdate;
     if( fMiscFlags & kOnReserve )
         fTimeToLive = -1.f; // Wait for someone to give us a spurt of life.
-    if( layer->GetShadeFlags() & hsGMatState::kShadeEmissive )
+    if (system->fTexture == nullptr)
     {
-        fMiscFlags |= kMatIsEmissive;
-        fColor = layer->GetAmbientColor();
+        // Headless systems (e.g. the particle benchmark) never get a material.
+        fColor.Set(1.f, 1.f, 1.f, 1.f);
     }
     else
     {
-        fColor = layer->GetRuntimeColor();
+        plLayerInterface *layer = system->fTexture->GetLayer(0)->BottomOfStack();
+        if( layer->GetShadeFlags() & hsGMatState::kShadeEmissive )
+        {
+            fMiscFlags |= kMatIsEmissive;
+            fColor = layer->GetAmbientColor();
+        }
+        else
+        {
+            fColor = layer->GetRuntimeColor();
+        }
+        fColor.a = layer->GetOpacity();
     }
-    fColor.a = layer->GetOpacity();
     fGenerator = gen;
     fMaxParticles = maxParticles;
     fSpanIndex = spanIndex;
@@ -124,8 +132,7 @@ void plParticleEmitter::IClear()
 {
     delete [] fParticleCores;
     fParticleCores = nullptr;
-    delete [] fParticleExts;
-    fParticleExts = nullptr;
+    fParticleExts.Free();
     if( !(fMiscFlags & kBorrowedGenerator) )
         delete fGenerator;
     fGenerator = nullptr;
@@ -135,24 +142,26 @@ void plParticleEmitter::ISetupParticleMem()
 {
     fNumValidParticles = 0;
 
+    delete [] fParticleCores;
     fParticleCores = new plParticleCore[fMaxParticles];
-    fParticleExts = new plParticleExt[fMaxParticles];
-
-    fTargetInfo.fPos = (uint8_t *)fParticleCores;
-    fTargetInfo.fColor = (uint8_t *)fParticleCores + sizeof(hsPoint3);
-    fTargetInfo.fPosStride = fTargetInfo.fColorStride = sizeof(plParticleCore);
-
-    fTargetInfo.fVelocity = (uint8_t *)fParticleExts;
-    fTargetInfo.fInvMass = fTargetInfo.fVelocity + sizeof(hsVector3);
-    fTargetInfo.fAcceleration = fTargetInfo.fInvMass + sizeof(float);
-    fTargetInfo.fMiscFlags = (uint8_t *)&(fParticleExts[0].fMiscFlags);   
-    fTargetInfo.fRadsPerSec = (uint8_t *)&(fParticleExts[0].fRadsPerSec);
-    fTargetInfo.fVelocityStride 
-        = fTargetInfo.fInvMassStride 
-        = fTargetInfo.fAccelerationStride 
-        = fTargetInfo.fRadsPerSecStride
-        = fTargetInfo.fMiscFlagsStride 
-        = sizeof(plParticleExt);
+    fParticleExts.Alloc(fMaxParticles);
+
+    // Effects see the simulation positions, not the render copies in the cores.
+    fTargetInfo.fPos = (uint8_t *)fParticleExts.fPos;
+    fTargetInfo.fPosStride = sizeof(hsPoint3);
+    fTargetInfo.fColor = (uint8_t *)&(fParticleCores[0].fColor);
+    fTargetInfo.fColorStride = sizeof(plParticleCore);
+
+    fTargetInfo.fVelocity = (uint8_t *)fParticleExts.fVelocity;
+    fTargetInfo.fVelocityStride = sizeof(hsVector3);
+    fTargetInfo.fInvMass = (uint8_t *)fParticleExts.fInvMass;
+    fTargetInfo.fInvMassStride = sizeof(float);
+    fTargetInfo.fAcceleration = (uint8_t *)fParticleExts.fAcceleration;
+    fTargetInfo.fAccelerationStride = sizeof(hsVector3);
+    fTargetInfo.fRadsPerSec = (uint8_t *)fParticleExts.fRadsPerSec;
+    fTargetInfo.fRadsPerSecStride = sizeof(float);
+    fTargetInfo.fMiscFlags = (uint8_t *)fParticleExts.fMiscFlags;
+    fTargetInfo.fMiscFlagsStride = sizeof(uint32_t);
 }
 
 uint32_t plParticleEmitter::GetNumTiles() const
@@ -170,7 +179,6 @@ void plParticleEmitter::AddParticle(hsPoint3 &pos, hsVector3 &velocity, uint32_t
                                     hsPoint3 &orientation, uint32_t miscFlags, float radsPerSec)
 {
     plParticleCore *core;
-    plParticleExt *ext;
     uint32_t currParticle;
 
     if (fNumValidParticles == fMaxParticles)
@@ -205,17 +213,17 @@ void plParticleEmitter::AddParticle(hsPoint3 &pos, hsVector3 &velocity, uint32_t
     core->fUVCoords[3].fY = yOff;
     core->fUVCoords[3].fZ = 1.0f;
 
-    ext = &fParticleExts[currParticle];
-    ext->fVelocity = velocity;
-    ext->fInvMass = invMass;
-    ext->fLife = ext->fStartLife = life;
-    ext->fMiscFlags = miscFlags; // Is this ever NOT zero?
+    fParticleExts.fPos[currParticle] = pos;
+    fParticleExts.fVelocity[currParticle] = velocity;
+    fParticleExts.fInvMass[currParticle] = invMass;
+    fParticleExts.fLife[currParticle] = fParticleExts.fStartLife[currParticle] = life;
+    fParticleExts.fMiscFlags[currParticle] = miscFlags; // Is this ever NOT zero?
     if (life <= 0) 
-        ext->fMiscFlags |= plParticleExt::kImmortal;
+        fParticleExts.fMiscFlags[currParticle] |= plParticleExt::kImmortal;
 
-    ext->fRadsPerSec = radsPerSec;
-    ext->fAcceleration.Set(0, 0, 0);
-    ext->fScale = scale;
+    fParticleExts.fRadsPerSec[currParticle] = radsPerSec;
+    fParticleExts.fAcceleration[currParticle].Set(0, 0, 0);
+    fParticleExts.fScale[currParticle] = scale;
 }
 
 void plParticleEmitter::WipeExistingParticles()
@@ -247,11 +255,11 @@ void plParticleEmitter::KillParticles(float num, float timeToDie, uint8_t flags)
     int i;
     for (i = 0; i < fNumValidParticles && num > 0; i++)
     {
-        if ((flags & plParticleKillMsg::kParticleKillImmortalOnly) && !(fParticleExts[i].fMiscFlags & plParticleExt::kImmortal))
+        if ((flags & plParticleKillMsg::kParticleKillImmortalOnly) && !(fParticleExts.fMiscFlags[i] & plParticleExt::kImmortal))
             continue;
 
-        fParticleExts[i].fLife = fParticleExts[i].fStartLife = timeToDie;
-        fParticleExts[i].fMiscFlags &= ~plParticleExt::kImmortal;
+        fParticleExts.fLife[i] = fParticleExts.fStartLife[i] = timeToDie;
+        fParticleExts.fMiscFlags[i] &= ~plParticleExt::kImmortal;
         num--;
     }
 }
@@ -273,7 +281,7 @@ uint16_t plParticleEmitter::StealParticlesFrom(plParticleEmitter *victim, uint16
     {
         // copy them over
         memcpy(&(fParticleCores[fNumValidParticles]), &(victim->fParticleCores[victim->fNumValidParticles - numToCopy]), numToCopy * sizeof(plParticleCore));
-        memcpy(&(fParticleExts[fNumValidParticles]), &(victim->fParticleExts[victim->fNumValidParticles- numToCopy]), numToCopy * sizeof(plParticleExt));
+        fParticleExts.Copy(fNumValidParticles, victim->fParticleExts, victim->fNumValidParticles - numToCopy, numToCopy);
 
         fNumValidParticles += numToCopy;
         victim->fNumValidParticles -= numToCopy;
@@ -286,7 +294,10 @@ void plParticleEmitter::TranslateAllParticles(hsPoint3 &amount)
 {
     int i;
     for (i = 0; i < fNumValidParticles; i++)
-        fParticleCores[i].fPos += amount;
+    {
+        fParticleExts.fPos[i] += amount;
+        fParticleCores[i].fPos = fParticleExts.fPos[i];
+    }
 }
 
 bool plParticleEmitter::IUpdate(float delta)
@@ -312,8 +323,8 @@ void plParticleEmitter::IUpdateParticles(float delta)
     // Have to remove particles before adding new ones, or we can run out of room.
     for (uint32_t i = 0; i < fNumValidParticles; i++)
     {
-        fParticleExts[i].fLife -= delta;
-        if (fParticleExts[i].fLife <= 0 && !(fParticleExts[i].fMiscFlags & plParticleExt::kImmortal))
+        fParticleExts.fLife[i] -= delta;
+        if (fParticleExts.fLife[i] <= 0 && !(fParticleExts.fMiscFlags[i] & plParticleExt::kImmortal))
         {
             IRemoveParticle(i);
             i--; // so that we hit this index again on the next iteration
@@ -338,14 +349,9 @@ void plParticleEmitter::IUpdateParticles(float delta)
 
     fTargetInfo.fContext = fSystem->fContext;
     fTargetInfo.fNumValidParticles = fNumValidParticles;
-    const hsVector3 up(0.f, 0.f, 1.0f);
-    hsVector3 currDirection;
-    hsPoint3 *currPos;
-    hsVector3 *currVelocity;
-    hsVector3 *currAccel;
     hsPoint3 color(fColor.r, fColor.g, fColor.b);
     float alpha = fColor.a;
-    plController *colorCtl;
+    plController *colorCtl = (fMiscFlags & kMatIsEmissive ? fSystem->fAmbientCtl : fSystem->fDiffuseCtl);
 
     // Allow effects a chance to cache any upfront calculations
     // that will apply to all particles.
@@ -362,12 +368,15 @@ void plParticleEmitter::IUpdateParticles(float delta)
         constraint->PrepareEffect(fTargetInfo);
     }
 
-    for (uint32_t i = 0; i < fNumValidParticles; i++)
+    // Each stage below runs over the whole pool before the next one starts, so the
+    // integrator and the batched effects get long runs of contiguous data to chew on.
+    const uint32_t numParticles = fNumValidParticles;
+
+    for (uint32_t i = 0; i < numParticles; i++)
     {
-        if (!( fParticleExts[i].fMiscFlags & plParticleExt::kImmortal ))
+        if (!( fParticleExts.fMiscFlags[i] & plParticleExt::kImmortal ))
         {           
-            float percent = (1.0f - fParticleExts[i].fLife / fParticleExts[i].fStartLife);
-            colorCtl = (fMiscFlags & kMatIsEmissive ? fSystem->fAmbientCtl : fSystem->fDiffuseCtl);
+            float percent = (1.0f - fParticleExts.fLife[i] / fParticleExts.fStartLife[i]);
             if (colorCtl != nullptr)
                 colorCtl->Interp(colorCtl->GetLength() * percent, &color);
 
@@ -385,78 +394,95 @@ void plParticleEmitter::IUpdateParticles(float delta)
             {
                 fSystem->fWidthCtl->Interp(fSystem->fWidthCtl->GetLength() * percent,
                                            &fParticleCores[i].fHSize);
-                fParticleCores[i].fHSize *= fParticleExts[i].fScale;
+                fParticleCores[i].fHSize *= fParticleExts.fScale[i];
             }
             if (fSystem->fHeightCtl != nullptr)
             {
                 fSystem->fHeightCtl->Interp(fSystem->fHeightCtl->GetLength() * percent,
                                             &fParticleCores[i].fVSize);
-                fParticleCores[i].fVSize *= fParticleExts[i].fScale;
+                fParticleCores[i].fVSize *= fParticleExts.fScale[i];
             }
 
             fParticleCores[i].fColor = CreateHexColor(color.fX, color.fY, color.fZ, alpha);                     
         }
+    }
 
-        for (plParticleEffect* forceEffect : fSystem->fForces)
-        {
-            forceEffect->ApplyEffect(fTargetInfo, i);
-        }
-        
-        currPos = (hsPoint3 *)(fTargetInfo.fPos + i * fTargetInfo.fPosStride);
-        currVelocity = (hsVector3 *)(fTargetInfo.fVelocity + i * fTargetInfo.fVelocityStride);
-        //currAccel = (hsVector3 *)(fTargetInfo.fAcceleration + i * fTargetInfo.fAccelerationStride);
-        currAccel = &fSystem->fAccel; // Nothing accellerates on a per-particle basis (yet)
-
-        *currPos += *currVelocity * delta;
+    for (plParticleEffect* forceEffect : fSystem->fForces)
+    {
+        forceEffect->ApplyEffectBatch(fTargetInfo, 0, numParticles);
+    }
 
-        // This is the only orientation option (so far) that requires an update here
-        if (fMiscFlags & (kOrientationVelocityBased | kOrientationVelocityStretch | kOrientationVelocityFlow))
+    // This is the only orientation option (so far) that requires an update here.
+    // It wants the velocity after forces, but before drag and acceleration.
+    if (fMiscFlags & (kOrientationVelocityBased | kOrientationVelocityStretch | kOrientationVelocityFlow))
+    {
+        for (uint32_t i = 0; i < numParticles; i++)
         {
             // mf - want the orientation to be a delposition
-            hsVector3 tmp = *currVelocity * delta;
+            hsVector3 tmp = fParticleExts.fVelocity[i] * delta;
             fParticleCores[i].fOrientation.Set(&tmp);
         }
-        else if( fParticleExts[i].fRadsPerSec != 0 )
+    }
+    else
+    {
+        for (uint32_t i = 0; i < numParticles; i++)
         {
-            float sinX, cosX;
-            hsFastMath::SinCos(fParticleExts[i].fLife * fParticleExts[i].fRadsPerSec * hsConstants::two_pi<float>, sinX, cosX);
-            fParticleCores[i].fOrientation.Set(sinX, -cosX, 0);
+            if( fParticleExts.fRadsPerSec[i] != 0 )
+            {
+                float sinX, cosX;
+                hsFastMath::SinCos(fParticleExts.fLife[i] * fParticleExts.fRadsPerSec[i] * hsConstants::two_pi<float>, sinX, cosX);
+                fParticleCores[i].fOrientation.Set(sinX, -cosX, 0);
+            }
         }
+    }
 
-        // Viscous force F(t) = -k V(t)
-        // Integral S from t0 to t1 of F(t) is
-        // = S(-kV(t))[t1..t0]
-        // = -k(P(t1) - P(t0))
-        // = -k*(currVelocity * delta)
-        // or
-        // V = V + -k*(V * delta)
-        // V *= (1 + -k * delta)
-        // Giving the change in velocity.
-        float drag = 1.f + fSystem->fDrag * delta;
-        // Clamp it at 0. Drag should never cause a reversal in velocity direction.
-        if( drag < 0.f )
-            drag = 0.f;
-        *currVelocity *= drag;
-
-        *currVelocity += *currAccel * delta;
-
-        for (plParticleEffect* effect : fSystem->fEffects)
-        {
-            effect->ApplyEffect(fTargetInfo, i);
-        }
+    // Viscous force F(t) = -k V(t)
+    // Integral S from t0 to t1 of F(t) is
+    // = S(-kV(t))[t1..t0]
+    // = -k(P(t1) - P(t0))
+    // = -k*(currVelocity * delta)
+    // or
+    // V = V + -k*(V * delta)
+    // V *= (1 + -k * delta)
+    // Giving the change in velocity.
+    float drag = 1.f + fSystem->fDrag * delta;
+    // Clamp it at 0. Drag should never cause a reversal in velocity direction.
+    if( drag < 0.f )
+        drag = 0.f;
+
+    // Nothing accelerates on a per-particle basis (yet)
+    const float accelDelta[3] = {
+        fSystem->fAccel.fX * delta,
+        fSystem->fAccel.fY * delta,
+        fSystem->fAccel.fZ * delta
+    };
+    static_assert(sizeof(hsPoint3) == 3 * sizeof(float) && sizeof(hsVector3) == 3 * sizeof(float),
+                  "The integrator expects tightly packed xyz triples");
+    integrate((float*)fParticleExts.fPos, (float*)fParticleExts.fVelocity, numParticles,
+              accelDelta, delta, drag);
 
-        // We may need to do more than one iteration through the constraints. It's a trade-off
-        // between accurracy and speed (what's new?) but I'm going to go with just one
-        // for now until we decide things don't "look right"
-        for (plParticleEffect* constraint : fSystem->fConstraints)
+    for (plParticleEffect* effect : fSystem->fEffects)
+    {
+        effect->ApplyEffectBatch(fTargetInfo, 0, numParticles);
+    }
+
+    // We may need to do more than one iteration through the constraints. It's a trade-off
+    // between accurracy and speed (what's new?) but I'm going to go with just one
+    // for now until we decide things don't "look right"
+    if (!fSystem->fConstraints.empty())
+    {
+        for (uint32_t i = 0; i < fNumValidParticles; i++)
         {
-            if (constraint->ApplyEffect(fTargetInfo, i))
+            for (plParticleEffect* constraint : fSystem->fConstraints)
             {
-                IRemoveParticle(i);
-                i--; // so that we hit this index again on the next iteration
-                break; 
-                // break will break us out of loop over constraints,
-                // and since we're last, we move onto next particle.
+                if (constraint->ApplyEffect(fTargetInfo, i))
+                {
+                    IRemoveParticle(i);
+                    i--; // so that we hit this index again on the next iteration
+                    break; 
+                    // break will break us out of loop over constraints,
+                    // and since we're last, we move onto next particle.
+                }
             }
         }
     }
@@ -476,6 +502,32 @@ void plParticleEmitter::IUpdateParticles(float delta)
     }
 }
 
+void plParticleEmitter::integrate_fpu(float* pos, float* vel, size_t count,
+                                      const float accelDelta[3], float delta, float drag)
+{
+    for (size_t i = 0; i < count; i++, pos += 3, vel += 3)
+    {
+        for (size_t j = 0; j < 3; j++)
+        {
+            pos[j] += vel[j] * delta;
+            vel[j] = vel[j] * drag + accelDelta[j];
+        }
+    }
+}
+
+// CPU-optimized functions requiring dispatch
+hsCpuFunctionDispatcher<plParticleEmitter::integrate_ptr> plParticleEmitter::integrate {
+    &plParticleEmitter::integrate_fpu,
+    nullptr,            // SSE1
+    &plParticleEmitter::integrate_sse2,
+    nullptr,            // SSE3
+    nullptr,            // SSSE3
+    nullptr,            // SSE41
+    nullptr,            // SSE42
+    nullptr,            // AVX
+    nullptr             // AVX2
+};
+
 plProfile_CreateTimer("Bound", "Particles", ParticleBound);
 plProfile_CreateTimer("Normal", "Particles", ParticleNormal);
 
@@ -485,7 +537,10 @@ void plParticleEmitter::IUpdateBoundsAndNormals(float delta)
     fBoundBox.MakeEmpty();
     int i;
     for (i = 0; i < fNumValidParticles; i++)
+    {
+        fParticleCores[i].fPos = fParticleExts.fPos[i];
         fBoundBox.Union(&fParticleCores[i].fPos);
+    }
     
     hsPoint3 center;
     if (fNumValidParticles > 0)
@@ -500,10 +555,10 @@ void plParticleEmitter::IUpdateBoundsAndNormals(float delta)
         {
             //currDirection.Set(&fParticleCores[i].fPos, &fParticleExts[i].fOldPos);
             //normal = (currDirection % up % currDirection);
-            normal.Set(-fParticleExts[i].fVelocity.fX * fParticleExts[i].fVelocity.fZ,
-                       -fParticleExts[i].fVelocity.fY * fParticleExts[i].fVelocity.fZ,
-                       (fParticleExts[i].fVelocity.fX * fParticleExts[i].fVelocity.fX + 
-                        fParticleExts[i].fVelocity.fY * fParticleExts[i].fVelocity.fY));
+            const hsVector3& vel = fParticleExts.fVelocity[i];
+            normal.Set(-vel.fX * vel.fZ,
+                       -vel.fY * vel.fZ,
+                       (vel.fX * vel.fX + vel.fY * vel.fY));
             if (!normal.IsEmpty()) // zero length check
             {
                 normal.Normalize();
@@ -539,7 +594,7 @@ void plParticleEmitter::IRemoveParticle(uint32_t index)
     }
 
     fParticleCores[index] = fParticleCores[fNumValidParticles];
-    fParticleExts[index] = fParticleExts[fNumValidParticles];
+    fParticleExts.Copy(index, fParticleExts, fNumValidParticles);
 }
 
 // Reading and writing doesn't transfer individual particle info. We assume those are expendable.
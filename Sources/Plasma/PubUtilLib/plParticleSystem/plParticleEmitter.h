@@ -45,15 +45,15 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 #include "hsGeometry3.h"
 #include "hsBounds.h"
 #include "hsColorRGBA.h"
+#include "hsCpuID.h"
 
 #include "plEffectTargetInfo.h"
+#include "plParticle.h"
 
 #include "pnFactory/plCreatable.h"
 
 class hsBounds3Ext;
 class plParticleSystem;
-class plParticleCore;
-class plParticleExt;
 class plParticleGenerator;
 class plSimpleParticleGenerator;
 class hsResMgr;
@@ -134,8 +134,8 @@ protected:
 
     plParticleSystem *fSystem;          // The particle system this belongs to.
     plParticleCore *fParticleCores;     // The particle pool, created on init, initialized as needed, and recycled. 
-    plParticleExt *fParticleExts;       // Same mapping as the Core pool. Contains extra info the render pipeline
-                                        // doesn't need.
+    plParticleExt fParticleExts;        // Same mapping as the Core pool. Contains extra info the render pipeline
+                                        // doesn't need, stored as one array per attribute.
 
     plParticleGenerator *fGenerator;    // Optional auto generator (have this be nil if you don't want auto-generation)
     uint32_t fSpanIndex;                  // Index of the span that this emitter uses.
@@ -155,6 +155,19 @@ protected:
     void IUpdateParticles(float delta);
     void IUpdateBoundsAndNormals(float delta);
     void IRemoveParticle(uint32_t index);
+
+public:
+    // Advances count particles' positions by their velocities, then applies drag and
+    // the system-wide acceleration (already scaled by delta) to the velocities. Both
+    // arrays are tightly packed xyz triples.
+    typedef void(*integrate_ptr)(float* pos, float* vel, size_t count,
+                                 const float accelDelta[3], float delta, float drag);
+    static hsCpuFunctionDispatcher<integrate_ptr> integrate;
+
+    static void integrate_fpu(float* pos, float* vel, size_t count,
+                              const float accelDelta[3], float delta, float drag);
+    static void integrate_sse2(float* pos, float* vel, size_t count,
+                               const float accelDelta[3], float delta, float drag);
 };
 
 #endif
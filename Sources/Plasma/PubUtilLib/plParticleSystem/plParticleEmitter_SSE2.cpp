@@ -0,0 +1,80 @@
+/*==LICENSE==*
+
+CyanWorlds.com Engine - MMOG client, server and tools
+Copyright (C) 2011  Cyan Worlds, Inc.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Additional permissions under GNU GPL version 3 section 7
+
+If you modify this Program, or any covered work, by linking or
+combining it with any of RAD Game Tools Bink SDK, Autodesk 3ds Max SDK,
+NVIDIA PhysX SDK, Microsoft DirectX SDK, OpenSSL library, Independent
+JPEG Group JPEG library, Microsoft Windows Media SDK, or Apple QuickTime SDK
+(or a modified version of those libraries),
+containing parts covered by the terms of the Bink SDK EULA, 3ds Max EULA,
+PhysX SDK EULA, DirectX SDK EULA, OpenSSL and SSLeay licenses, IJG
+JPEG Library README, Windows Media SDK EULA, or QuickTime SDK EULA, the
+licensors of this Program grant you additional
+permission to convey the resulting work. Corresponding Source for a
+non-source form of such a combination shall include the source code for
+the parts of OpenSSL and IJG JPEG Library used as well as that of the covered
+work.
+
+You can contact Cyan Worlds, Inc. by email legal@cyan.com
+ or by snail mail at:
+      Cyan Worlds, Inc.
+      14617 N Newport Hwy
+      Mead, WA   99021
+
+*==LICENSE==*/
+
+#include "plParticleEmitter.h"
+
+#ifdef HAVE_SSE2
+#   include <emmintrin.h>
+#endif
+
+// Four particles are exactly three registers of packed xyz triples, so the
+// acceleration is kept in three rotations to line up with each register.
+void plParticleEmitter::integrate_sse2(float* pos, float* vel, size_t count,
+                                       const float accelDelta[3], float delta, float drag)
+{
+#ifdef HAVE_SSE2
+    const float ax = accelDelta[0], ay = accelDelta[1], az = accelDelta[2];
+    const __m128 accel0 = _mm_setr_ps(ax, ay, az, ax);
+    const __m128 accel1 = _mm_setr_ps(ay, az, ax, ay);
+    const __m128 accel2 = _mm_setr_ps(az, ax, ay, az);
+    const __m128 del = _mm_set1_ps(delta);
+    const __m128 drg = _mm_set1_ps(drag);
+
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4, pos += 12, vel += 12) {
+        __m128 v0 = _mm_loadu_ps(vel);
+        __m128 v1 = _mm_loadu_ps(vel + 4);
+        __m128 v2 = _mm_loadu_ps(vel + 8);
+
+        _mm_storeu_ps(pos,     _mm_add_ps(_mm_loadu_ps(pos),     _mm_mul_ps(v0, del)));
+        _mm_storeu_ps(pos + 4, _mm_add_ps(_mm_loadu_ps(pos + 4), _mm_mul_ps(v1, del)));
+        _mm_storeu_ps(pos + 8, _mm_add_ps(_mm_loadu_ps(pos + 8), _mm_mul_ps(v2, del)));
+
+        _mm_storeu_ps(vel,     _mm_add_ps(_mm_mul_ps(v0, drg), accel0));
+        _mm_storeu_ps(vel + 4, _mm_add_ps(_mm_mul_ps(v1, drg), accel1));
+        _mm_storeu_ps(vel + 8, _mm_add_ps(_mm_mul_ps(v2, drg), accel2));
+    }
+
+    if (i < count)
+        integrate_fpu(pos, vel, count - i, accelDelta, delta, drag);
+#endif
+}
@@ -315,7 +315,7 @@ uint32_t plParticleSystem::GetNumValidParticles(bool immortalOnly /* = false */)
         {
             for (j = 0; j < fEmitters[i]->fNumValidParticles; j++)
             {
-                if (fEmitters[i]->fParticleExts[j].fMiscFlags & plParticleExt::kImmortal)
+                if (fEmitters[i]->fParticleExts.fMiscFlags[j] & plParticleExt::kImmortal)
                     count++;
             }
         }
@@ -572,6 +572,19 @@ void plParticleSystem::RemoveTarget(plSceneObject *so)
     }
 }
 
+void plParticleSystem::Simulate(double secs, float delta)
+{
+    fContext.fPipeline = nullptr;
+    fContext.fSystem = this;
+    fContext.fSecs = secs;
+    fContext.fDelSecs = delta;
+
+    for (uint32_t i = 0; i < fNumValidEmitters; i++)
+        fEmitters[i]->IUpdate(delta);
+
+    fCurrTime = fLastTime = secs;
+}
+
 // This can be done much faster, but it's only done on load, and very very clean as is. Saving optimization for
 // when we observe that it's too slow.
 void plParticleSystem::IPreSim()
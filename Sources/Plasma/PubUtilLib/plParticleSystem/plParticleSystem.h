@@ -203,6 +203,13 @@ public:
     // Export only functions for building the system. Not supported at runtime.
     // AddLight allows the particle system to remain in ignorant bliss about runtime lights
     void AddLight(plKey liKey);
+
+    // Tool only functions for stepping a system with no pipeline, draw interface, or material
+    // (see plParticleBenchmark). Effects that need a pipeline or a target won't work here.
+    void AddEffect(plParticleEffect *effect, effectType type) { IAddEffect(effect, type); }
+    uint32_t GetNumEmitters() const { return fNumValidEmitters; }
+    plParticleEmitter* GetEmitter(uint32_t i) const { return fEmitters[i]; }
+    void Simulate(double secs, float delta);
 };
 
 #endif
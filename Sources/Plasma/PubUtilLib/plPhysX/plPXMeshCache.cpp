@@ -0,0 +1,162 @@
+/*==LICENSE==*
+
+CyanWorlds.com Engine - MMOG client, server and tools
+Copyright (C) 2011  Cyan Worlds, Inc.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Additional permissions under GNU GPL version 3 section 7
+
+If you modify this Program, or any covered work, by linking or
+combining it with any of RAD Game Tools Bink SDK, Autodesk 3ds Max SDK,
+NVIDIA PhysX SDK, Microsoft DirectX SDK, OpenSSL library, Independent
+JPEG Group JPEG library, Microsoft Windows Media SDK, or Apple QuickTime SDK
+(or a modified version of those libraries),
+containing parts covered by the terms of the Bink SDK EULA, 3ds Max EULA,
+PhysX SDK EULA, DirectX SDK EULA, OpenSSL and SSLeay licenses, IJG
+JPEG Library README, Windows Media SDK EULA, or QuickTime SDK EULA, the
+licensors of this Program grant you additional
+permission to convey the resulting work. Corresponding Source for a
+non-source form of such a combination shall include the source code for
+the parts of OpenSSL and IJG JPEG Library used as well as that of the covered
+work.
+
+You can contact Cyan Worlds, Inc. by email legal@cyan.com
+ or by snail mail at:
+      Cyan Worlds, Inc.
+      14617 N Newport Hwy
+      Mead, WA   99021
+
+*==LICENSE==*/
+
+#include "HeadSpin.h"
+#include "plPXMeshCache.h"
+
+#include "hsGeometry3.h"
+#include "hsStream.h"
+
+#include "pnEncryption/plChecksum.h"
+
+#include <atomic>
+#include <string_theory/format>
+
+#if HS_BUILD_FOR_WIN32
+#    include "process.h"    // for getpid()
+#else
+#    include <unistd.h>
+#endif
+
+// ==========================================================================
+
+/** 'PXMC', followed by the format version and the size of the cooked data */
+constexpr uint32_t kMeshCacheMagic = 0x434D5850;
+constexpr uint32_t kMeshCacheVersion = 1;
+
+// ==========================================================================
+
+void plPXMeshCache::SetDirectory(const plFileName& dir)
+{
+    fDirectory = dir;
+    if (fDirectory.IsValid())
+        plFileSystem::CreateDir(fDirectory, true);
+}
+
+plFileName plPXMeshCache::GetCacheFile(MeshType type, uint32_t flags,
+                                       const std::vector<uint32_t>& tris,
+                                       const std::vector<hsPoint3>& verts) const
+{
+    const uint32_t header[] = {
+        kMeshCacheVersion,
+        (uint32_t)type,
+        flags,
+        (uint32_t)tris.size(),
+        (uint32_t)verts.size(),
+    };
+
+    plSHA1Checksum sum;
+    sum.Start();
+    sum.AddTo(sizeof(header), reinterpret_cast<const uint8_t*>(header));
+    sum.AddTo(fCookingParams.size(), reinterpret_cast<const uint8_t*>(fCookingParams.c_str()));
+    for (const hsPoint3& vert : verts) {
+        const float pos[] = { vert.fX, vert.fY, vert.fZ };
+        sum.AddTo(sizeof(pos), reinterpret_cast<const uint8_t*>(pos));
+    }
+    if (!tris.empty())
+        sum.AddTo(tris.size() * sizeof(uint32_t), reinterpret_cast<const uint8_t*>(tris.data()));
+    sum.Finish();
+
+    return plFileName::Join(fDirectory, ST::format("{}.pxm", sum.GetAsHexString()));
+}
+
+bool plPXMeshCache::Load(const plFileName& file, std::vector<uint8_t>& cooked)
+{
+    hsUNIXStream stream;
+    if (!stream.Open(file, "rb")) {
+        fStats.fMisses++;
+        return false;
+    }
+
+    uint32_t eof = stream.GetEOF();
+    if (eof < sizeof(uint32_t) * 3 || stream.ReadLE32() != kMeshCacheMagic ||
+        stream.ReadLE32() != kMeshCacheVersion) {
+        fStats.fFailures++;
+        return false;
+    }
+
+    uint32_t size = stream.ReadLE32();
+    if (size != stream.GetSizeLeft()) {
+        fStats.fFailures++;
+        return false;
+    }
+
+    cooked.resize(size);
+    stream.Read(size, cooked.data());
+    fStats.fHits++;
+    return true;
+}
+
+void plPXMeshCache::Store(const plFileName& file, const void* cooked, uint32_t size)
+{
+    // Write to the side and move it into place so a crash can never leave a
+    // half-written entry behind. The temp name is ours alone (process and
+    // store), so another client, or thread, cooking the same mesh writes its
+    // own and the last Move() wins. Move() replaces any old entry atomically,
+    // so there's no window where the entry is missing, either.
+    static std::atomic<uint32_t> s_storeSerial;
+    plFileName tempFile = ST::format("{}.{}-{}.tmp", file, getpid(), s_storeSerial++);
+    bool written;
+    {
+        hsUNIXStream stream;
+        if (!stream.Open(tempFile, "wb"))
+            return;
+
+        stream.WriteLE32(kMeshCacheMagic);
+        stream.WriteLE32(kMeshCacheVersion);
+        stream.WriteLE32(size);
+        written = stream.Write(size, cooked) == size;
+    }
+
+    if (written && plFileSystem::Move(tempFile, file))
+        fStats.fStores++;
+    else
+        plFileSystem::Unlink(tempFile);
+}
+
+void plPXMeshCache::Reject(const plFileName& file)
+{
+    // Counted as a hit by Load(); it's really a failure, and it'll be recooked
+    fStats.fHits--;
+    fStats.fFailures++;
+    plFileSystem::Unlink(file);
+}
@@ -0,0 +1,115 @@
+/*==LICENSE==*
+
+CyanWorlds.com Engine - MMOG client, server and tools
+Copyright (C) 2011  Cyan Worlds, Inc.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Additional permissions under GNU GPL version 3 section 7
+
+If you modify this Program, or any covered work, by linking or
+combining it with any of RAD Game Tools Bink SDK, Autodesk 3ds Max SDK,
+NVIDIA PhysX SDK, Microsoft DirectX SDK, OpenSSL library, Independent
+JPEG Group JPEG library, Microsoft Windows Media SDK, or Apple QuickTime SDK
+(or a modified version of those libraries),
+containing parts covered by the terms of the Bink SDK EULA, 3ds Max EULA,
+PhysX SDK EULA, DirectX SDK EULA, OpenSSL and SSLeay licenses, IJG
+JPEG Library README, Windows Media SDK EULA, or QuickTime SDK EULA, the
+licensors of this Program grant you additional
+permission to convey the resulting work. Corresponding Source for a
+non-source form of such a combination shall include the source code for
+the parts of OpenSSL and IJG JPEG Library used as well as that of the covered
+work.
+
+You can contact Cyan Worlds, Inc. by email legal@cyan.com
+ or by snail mail at:
+      Cyan Worlds, Inc.
+      14617 N Newport Hwy
+      Mead, WA   99021
+
+*==LICENSE==*/
+
+#ifndef plPXMeshCache_h_inc
+#define plPXMeshCache_h_inc
+
+#include "plFileSystem.h"
+
+#include <string_theory/string>
+#include <vector>
+
+struct hsPoint3;
+
+/**
+ * On-disk cache of cooked PhysX meshes.
+ * Plasma data only ships the legacy PhysX 2.6 mesh format, which has to be
+ * uncooked and re-cooked every time a page is loaded. The result of cooking
+ * depends only on the mesh itself and the cooking parameters, so we keep the
+ * serialized PhysX stream around, named by a SHA-1 of all of that, and
+ * deserialize it instead the next time the same mesh comes along.
+ */
+class plPXMeshCache
+{
+public:
+    enum MeshType
+    {
+        kConvexHull,
+        kTriangleMesh,
+    };
+
+    struct Stats
+    {
+        uint32_t fHits{};
+        uint32_t fMisses{};
+        uint32_t fStores{};
+        uint32_t fFailures{};   // Unreadable or unloadable cache files
+    };
+
+protected:
+    plFileName fDirectory;
+    ST::string fCookingParams;
+    Stats fStats;
+
+public:
+    /** Sets the cache location. An invalid directory disables the cache. */
+    void SetDirectory(const plFileName& dir);
+    const plFileName& GetDirectory() const { return fDirectory; }
+    bool IsEnabled() const { return fDirectory.IsValid(); }
+
+    /**
+     * Sets a description of everything that affects cooking other than the
+     * mesh itself (SDK version, tolerances, preprocessing flags...).
+     * Changing this invalidates every existing entry.
+     */
+    void SetCookingParams(const ST::string& params) { fCookingParams = params; }
+
+    /** Gets the cache file that a cooked mesh with these inputs belongs in. */
+    [[nodiscard]]
+    plFileName GetCacheFile(MeshType type, uint32_t flags,
+                            const std::vector<uint32_t>& tris,
+                            const std::vector<hsPoint3>& verts) const;
+
+    /** Reads a cooked mesh, counting a hit or a miss. */
+    bool Load(const plFileName& file, std::vector<uint8_t>& cooked);
+
+    /** Writes a freshly cooked mesh. */
+    void Store(const plFileName& file, const void* cooked, uint32_t size);
+
+    /** Records that a cache file could be read, but PhysX rejected its contents. */
+    void Reject(const plFileName& file);
+
+    const Stats& GetStats() const { return fStats; }
+    void ResetStats() { fStats = {}; }
+};
+
+#endif
@@ -48,6 +48,7 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 #include "plPXSubWorld.h"
 #include "plSimulationMgr.h"
 
+#include "hsTimer.h"
 #include "plProfile.h"
 
 #include "pnNetCommon/plNetApp.h"
@@ -73,6 +74,10 @@ constexpr float kToleranceScaleSpeed = 32.f;
 
 plProfile_CreateTimer(  "Apply Controller Animations", "Simulation", ApplyController);
 plProfile_CreateTimer(  "PhysX Simulation", "Simulation", Step);
+plProfile_CreateTimer(  "  Kick Off Scenes", "Simulation", StepKick);
+plProfile_CreateTimer(  "  Fetch Results", "Simulation", StepFetch);
+plProfile_CreateTimer(  "  Overlapped With Frame", "Simulation", StepOverlap);
+plProfile_CreateCounter("  Scenes Stepped", "Simulation", ScenesStepped);
 plProfile_CreateTimer(  "  Contact Callback", "Simulation", ContactCallback);
 plProfile_CreateTimer(  "  Trigger Callback", "Simulation", TriggerCallback);
 plProfile_CreateCounter("  Active Bodies", "Simulation", ActiveBodies);
@@ -307,14 +312,20 @@ static physx::PxFilterFlags ISimulationFilterShader(physx::PxFilterObjectAttribu
 
 // ==========================================================================
 
+static plFileName s_cookedMeshCacheDir;
+static uint32_t s_dispatcherThreads = 0;
+
 plPXSimulation::plPXSimulation()
     : fPxFoundation(), fDebugger(), fTransport(), fPxPhysics(), fPxCooking(),
-      fPxCpuDispatcher(), fAccumulator()
+      fPxCpuDispatcher(), fAccumulator(), fPendingSubSteps(), fStepKickedTicks()
 {
 }
 
 plPXSimulation::~plPXSimulation()
 {
+    // PhysX won't release a scene that is still simulating.
+    IFetchResults();
+
     // This should only run for the empty main world.
     for (auto [key, world] : fWorlds) {
         world.fControllers->release();
@@ -382,14 +393,17 @@ bool plPXSimulation::Init()
         return false;
     }
 
-    // Worker threads actually slow down our simulation - probably because Uru scenes are mostly
+    // Worker threads actually slow down a single scene - probably because Uru scenes are mostly
     // composed of static geometry, so the thread synchronization adds more overhead than the
-    // threads help.
-    fPxCpuDispatcher = physx::PxDefaultCpuDispatcherCreate(0);
+    // threads help. They only pay off when several subworlds step at once or when the step
+    // runs asynchronously, so they're opt-in.
+    fPxCpuDispatcher = physx::PxDefaultCpuDispatcherCreate(s_dispatcherThreads);
     if (!fPxCpuDispatcher) {
         plStatusLog::AddLineS("Simulation.log", plStatusLog::kRed, "PhysX CPU Dispatcher failed to initialize!");
         return false;
     }
+    if (s_dispatcherThreads)
+        plStatusLog::AddLineSF("Simulation.log", "PhysX CPU Dispatcher using {} worker threads", s_dispatcherThreads);
 
     physx::PxCookingParams params(scale);
     // disable mesh cleaning - perform mesh validation on development configurations
@@ -403,6 +417,17 @@ bool plPXSimulation::Init()
         return false;
     }
 
+    // Anything that changes what the cooker spits out has to be in here,
+    // otherwise we'll happily load stale meshes from the cache.
+    fMeshCache.SetCookingParams(ST::format("{x}:{.6f}:{.6f}:{x}",
+                                           PX_PHYSICS_VERSION, scale.length, scale.speed,
+                                           uint32_t(params.meshPreprocessParams)));
+    if (s_cookedMeshCacheDir.IsValid())
+        fMeshCache.SetDirectory(s_cookedMeshCacheDir);
+    else
+        fMeshCache.SetDirectory(plFileName::Join(plFileSystem::GetUserDataPath(), "PhysXCache"));
+    plStatusLog::AddLineSF("Simulation.log", "Caching cooked meshes in {}", fMeshCache.GetDirectory());
+
     // Purposefully create AND LEAK the default material so it's always the first one we check.
     // In most Cyan Ages, this is the one and only material. This material will be destroyed by
     // fPxPhysics->release() in the dtor.
@@ -413,6 +438,31 @@ bool plPXSimulation::Init()
 
 // ==========================================================================
 
+void plPXSimulation::SetDispatcherThreads(uint32_t threads)
+{
+    s_dispatcherThreads = threads;
+}
+
+void plPXSimulation::SetCookedMeshCacheDir(plFileName dir)
+{
+    s_cookedMeshCacheDir = std::move(dir);
+}
+
+void plPXSimulation::LogMeshCacheStats()
+{
+    if (!fMeshCache.IsEnabled())
+        return;
+
+    const plPXMeshCache::Stats& stats = fMeshCache.GetStats();
+    if (stats.fHits || stats.fMisses || stats.fFailures) {
+        plStatusLog::AddLineSF("Simulation.log", "Cooked mesh cache: {} hits, {} misses, {} stored, {} bad",
+                               stats.fHits, stats.fMisses, stats.fStores, stats.fFailures);
+    }
+    fMeshCache.ResetStats();
+}
+
+// ==========================================================================
+
 static plFileName s_defaultDebuggerEndpoint;
 
 void plPXSimulation::SetDefaultDebuggerEndpoint(plFileName endpoint)
@@ -475,6 +525,32 @@ bool plPXSimulation::IsDebuggerConnected() const
 
 // ==========================================================================
 
+template<typename MeshT, typename DescT, typename CookFn, typename CreateFn>
+MeshT* plPXSimulation::ICookMesh(plPXMeshCache::MeshType type, uint32_t flags,
+                                 const std::vector<uint32_t>& tris, const std::vector<hsPoint3>& verts,
+                                 const DescT& desc, CookFn cook, CreateFn create)
+{
+    plFileName cacheFile = fMeshCache.GetCacheFile(type, flags, tris, verts);
+
+    std::vector<uint8_t> cooked;
+    if (fMeshCache.Load(cacheFile, cooked)) {
+        physx::PxDefaultMemoryInputData input(cooked.data(), (physx::PxU32)cooked.size());
+        if (MeshT* mesh = create(input))
+            return mesh;
+
+        // Written by some other build of the SDK, or just garbage. Cook it again.
+        fMeshCache.Reject(cacheFile);
+    }
+
+    physx::PxDefaultMemoryOutputStream output;
+    if (!cook(desc, output))
+        return nullptr;
+    fMeshCache.Store(cacheFile, output.getData(), output.getSize());
+
+    physx::PxDefaultMemoryInputData input(output.getData(), output.getSize());
+    return create(input);
+}
+
 physx::PxConvexMesh* plPXSimulation::InsertConvexHull(const std::vector<uint32_t>& tris,
                                                       const std::vector<hsPoint3>& verts)
 {
@@ -490,7 +566,18 @@ physx::PxConvexMesh* plPXSimulation::InsertConvexHull(const std::vector<uint32_t
     if (tris.empty())
         desc.flags |= physx::PxConvexFlag::eCOMPUTE_CONVEX;
 
-    return fPxCooking->createConvexMesh(desc, fPxPhysics->getPhysicsInsertionCallback());
+    if (!fMeshCache.IsEnabled())
+        return fPxCooking->createConvexMesh(desc, fPxPhysics->getPhysicsInsertionCallback());
+
+    return ICookMesh<physx::PxConvexMesh>(
+        plPXMeshCache::kConvexHull, uint32_t(desc.flags), tris, verts, desc,
+        [this](const physx::PxConvexMeshDesc& desc, physx::PxOutputStream& out) {
+            return fPxCooking->cookConvexMesh(desc, out);
+        },
+        [this](physx::PxInputStream& in) {
+            return fPxPhysics->createConvexMesh(in);
+        }
+    );
 }
 
 physx::PxTriangleMesh* plPXSimulation::InsertTriangleMesh(const std::vector<uint32_t>& tris,
@@ -504,7 +591,18 @@ physx::PxTriangleMesh* plPXSimulation::InsertTriangleMesh(const std::vector<uint
     desc.triangles.stride = sizeof(uint32_t) * 3;
     desc.triangles.data = &tris[0];
 
-    return fPxCooking->createTriangleMesh(desc, fPxPhysics->getPhysicsInsertionCallback());
+    if (!fMeshCache.IsEnabled())
+        return fPxCooking->createTriangleMesh(desc, fPxPhysics->getPhysicsInsertionCallback());
+
+    return ICookMesh<physx::PxTriangleMesh>(
+        plPXMeshCache::kTriangleMesh, uint32_t(desc.flags), tris, verts, desc,
+        [this](const physx::PxTriangleMeshDesc& desc, physx::PxOutputStream& out) {
+            return fPxCooking->cookTriangleMesh(desc, out);
+        },
+        [this](physx::PxInputStream& in) {
+            return fPxPhysics->createTriangleMesh(in);
+        }
+    );
 }
 
 physx::PxRigidActor* plPXSimulation::CreateRigidActor(const physx::PxGeometry& geometry,
@@ -636,6 +734,8 @@ physx::PxMaterial* plPXSimulation::InitMaterial(float uStatic, float uDynamic, f
 
 void plPXSimulation::AddToWorld(physx::PxActor* actor, const plKey& world)
 {
+    IFetchResults();
+
     actor->setName(static_cast<plPXActorData*>(actor->userData)->c_str());
     if (physx::PxScene* scene = actor->getScene()) {
         scene->removeActor(*actor);
@@ -655,6 +755,8 @@ void plPXSimulation::AddToWorld(physx::PxActor* actor, const plKey& world)
 
 physx::PxController* plPXSimulation::CreateCharacterController(physx::PxControllerDesc& desc, const plKey& world)
 {
+    IFetchResults();
+
     physx::PxControllerManager* controllerMgr;
     auto it = fWorlds.find(world);
     if (it == fWorlds.end()) {
@@ -680,6 +782,8 @@ physx::PxScene* plPXSimulation::FindScene(const plKey& world)
 
 void plPXSimulation::RemoveFromWorld(physx::PxRigidActor* actor)
 {
+    IFetchResults();
+
     physx::PxScene* scene = actor->getScene();
     hsAssert(scene, "actor not in a scene");
 
@@ -692,6 +796,8 @@ void plPXSimulation::RemoveFromWorld(physx::PxRigidActor* actor)
 
 void plPXSimulation::RemoveFromWorld(physx::PxController* controller)
 {
+    IFetchResults();
+
     physx::PxScene* scene = controller->getScene();
     hsAssert(scene, "controller not in a scene");
 
@@ -703,6 +809,17 @@ void plPXSimulation::RemoveFromWorld(physx::PxController* controller)
 
 bool plPXSimulation::Advance(float delta)
 {
+    if (!BeginAdvance(delta))
+        return false;
+    return EndAdvance();
+}
+
+bool plPXSimulation::BeginAdvance(float delta)
+{
+    // Callers are expected to finish one step before starting another.
+    hsAssert(!IsStepPending(), "Starting a simulation step with the previous one still in flight");
+    EndAdvance();
+
     fAccumulator += delta;
     if (fAccumulator < kDefaultStepSize) {
         // Not enough time has passed to perform a physics substep, but we need to propagate
@@ -729,13 +846,39 @@ bool plPXSimulation::Advance(float delta)
     plPXPhysicalControllerCore::Apply(delta);
     plProfile_EndTiming(ApplyController);
 
+    // Start every subworld before waiting on any of them. With no dispatcher threads, simulate()
+    // does all of the work inline, so this is no slower than stepping them back to back.
     plProfile_BeginTiming(Step);
+    plProfile_BeginTiming(StepKick);
+    fSimulatingScenes.reserve(fWorlds.size());
     for (auto [key, world] : fWorlds) {
         world.fScene->simulate(delta);
-        world.fScene->fetchResults(true);
+        fSimulatingScenes.push_back(world.fScene);
+    }
+    plProfile_EndTiming(StepKick);
+    plProfile_EndTiming(Step);
+    plProfile_IncCount(ScenesStepped, (int)fSimulatingScenes.size());
+
+    fPendingSubSteps = numSubSteps;
+    fStepKickedTicks = hsTimer::GetTicks();
+    return true;
+}
+
+void plPXSimulation::IFetchResults()
+{
+    if (fSimulatingScenes.empty())
+        return;
+
+    // Time the caller spent on other things while the scenes were running.
+    plProfile_Set(StepOverlap, hsTimer::GetTicks() - fStepKickedTicks);
+
+    plProfile_BeginTiming(Step);
+    plProfile_BeginTiming(StepFetch);
+    for (physx::PxScene* scene : fSimulatingScenes) {
+        scene->fetchResults(true);
 
         physx::PxSimulationStatistics stats;
-        world.fScene->getSimulationStatistics(stats);
+        scene->getSimulationStatistics(stats);
         plProfile_IncCount(ActiveBodies, stats.nbActiveDynamicBodies + stats.nbActiveDynamicBodies);
         plProfile_IncCount(ActiveDynamics, stats.nbActiveDynamicBodies);
         plProfile_IncCount(ActiveKinematics, stats.nbActiveKinematicBodies);
@@ -744,12 +887,24 @@ bool plPXSimulation::Advance(float delta)
         plProfile_IncCount(Kinematics, stats.nbKinematicBodies);
         plProfile_IncCount(Statics, stats.nbStaticBodies);
     }
+    plProfile_EndTiming(StepFetch);
     plProfile_EndTiming(Step);
 
+    fSimulatingScenes.clear();
+}
+
+bool plPXSimulation::EndAdvance()
+{
+    if (!IsStepPending())
+        return false;
+
+    IFetchResults();
+
     // Propagate the simulated controller movement to the SceneObjects for rendering purposes.
     plProfile_BeginTiming(CorrectController);
-    plPXPhysicalControllerCore::Update(numSubSteps, fAccumulator / kDefaultStepSize);
+    plPXPhysicalControllerCore::Update(fPendingSubSteps, fAccumulator / kDefaultStepSize);
     plProfile_EndTiming(CorrectController);
 
+    fPendingSubSteps = 0;
     return true;
 }
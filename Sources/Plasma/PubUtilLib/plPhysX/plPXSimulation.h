@@ -45,6 +45,8 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 #include "plFileSystem.h"
 #include "pnKeyedObject/plKey.h"
 
+#include "plPXMeshCache.h"
+
 #include <map>
 #include <optional>
 #include <string_theory/string>
@@ -145,10 +147,24 @@ protected:
     physx::PxDefaultCpuDispatcher* fPxCpuDispatcher;
     std::map<plKey, World> fWorlds;
     float fAccumulator;
+    plPXMeshCache fMeshCache;
+
+    // Scenes that have been told to simulate but haven't been fetched yet
+    std::vector<physx::PxScene*> fSimulatingScenes;
+    int fPendingSubSteps;
+    uint64_t fStepKickedTicks;
 
 protected:
     bool IConnectDebugger(physx::PxPvdTransport* transport);
 
+    /** Blocks until every scene kicked off by BeginAdvance() is done simulating. */
+    void IFetchResults();
+
+    template<typename MeshT, typename DescT, typename CookFn, typename CreateFn>
+    MeshT* ICookMesh(plPXMeshCache::MeshType type, uint32_t flags,
+                     const std::vector<uint32_t>& tris, const std::vector<hsPoint3>& verts,
+                     const DescT& desc, CookFn cook, CreateFn create);
+
 public:
     plPXSimulation();
     plPXSimulation(const plPXSimulation&) = delete;
@@ -178,6 +194,28 @@ public:
      */
     plPXDebuggerStatus ConnectDebugger(std::optional<plFileName> endpoint=std::nullopt);
 
+    /**
+     * Sets where cooked meshes are cached.
+     * By default, they go in a PhysXCache folder in the user data directory. This must be
+     * set before the simulation is initialized.
+     */
+    static void SetCookedMeshCacheDir(plFileName dir);
+
+    /** Gets the cooked mesh cache, for its statistics. */
+    [[nodiscard]]
+    plPXMeshCache& GetMeshCache() { return fMeshCache; }
+
+    /** Writes the cooked mesh cache counters to the log and resets them. */
+    void LogMeshCacheStats();
+
+    /**
+     * Sets how many worker threads the PhysX CPU dispatcher gets.
+     * With zero, the default, every scene simulates inline on the thread that calls
+     * BeginAdvance(). Worker threads let subworlds simulate concurrently and let the
+     * step overlap other work. This must be set before the simulation is initialized.
+     */
+    static void SetDispatcherThreads(uint32_t threads);
+
     /** Disconnects the PhysX Visual Debugger. */
     plPXDebuggerStatus DisconnectDebugger();
 
@@ -244,6 +282,23 @@ public:
 
     /** Advances the simulation. */
     bool Advance(float delta);
+
+    /**
+     * Starts advancing the simulation.
+     * All subworlds are kicked off before any of them are waited on. Returns false if not
+     * enough time has passed for a substep, in which case there is nothing to finish.
+     */
+    bool BeginAdvance(float delta);
+
+    /**
+     * Finishes the step started by BeginAdvance().
+     * Waits on the scenes and propagates their results to the controllers. Returns false
+     * if no step was in flight.
+     */
+    bool EndAdvance();
+
+    [[nodiscard]]
+    bool IsStepPending() const { return fPendingSubSteps != 0; }
 };
 
 #endif
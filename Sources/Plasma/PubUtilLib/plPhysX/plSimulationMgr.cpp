@@ -82,6 +82,7 @@ plProfile_CreateCounter("SetTransforms Accepted", "Simulation", SetTransforms);
 // declared at file scope so that both GetInstance and the destructor can access it.
 static plSimulationMgr* gTheInstance;
 bool plSimulationMgr::fExtraProfile = false;
+bool plSimulationMgr::fAsyncStep = false;
 
 void plSimulationMgr::Init()
 {
@@ -128,6 +129,9 @@ plSimulationMgr::plSimulationMgr()
 
 plSimulationMgr::~plSimulationMgr()
 {
+    // Don't leave PhysX running while the things its callbacks touch go away.
+    fSimulation->EndAdvance();
+
     fLOSDispatch->UnRef();
     fLOSDispatch = nullptr;
 
@@ -168,6 +172,10 @@ bool plSimulationMgr::MsgReceive(plMessage* msg)
 
     if (plAgeLoadedMsg* ageLoadedMsg = plAgeLoadedMsg::ConvertNoRef(msg)) {
         fSuspended = !ageLoadedMsg->fLoaded;
+
+        // Everything for the age has been cooked (or not) by now
+        if (ageLoadedMsg->fLoaded)
+            fSimulation->LogMeshCacheStats();
         return true;
     }
 
@@ -227,9 +235,29 @@ void plSimulationMgr::Advance(float delSecs)
     if (fSuspended)
         return;
 
+    // A step nobody collected has to land before the next one can start.
+    FinishAdvance();
+
+    bool stepped = fSimulation->BeginAdvance(delSecs);
+    if (stepped) {
+        if (fAsyncStep)
+            return;
+        fSimulation->EndAdvance();
+    }
+    IFinishStep(stepped);
+}
+
+void plSimulationMgr::FinishAdvance()
+{
+    if (fSimulation->EndAdvance())
+        IFinishStep(true);
+}
+
+void plSimulationMgr::IFinishStep(bool stepped)
+{
     // Only pump the sounds if the simulation actually advanced. Otherwise we get fascinating
     // (read: bad) sounds stopping/starting when the fps is greater than the simulation frequency.
-    if (fSimulation->Advance(delSecs))
+    if (stepped)
         fSoundMgr->Update();
 
     plProfile_BeginTiming(ProcessSyncs);
@@ -79,11 +79,18 @@ public:
 
     static bool fExtraProfile;
 
+    // When set, Advance() only kicks off the step. The results are collected by the
+    // next FinishAdvance(), so the simulation overlaps whatever the caller does in between.
+    static bool fAsyncStep;
+
     bool MsgReceive(plMessage* msg) override;
 
     // Advance the simulation by the given number of seconds
     void Advance(float delSecs);
 
+    // Collect the results of a step left running by Advance(), if any
+    void FinishAdvance();
+
     // The simulation won't run at all if it is suspended
     void Suspend() { fSuspended = true; }
     void Resume() { fSuspended = false; }
@@ -107,6 +114,9 @@ public:
     void ResetKickables();
 
 protected:
+    // Everything that has to happen after a frame's simulation work is done
+    void IFinishStep(bool stepped);
+
     void ISendUpdates();
 
     // Walk through the synchronization requests and send them as appropriate.
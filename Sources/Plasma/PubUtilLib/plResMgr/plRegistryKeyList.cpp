@@ -65,13 +65,27 @@ plRegistryKeyList::~plRegistryKeyList()
     }
 }
 
+void plRegistryKeyList::IBuildNameIndex() const
+{
+    fNameIndex.clear();
+    fNameIndex.reserve(fKeys.size());
+
+    // If there are duplicate names, the first key wins, just like a linear search
+    for (plKeyImp* key : fKeys) {
+        if (key)
+            fNameIndex.emplace(key->GetName(), key);
+    }
+    fNameIndexValid = true;
+}
+
 plKeyImp* plRegistryKeyList::FindKey(const ST::string& keyName) const
 {
-    auto it = std::find_if(fKeys.begin(), fKeys.end(),
-        [&] (plKeyImp* key) { return key && key->GetName().compare_i(keyName) == 0; }
-    );
-    if (it != fKeys.end())
-        return *it;
+    if (!fNameIndexValid)
+        IBuildNameIndex();
+
+    auto it = fNameIndex.find(keyName);
+    if (it != fNameIndex.end())
+        return it->second;
     else
         return nullptr;
 }
@@ -150,6 +164,10 @@ void plRegistryKeyList::AddKey(plKeyImp* key, LoadStatus& loadStatusChange)
         {
             fKeys.push_back(key);
             key->SetObjectID(fKeys.size());
+
+            // We're last in line, so we can't shadow an earlier key with the same name
+            if (fNameIndexValid)
+                fNameIndex.emplace(key->GetName(), key);
         }
         else
         {
@@ -157,6 +175,7 @@ void plRegistryKeyList::AddKey(plKeyImp* key, LoadStatus& loadStatusChange)
             if (fKeys.size() < id)
                 fKeys.resize(id);
             fKeys[id - 1] = key;
+            fNameIndexValid = false;
         }
         ++fReffedKeys;
     }
@@ -238,6 +257,7 @@ void plRegistryKeyList::Read(hsStream* s)
         fKeys[id - 1] = newKey;
     }
     fKeys.shrink_to_fit();
+    fNameIndexValid = false;
 }
 
 void plRegistryKeyList::Write(hsStream* s)
@@ -44,6 +44,8 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 
 #include "HeadSpin.h"
 
+#include <string_theory/string>
+#include <unordered_map>
 #include <vector>
 
 class plKeyImp;
@@ -65,9 +67,15 @@ protected:
 
     std::vector<plKeyImp*> fKeys;
 
+    // Index for finding keys by name, built the first time someone asks
+    typedef std::unordered_map<ST::string, plKeyImp*, ST::hash_i, ST::equal_i> NameIndex;
+    mutable NameIndex fNameIndex;
+    mutable bool fNameIndexValid;
+
     plRegistryKeyList() {}
 
     void IRepack();
+    void IBuildNameIndex() const;
     void ILock() { ++fLocked; }
     void IUnlock() { --fLocked; }
 
@@ -80,7 +88,7 @@ public:
     };
 
     plRegistryKeyList(uint16_t classType)
-        : fClassType(classType), fReffedKeys(0), fLocked(0)
+        : fClassType(classType), fReffedKeys(0), fLocked(0), fNameIndexValid(false)
     { }
     ~plRegistryKeyList();
 
@@ -41,15 +41,269 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 *==LICENSE==*/
 
 #include "plRegistryNode.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <limits>
+#include <mutex>
 #include <string_theory/format>
+#include <thread>
+#include <vector>
 
 #include "hsStream.h"
+#include "hsThread.h"
 #include "plRegistryHelpers.h"
 #include "plRegistryKeyList.h"
+#include "plResMgrSettings.h"
 #include "plVersion.h"
 
 #include "pnKeyedObject/plKeyImp.h"
 
+//// plRegistryPagePrefetch //////////////////////////////////////////////////
+//  A copy of a page file that is read into memory by one of the loader
+//  threads.  The loader only ever touches this object, never the page node,
+//  so the node is free to go away (or cancel) while the read is still going.
+
+class plRegistryPrefetchQueue;
+
+class plRegistryPagePrefetch
+{
+    friend class plRegistryPrefetchQueue;
+
+    std::mutex fMutex;
+    std::condition_variable fFinishedSignal;
+    bool fFinished;
+    bool fReserved;     // Counted against the queue's byte budget
+
+public:
+    const plFileName fPath;
+    const uint32_t fSize;
+    std::atomic<bool> fCancelled;
+    std::vector<uint8_t> fData; // Owned by the loader thread until finished
+    bool fSucceeded;
+
+    plRegistryPagePrefetch(plFileName path, uint32_t size)
+        : fFinished(), fReserved(), fPath(std::move(path)), fSize(size),
+          fCancelled(), fSucceeded()
+    { }
+    ~plRegistryPagePrefetch();
+
+    void Read();
+    void Finish();
+
+    bool IsFinished()
+    {
+        std::lock_guard<std::mutex> lock(fMutex);
+        return fFinished;
+    }
+
+    bool Wait(std::chrono::milliseconds timeout)
+    {
+        std::unique_lock<std::mutex> lock(fMutex);
+        return fFinishedSignal.wait_for(lock, timeout, [this] { return fFinished; });
+    }
+};
+
+//// plRegistryPrefetchQueue /////////////////////////////////////////////////
+//  A fixed set of loader threads that work through the pending prefetches in
+//  order.  A page only starts once its bytes fit in what's left of the budget
+//  (or nothing else is in memory), and its bytes are handed back when the
+//  prefetch is thrown away.  The resManager shuts it down for good on its way
+//  out; prefetches that outlive that (held by a stream, or destroyed after
+//  the queue itself) no longer have a budget to give anything back to.
+
+class plRegistryPrefetchQueue
+{
+    static std::atomic<bool> fShutDownForGood;
+
+    std::mutex fMutex;
+    std::condition_variable fWorkSignal;
+    std::deque<std::shared_ptr<plRegistryPagePrefetch>> fPending;
+    std::vector<std::thread> fLoaders;
+    uint64_t fBytesInUse;
+    bool fShutdown;
+
+    bool ICanStartNext() const
+    {
+        if (fPending.empty())
+            return false;
+
+        uint64_t budget = plResMgrSettings::Get().GetPrefetchBudget();
+        return fBytesInUse == 0 || fBytesInUse + fPending.front()->fSize <= budget;
+    }
+
+    void ILoaderThread()
+    {
+        hsThread::SetThisThreadName(ST_LITERAL("plPagePrefetch"));
+        for (;;) {
+            std::shared_ptr<plRegistryPagePrefetch> prefetch;
+            {
+                std::unique_lock<std::mutex> lock(fMutex);
+                fWorkSignal.wait(lock, [this] { return fShutdown || ICanStartNext(); });
+                if (fShutdown)
+                    return;
+
+                prefetch = std::move(fPending.front());
+                fPending.pop_front();
+                fBytesInUse += prefetch->fSize;
+                prefetch->fReserved = true;
+            }
+            prefetch->Read();
+        }
+    }
+
+public:
+    plRegistryPrefetchQueue() : fBytesInUse(), fShutdown() { }
+
+    ~plRegistryPrefetchQueue() { Shutdown(); }
+
+    static plRegistryPrefetchQueue& Get()
+    {
+        static plRegistryPrefetchQueue s_queue;
+        return s_queue;
+    }
+
+    void Push(std::shared_ptr<plRegistryPagePrefetch> prefetch)
+    {
+        {
+            std::lock_guard<std::mutex> lock(fMutex);
+            if (fShutdown) {
+                // Nobody's left to read it, so the page comes from disk
+                prefetch->fCancelled = true;
+                prefetch->Finish();
+                return;
+            }
+            if (fLoaders.empty()) {
+                uint32_t numLoaders = std::max(plResMgrSettings::Get().GetPrefetchThreads(), 1U);
+                for (uint32_t i = 0; i < numLoaders; ++i)
+                    fLoaders.emplace_back(hsThread::StartSimpleThread([this] { ILoaderThread(); }));
+            }
+            fPending.emplace_back(std::move(prefetch));
+        }
+        fWorkSignal.notify_one();
+    }
+
+    // Pulls a prefetch out of the queue if no loader has started on it yet.
+    // Returns false if it's already being read (or is done).
+    bool Cancel(const std::shared_ptr<plRegistryPagePrefetch>& prefetch)
+    {
+        {
+            std::lock_guard<std::mutex> lock(fMutex);
+            auto it = std::find(fPending.begin(), fPending.end(), prefetch);
+            if (it == fPending.end())
+                return false;
+            fPending.erase(it);
+        }
+        prefetch->fCancelled = true;
+        prefetch->Finish();
+        return true;
+    }
+
+    void CancelAll()
+    {
+        std::deque<std::shared_ptr<plRegistryPagePrefetch>> cancelled;
+        {
+            std::lock_guard<std::mutex> lock(fMutex);
+            cancelled.swap(fPending);
+        }
+        for (const auto& prefetch : cancelled) {
+            prefetch->fCancelled = true;
+            prefetch->Finish();
+        }
+    }
+
+    // Cancels everything that's still waiting and joins the loaders. Anything
+    // they were in the middle of is finished (or cancelled) by the time this
+    // returns.
+    void Shutdown()
+    {
+        CancelAll();
+        {
+            std::lock_guard<std::mutex> lock(fMutex);
+            fShutdown = true;
+        }
+        fWorkSignal.notify_all();
+        for (std::thread& loader : fLoaders)
+            loader.join();
+        fLoaders.clear();
+        fShutDownForGood = true;
+    }
+
+    // Doesn't touch the queue once it's shut down, since it may well be gone
+    static void ReturnBytes(uint32_t size)
+    {
+        if (fShutDownForGood)
+            return;
+
+        plRegistryPrefetchQueue& queue = Get();
+        {
+            std::lock_guard<std::mutex> lock(queue.fMutex);
+            queue.fBytesInUse -= size;
+        }
+        queue.fWorkSignal.notify_all();
+    }
+};
+
+std::atomic<bool> plRegistryPrefetchQueue::fShutDownForGood(false);
+
+plRegistryPagePrefetch::~plRegistryPagePrefetch()
+{
+    if (fReserved)
+        plRegistryPrefetchQueue::ReturnBytes(fSize);
+}
+
+void plRegistryPagePrefetch::Read()
+{
+    static constexpr uint32_t kChunkSize = 256 * 1024;
+
+    hsUNIXStream stream;
+    if (!fCancelled && stream.Open(fPath, "rb")) {
+        uint32_t size = std::min(stream.GetEOF(), fSize);
+        fData.resize(size);
+
+        uint32_t pos = 0;
+        while (pos < size && !fCancelled) {
+            uint32_t count = std::min(kChunkSize, size - pos);
+            if (stream.Read(count, fData.data() + pos) != count)
+                break;
+            pos += count;
+        }
+        fSucceeded = (pos == size);
+    }
+
+    if (!fSucceeded) {
+        fData.clear();
+        fData.shrink_to_fit();
+        fReserved = false;
+        plRegistryPrefetchQueue::ReturnBytes(fSize);
+    }
+
+    Finish();
+}
+
+void plRegistryPagePrefetch::Finish()
+{
+    std::lock_guard<std::mutex> lock(fMutex);
+    fFinished = true;
+    fFinishedSignal.notify_all();
+}
+
+// Keeps the prefetched data alive for as long as a stream is reading it
+class plPrefetchedPageStream : public hsReadOnlyStream
+{
+    std::shared_ptr<plRegistryPagePrefetch> fPrefetch;
+
+public:
+    plPrefetchedPageStream(std::shared_ptr<plRegistryPagePrefetch> prefetch)
+        : hsReadOnlyStream((int)prefetch->fData.size(), prefetch->fData.data()),
+          fPrefetch(std::move(prefetch))
+    { }
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
 plRegistryPageNode::plRegistryPageNode()
 {}
 
@@ -89,6 +343,7 @@ plRegistryPageNode::plRegistryPageNode(const plLocation& location, const ST::str
 
 plRegistryPageNode::~plRegistryPageNode()
 {
+    ReleasePrefetch();
     UnloadKeys();
 }
 
@@ -132,11 +387,24 @@ hsStream* plRegistryPageNode::OpenStream()
     if (fOpenRequests == 0)
     {
         hsAssert(fStream == nullptr, "plRegistryPageNode::fStream should be nullptr when not open!");
-        auto stream = std::make_unique<hsBufferedStream>();
-        if (!stream->Open(fPath, "rb")) {
-            return nullptr;
+
+        // If the loader thread has finished reading us in, use that instead of the disk
+        if (IsPrefetched()) {
+            fStream = std::make_unique<plPrefetchedPageStream>(fPrefetch);
+        } else {
+            // Map the page if we can, so reads come straight from the OS file cache.
+            // Fall back to plain old buffered reads if the OS won't cooperate.
+            auto mapped = std::make_unique<hsMappedFileStream>();
+            if (mapped->Open(fPath)) {
+                fStream = std::move(mapped);
+            } else {
+                auto stream = std::make_unique<hsBufferedStream>();
+                if (!stream->Open(fPath, "rb")) {
+                    return nullptr;
+                }
+                fStream = std::move(stream);
+            }
         }
-        fStream = std::move(stream);
     }
     fOpenRequests++;
     return fStream.get();
@@ -152,6 +420,57 @@ void plRegistryPageNode::CloseStream()
     }
 }
 
+void plRegistryPageNode::BeginPrefetch()
+{
+    if (fPrefetch || fIsNewPage || !IsValid())
+        return;
+
+    uint64_t size = plFileInfo(fPath).FileSize();
+    if (size == 0 || size > std::numeric_limits<uint32_t>::max())
+        return;
+
+    fPrefetch = std::make_shared<plRegistryPagePrefetch>(fPath, (uint32_t)size);
+    plRegistryPrefetchQueue::Get().Push(fPrefetch);
+}
+
+bool plRegistryPageNode::CancelPendingPrefetch()
+{
+    if (fPrefetch && plRegistryPrefetchQueue::Get().Cancel(fPrefetch)) {
+        fPrefetch.reset();
+        return true;
+    }
+    return false;
+}
+
+bool plRegistryPageNode::WaitForPrefetch(std::chrono::milliseconds timeout)
+{
+    return !fPrefetch || fPrefetch->Wait(timeout);
+}
+
+void plRegistryPageNode::ReleasePrefetch()
+{
+    if (fPrefetch) {
+        fPrefetch->fCancelled = true;
+        plRegistryPrefetchQueue::Get().Cancel(fPrefetch);
+        fPrefetch.reset();
+    }
+}
+
+void plRegistryPageNode::CancelAllPrefetches()
+{
+    plRegistryPrefetchQueue::Get().CancelAll();
+}
+
+void plRegistryPageNode::ShutdownPrefetches()
+{
+    plRegistryPrefetchQueue::Get().Shutdown();
+}
+
+bool plRegistryPageNode::IsPrefetched() const
+{
+    return fPrefetch && fPrefetch->IsFinished() && fPrefetch->fSucceeded;
+}
+
 void plRegistryPageNode::LoadKeys()
 {
     hsAssert(IsValid(), "Trying to load keys for invalid page");
@@ -177,12 +496,7 @@ void plRegistryPageNode::LoadKeys()
     for (uint32_t i = 0; i < numTypes; i++)
     {
         uint16_t classType = stream->ReadLE16();
-        plRegistryKeyList* keyList = IGetKeyList(classType);
-        if (!keyList)
-        {
-            keyList = new plRegistryKeyList(classType);
-            fKeyLists[classType] = keyList;
-        }
+        plRegistryKeyList* keyList = IGetOrCreateKeyList(classType);
         keyList->Read(stream);
     }
 
@@ -193,12 +507,11 @@ void plRegistryPageNode::LoadKeys()
 
 void plRegistryPageNode::UnloadKeys()
 {
-    KeyMap::iterator it = fKeyLists.begin();
-    for (; it != fKeyLists.end(); it++)
+    for (plRegistryKeyList*& keyList : fKeyLists)
     {
-        plRegistryKeyList* keyList = it->second;
-        it->second = nullptr;
-        delete keyList;
+        plRegistryKeyList* temp = keyList;
+        keyList = nullptr;
+        delete temp;
     }
     fKeyLists.clear();
 
@@ -210,7 +523,7 @@ void plRegistryPageNode::PrepForWrite()
     if (!fIsNewPage)
         return;
 
-    for (auto [idx, keyList] : fKeyLists)
+    for (plRegistryKeyList* keyList : fKeyLists)
         keyList->PrepForWrite();
 }
 
@@ -247,10 +560,8 @@ void plRegistryPageNode::Write()
     // versions of all our creatable types in the pageinfo.
     fPageInfo.ClearClassVersions();
 
-    KeyMap::const_iterator it;
-    for (it = fKeyLists.begin(); it != fKeyLists.end(); it++)
+    for (plRegistryKeyList* keyList : fKeyLists)
     {
-        plRegistryKeyList* keyList = it->second;
         int ver = plVersion::GetCreatableVersion(keyList->GetClassType());
         fPageInfo.AddClassVersion(keyList->GetClassType(), ver);
     }
@@ -268,9 +579,8 @@ void plRegistryPageNode::Write()
 
     // Write our keys
     stream.WriteLE32((uint32_t)fKeyLists.size());
-    for (it = fKeyLists.begin(); it != fKeyLists.end(); it++)
+    for (plRegistryKeyList* keyList : fKeyLists)
     {
-        plRegistryKeyList* keyList = it->second;
         stream.WriteLE16(keyList->GetClassType());
         keyList->Write(&stream);
     }
@@ -285,10 +595,11 @@ void plRegistryPageNode::Write()
 
 bool plRegistryPageNode::IterateKeys(plRegistryKeyIterator* iterator) const
 {
-    KeyMap::const_iterator it = fKeyLists.begin();
-    for (; it != fKeyLists.end(); it++)
+    // The iterator may add keys of a brand new type to us, which would shuffle
+    // fKeyLists out from under us.  Walk a snapshot of it instead.
+    KeyLists keyLists = fKeyLists;
+    for (plRegistryKeyList* keyList : keyLists)
     {
-        plRegistryKeyList* keyList = it->second;
         if (!keyList->IterateKeys(iterator))
             return false;
     }
@@ -330,12 +641,7 @@ plKeyImp* plRegistryPageNode::FindKey(const plUoid& uoid) const
 void plRegistryPageNode::AddKey(plKeyImp* key)
 {
     uint16_t classType = key->GetUoid().GetClassType();
-    plRegistryKeyList* keys = fKeyLists[classType];
-    if (keys == nullptr)
-    {
-        keys = new plRegistryKeyList(classType);
-        fKeyLists[classType] = keys;
-    }
+    plRegistryKeyList* keys = IGetOrCreateKeyList(classType);
 
     // Error check
     if (keys->FindKey(key->GetUoid().GetObjectName()) != nullptr)
@@ -397,15 +703,29 @@ bool plRegistryPageNode::SetKeyUnused(plKeyImp* key)
     return removed;
 }
 
+static bool IKeyListLess(const plRegistryKeyList* keyList, uint16_t classType)
+{
+    return keyList->GetClassType() < classType;
+}
+
 plRegistryKeyList* plRegistryPageNode::IGetKeyList(uint16_t classType) const
 {
-    KeyMap::const_iterator it = fKeyLists.find(classType);
-    if (it != fKeyLists.end())
-        return it->second;
+    auto it = std::lower_bound(fKeyLists.begin(), fKeyLists.end(), classType, IKeyListLess);
+    if (it != fKeyLists.end() && (*it)->GetClassType() == classType)
+        return *it;
 
     return nullptr;
 }
 
+plRegistryKeyList* plRegistryPageNode::IGetOrCreateKeyList(uint16_t classType)
+{
+    auto it = std::lower_bound(fKeyLists.begin(), fKeyLists.end(), classType, IKeyListLess);
+    if (it != fKeyLists.end() && (*it)->GetClassType() == classType)
+        return *it;
+
+    return *fKeyLists.insert(it, new plRegistryKeyList(classType));
+}
+
 void plRegistryPageNode::DeleteSource()
 {
     hsAssert(fOpenRequests == 0, "Deleting a stream that's open for reading");
@@ -46,10 +46,12 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 #include "plFileSystem.h"
 #include "plPageInfo.h"
 
-#include <map>
+#include <chrono>
 #include <memory>
+#include <vector>
 
 class hsStream;
+class plRegistryPagePrefetch;
 class plRegistryKeyList;
 class plKeyImp;
 class plRegistryKeyIterator;
@@ -71,9 +73,10 @@ class plRegistryPageNode
 protected:
     friend class plKeyFinder;
 
-    // Map from class type to a list of keys of that type
-    typedef std::map<uint16_t, plRegistryKeyList*> KeyMap;
-    KeyMap fKeyLists;
+    // Lists of keys for each class type, sorted by class type.  Pages only
+    // hold a few dozen types, so a binary search of this beats a tree.
+    typedef std::vector<plRegistryKeyList*> KeyLists;
+    KeyLists fKeyLists;
     uint32_t fLoadedTypes;      // The number of key types that have dynamic keys loaded
 
     PageCond    fValid;         // Condition of the page
@@ -85,9 +88,13 @@ protected:
                                 // zero if it's closed)
     bool fIsNewPage;          // True if this page is new (not read off disk)
 
+    // Copy of the page file being read into memory by a loader thread
+    std::shared_ptr<plRegistryPagePrefetch> fPrefetch;
+
     plRegistryPageNode();
 
     plRegistryKeyList* IGetKeyList(uint16_t classType) const;
+    plRegistryKeyList* IGetOrCreateKeyList(uint16_t classType);
     PageCond IVerify();
 
 public:
@@ -139,6 +146,26 @@ public:
     hsStream*   OpenStream();
     void        CloseStream();
 
+    // Queues the entire page file to be read into memory by a loader thread.
+    // Once that finishes, OpenStream will read from the copy in memory rather
+    // than going to the disk for every object.
+    void        BeginPrefetch();
+    // Drops the prefetch if no loader has started on it yet.  Returns true if
+    // it was dropped, in which case the page will be read from disk.
+    bool        CancelPendingPrefetch();
+    // Waits up to timeout for a prefetch to finish (or fail).  Returns false
+    // if it's still going.
+    bool        WaitForPrefetch(std::chrono::milliseconds timeout);
+    // Cancels a prefetch and frees the memory it holds.  Any stream that is
+    // already open on the prefetched data stays valid until closed.
+    void        ReleasePrefetch();
+    bool        IsPrefetched() const;
+    // Drops every prefetch that no loader has started on yet
+    static void CancelAllPrefetches();
+    // Drops the rest and stops the loader threads for good.  Later prefetches
+    // just fail, so their pages are read from disk.
+    static void ShutdownPrefetches();
+
     // Export time only.  Before we write to disk, assign all the loaded keys
     // sequential object IDs that they can use to do fast lookups at load time.
     void PrepForWrite();
@@ -168,6 +168,8 @@ bool plResManager::IReset()   // Used to Re-Export (number of times)
 
 void plResManager::BeginShutdown()
 {
+    CancelPendingPrefetches();
+
     if (fMyHelper)
         fMyHelper->SetInShutdown(true);
 }
@@ -228,6 +230,10 @@ void plResManager::IShutdown()
     }
     fAllPages.clear();
 
+    // Deleting the pages cancelled their prefetches, so this only has to wait
+    // out whatever chunk the loaders were in the middle of
+    plRegistryPageNode::ShutdownPrefetches();
+
     IUnlockPages();
 
     // Now, kill off the Dispatcher
@@ -1175,7 +1181,18 @@ void plResManager::PageInRoom(const plLocation& page, uint16_t objClassToRef, pl
         return;
     }
 
-    // Step 0.9: Open the stream on this page, so it remains open for the entire loading process
+    // Step 0.9: Open the stream on this page, so it remains open for the entire loading process.
+    // If no loader has gotten to this page yet, don't wait in line, just read it ourselves.
+    // If one is partway through, it's going to beat us to the disk anyway, so wait for it
+    // while letting the progress proc keep the screen alive.
+    if (!pageNode->CancelPendingPrefetch())
+    {
+        while (!pageNode->WaitForPrefetch(std::chrono::milliseconds(15)))
+        {
+            if (fProgressProc != nullptr)
+                fProgressProc(nullptr);
+        }
+    }
     pageNode->OpenStream();
 
     // Step 1: We force a load on all the keys in the given page
@@ -1197,6 +1214,7 @@ void plResManager::PageInRoom(const plLocation& page, uint16_t objClassToRef, pl
         // This is coming up a lot lately; too intrusive to be an assert.
         // hsAssert( false, "No object found on which to base our PageInRoom()" );
         pageNode->CloseStream();
+        pageNode->ReleasePrefetch();
         return;
     }
 
@@ -1215,8 +1233,9 @@ void plResManager::PageInRoom(const plLocation& page, uint16_t objClassToRef, pl
     kResMgrLog(2, ILog(2, "...Dispatching refMessage..."));
     AddViaNotify(objKey, refMsg, plRefFlags::kActiveRef);
 
-    // Step 5.9: Close the page stream
+    // Step 5.9: Close the page stream, and let go of the in-memory copy if we had one
     pageNode->CloseStream();
+    pageNode->ReleasePrefetch();
 
     // All done!
     kResMgrLog(1, ILog(1, "...Page in complete!"));
@@ -1231,6 +1250,32 @@ void plResManager::PageInRoom(const plLocation& page, uint16_t objClassToRef, pl
     }
 }
 
+void plResManager::PrefetchPage(const plLocation& page)
+{
+    plRegistryPageNode* pageNode = FindPage(page);
+    if (pageNode == nullptr || pageNode->GetPageCondition() != kPageOk || pageNode->IsLoaded())
+        return;
+
+    uint32_t maxSize = plResMgrSettings::Get().GetMaxPrefetchSize();
+    if (maxSize == 0 || plFileInfo(pageNode->GetPagePath()).FileSize() > maxSize)
+        return;
+
+    kResMgrLog(2, ILog(2, "Prefetching page {}>{}", pageNode->GetPageInfo().GetAge(), pageNode->GetPageInfo().GetPage()));
+    pageNode->BeginPrefetch();
+}
+
+void plResManager::CancelPrefetch(const plLocation& page)
+{
+    plRegistryPageNode* pageNode = FindPage(page);
+    if (pageNode != nullptr)
+        pageNode->ReleasePrefetch();
+}
+
+void plResManager::CancelPendingPrefetches()
+{
+    plRegistryPageNode::CancelAllPrefetches();
+}
+
 class plPageInAgeIter : public plRegistryPageIterator
 {
 private:
@@ -57,7 +57,8 @@ class plResManagerHelper;
 class plDispatch;
 
 // plProgressProc is a proc called every time an object loads, to keep a progress bar for
-// loading ages up-to-date.
+// loading ages up-to-date.  While a page in is waiting on a loader thread, it is called
+// with a null key instead, so the screen can be kept alive without moving the bar.
 typedef void(*plProgressProc)(const plKey& key);
 
 class plResManager : public hsResMgr
@@ -138,6 +139,15 @@ public:
     void PageInRoom(const plLocation& page, uint16_t objClassToRef, plRefMsg* refMsg);
     void PageInAge(const ST::string& age);
 
+    // Starts reading a page into memory in the background, so that a later
+    // PageInRoom only has to deserialize its objects instead of also waiting
+    // on the disk.  CancelPrefetch throws away the data if the page isn't
+    // going to be loaded after all.  CancelPendingPrefetches drops every page
+    // that no loader thread has started on yet.
+    void PrefetchPage(const plLocation& page);
+    void CancelPrefetch(const plLocation& page);
+    void CancelPendingPrefetches();
+
     // Usually, a page file is kept open during load because the first keyed object
     // read causes all the other objects to be read before it returns.  In some
     // cases though (mostly just the texture file), this doesn't work.  In that
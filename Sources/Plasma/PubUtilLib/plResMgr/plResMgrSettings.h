@@ -68,6 +68,10 @@ protected:
     bool fPassiveKeyRead;
     bool fLoadPagesOnInit;
 
+    uint32_t fMaxPrefetchSize;
+    uint64_t fPrefetchBudget;
+    uint32_t fPrefetchThreads;
+
     plResMgrSettings()
     {
         fFilterOlderPageVersions = true;
@@ -75,6 +79,9 @@ protected:
         fPassiveKeyRead = false;
         fLoadPagesOnInit = true;
         fLoggingLevel = 0;
+        fMaxPrefetchSize = 64 * 1024 * 1024;
+        fPrefetchBudget = 256 * 1024 * 1024;
+        fPrefetchThreads = 2;
     }
 
 public:
@@ -102,6 +109,21 @@ public:
     bool GetLoadPagesOnInit() const { return fLoadPagesOnInit; }
     void SetLoadPagesOnInit(bool load) { fLoadPagesOnInit = load; }
 
+    // Largest page file (in bytes) that will be read into memory ahead of
+    // time by plResManager::PrefetchPage.  Zero disables prefetching.
+    uint32_t GetMaxPrefetchSize() const { return fMaxPrefetchSize; }
+    void     SetMaxPrefetchSize(uint32_t size) { fMaxPrefetchSize = size; }
+
+    // Most bytes of page data that may be held in memory by prefetches at
+    // once.  Pages past that wait in line until earlier ones are released.
+    uint64_t GetPrefetchBudget() const { return fPrefetchBudget; }
+    void     SetPrefetchBudget(uint64_t bytes) { fPrefetchBudget = bytes; }
+
+    // Number of loader threads reading prefetched pages.  Only takes effect
+    // before the first page is prefetched.
+    uint32_t GetPrefetchThreads() const { return fPrefetchThreads; }
+    void     SetPrefetchThreads(uint32_t count) { fPrefetchThreads = count; }
+
     static plResMgrSettings& Get();
 };
 
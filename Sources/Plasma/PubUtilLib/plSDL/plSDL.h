@@ -47,7 +47,9 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 //
 
 #include <list>
+#include <map>
 #include <string_theory/format>
+#include <unordered_map>
 
 #include "plSDLDescriptor.h"
 
@@ -468,7 +470,7 @@ protected:
     void IWriteHeader(hsStream* s) const;
     bool IConvertVar(plSimpleStateVariable* fromVar, plSimpleStateVariable* toVar, bool force);
 
-    plStateVariable* IFindVar(const VarsList& vars, const ST::string& name) const;
+    plStateVariable* IFindVar(const VarsList& vars, int idx, const ST::string& name) const;
     int IGetNumUsedVars(const VarsList& vars) const;
     int IGetUsedVars(const VarsList& varsOut, VarsList *varsIn) const;  // build a list of vars that have data
     bool IHasUsedVars(const VarsList& vars) const;
@@ -492,8 +494,14 @@ public:
     uint32_t GetFlags() const { return fFlags;    }
     void SetFlags(uint32_t f) { fFlags =f;    }
     
-    plSimpleStateVariable* FindVar(const ST::string& name) const { return (plSimpleStateVariable*)IFindVar(fVarsList, name); }
-    plSDStateVariable* FindSDVar(const ST::string& name) const { return (plSDStateVariable*)IFindVar(fSDVarsList, name); }
+    plSimpleStateVariable* FindVar(const ST::string& name) const
+    {
+        return (plSimpleStateVariable*)IFindVar(fVarsList, fDescriptor ? fDescriptor->FindSimpleVarIndex(name) : -1, name);
+    }
+    plSDStateVariable* FindSDVar(const ST::string& name) const
+    {
+        return (plSDStateVariable*)IFindVar(fSDVarsList, fDescriptor ? fDescriptor->FindSDVarIndex(name) : -1, name);
+    }
     
     plStateDataRecord& operator=(const plStateDataRecord& other) { CopyFrom(other); return *this; }
     void CopyFrom(const plStateDataRecord& other, uint32_t writeOptions=0);
@@ -596,7 +604,19 @@ private:
     plNetApp*   fNetApp;
     uint32_t    fBehaviorFlags;
 
+    // Index of fDescriptors by name, so FindDescriptor doesn't have to walk the list
+    struct DescriptorVersions
+    {
+        plStateDescriptor* fLatest;
+        std::map<int, plStateDescriptor*> fVersions;
+        DescriptorVersions() : fLatest() { }
+    };
+    typedef std::unordered_map<ST::string, DescriptorVersions, ST::hash_i, ST::equal_i> DescriptorIndex;
+    DescriptorIndex fDescriptorIndex;
+
     void IDeleteDescriptors(plSDL::DescriptorList* dl);
+    void IAddDescriptor(plStateDescriptor* sd);
+    void IIndexDescriptor(plStateDescriptor* sd);
 public:
     plSDLMgr();
     ~plSDLMgr();
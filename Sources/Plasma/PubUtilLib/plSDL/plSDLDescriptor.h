@@ -51,6 +51,8 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 #include "plFileSystem.h"
 
 #include <string_theory/string>
+#include <unordered_map>
+#include <vector>
 
 class plKey;
 class plSDVarDescriptor;
@@ -230,9 +232,19 @@ private:
     ST::string fName;
     plFileName fFilename;  // the filename this descriptor was read from
 
+    // Indices for finding vars by name, built the first time someone asks.
+    // The simple and SD indices match the var lists in plStateDataRecord.
+    typedef std::unordered_map<ST::string, int, ST::hash_i, ST::equal_i> VarIndex;
+    mutable VarIndex fVarIndex;
+    mutable VarIndex fSimpleVarIndex;
+    mutable VarIndex fSDVarIndex;
+    mutable bool fVarIndexValid;
+
     void IDeInit();
+    void IBuildVarIndex() const;
+    int IFindVarIndex(const VarIndex& index, const ST::string& name) const;
 public:
-    plStateDescriptor() : fVersion(-1) {}
+    plStateDescriptor() : fVersion(-1), fVarIndexValid() {}
     ~plStateDescriptor(); 
 
     // getters
@@ -245,10 +257,12 @@ public:
     // setters
     void SetVersion(int v) { fVersion=v; }
     void SetName(const ST::string& n) { fName=n; }
-    void AddVar(plVarDescriptor* v) { fVarsList.push_back(v); }
+    void AddVar(plVarDescriptor* v) { fVarsList.push_back(v); fVarIndexValid = false; }
     void SetFilename(const plFileName& n) { fFilename=n;}
 
     plVarDescriptor* FindVar(const ST::string& name, int* idx=nullptr) const;
+    int FindSimpleVarIndex(const ST::string& name) const { return IFindVarIndex(fSimpleVarIndex, name); } // -1 if not found
+    int FindSDVarIndex(const ST::string& name) const { return IFindVarIndex(fSDVarIndex, name); }         // -1 if not found
 
     // IO
     bool Read(hsStream* s); 
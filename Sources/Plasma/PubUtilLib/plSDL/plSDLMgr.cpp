@@ -87,6 +87,29 @@ void plSDLMgr::IDeleteDescriptors(plSDL::DescriptorList* dl)
     for (plStateDescriptor* sd : *dl)
         delete sd;
     dl->clear();
+
+    if (dl == &fDescriptors)
+        fDescriptorIndex.clear();
+}
+
+//
+// add a descriptor to the latest list and index it
+//
+void plSDLMgr::IAddDescriptor(plStateDescriptor* sd)
+{
+    fDescriptors.push_back(sd);
+    IIndexDescriptor(sd);
+}
+
+//
+// If there are duplicates, the first one in the list wins, just like a linear search
+//
+void plSDLMgr::IIndexDescriptor(plStateDescriptor* sd)
+{
+    DescriptorVersions& entry = fDescriptorIndex[sd->GetName()];
+    entry.fVersions.emplace(sd->GetVersion(), sd);
+    if (!entry.fLatest || sd->GetVersion() > entry.fLatest->GetVersion())
+        entry.fLatest = sd;
 }
 
 
@@ -101,16 +124,32 @@ plSDLMgr* plSDLMgr::GetInstance()
 
 //
 // search latest and legacy descriptors for one that matches.
-// if version is -1, search for latest descriptor with matching name
+// if version is -1, search for latest descriptor with matching name.
+// the latest descriptors are looked up through fDescriptorIndex.
 //
 plStateDescriptor* plSDLMgr::FindDescriptor(const ST::string& name, int version, const plSDL::DescriptorList * dl) const
 {
     if (name.empty())
         return nullptr;
 
-    if ( !dl )
-        dl = &fDescriptors;
+    if (!dl || dl == &fDescriptors)
+    {
+        auto it = fDescriptorIndex.find(name);
+        if (it == fDescriptorIndex.end())
+            return nullptr;
 
+        const DescriptorVersions& entry = it->second;
+        if (version == plSDL::kLatestVersion)
+            return entry.fLatest;
+
+        auto verIt = entry.fVersions.find(version);
+        if (verIt != entry.fVersions.end())
+            return verIt->second;
+        else
+            return nullptr;
+    }
+
+    // Someone else's list, do it the slow way
     plStateDescriptor* sd = nullptr;
 
     plSDL::DescriptorList::const_iterator it;
@@ -188,7 +227,11 @@ int plSDLMgr::Read(hsStream* s, plSDL::DescriptorList* dl)
         {
             plStateDescriptor* sd=new plStateDescriptor;
             if (sd->Read(s))
+            {
                 dl->push_back(sd);
+                if (dl == &fDescriptors)
+                    IIndexDescriptor(sd);
+            }
             else
                 delete sd; // well that sucked
         }
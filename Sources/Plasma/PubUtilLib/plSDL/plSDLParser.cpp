@@ -70,8 +70,6 @@ void plSDLParser::DebugMsg(const ST::string& msg) const
 bool plSDLParser::IParseStateDesc(const plFileName& fileName, hsStream* stream, char token[],
                                   plStateDescriptor*& curDesc) const
 {   
-    plSDL::DescriptorList* descList = &plSDLMgr::GetInstance()->fDescriptors;
-
     bool ok = true;
 
     //
@@ -133,7 +131,7 @@ bool plSDLParser::IParseStateDesc(const plFileName& fileName, hsStream* stream,
 
     if ( ok )
     {
-        descList->push_back(curDesc);
+        plSDLMgr::GetInstance()->IAddDescriptor(curDesc);
     }
     else
     {
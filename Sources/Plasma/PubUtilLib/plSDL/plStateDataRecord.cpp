@@ -671,12 +671,15 @@ bool plStateDataRecord::IConvertVar(plSimpleStateVariable* fromVar, plSimpleStat
     return true;    // ok
 }
 
-plStateVariable* plStateDataRecord::IFindVar(const VarsList& vars, const ST::string& name) const
+//
+// idx comes from the descriptor's var index, our var lists are built in the same order
+//
+plStateVariable* plStateDataRecord::IFindVar(const VarsList& vars, int idx, const ST::string& name) const
 {
-    for (int i = 0; i < vars.size(); i++)
+    if (idx >= 0 && idx < vars.size())
     {
-        if (!vars[i]->GetVarDescriptor()->GetName().compare_i(name))
-            return vars[i];
+        hsAssert(!vars[idx]->GetVarDescriptor()->GetName().compare_i(name), "SDL var index mismatch");
+        return vars[idx];
     }
 
     if (plSDLMgr::GetInstance()->GetNetApp())
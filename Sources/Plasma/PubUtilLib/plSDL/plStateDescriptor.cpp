@@ -63,22 +63,54 @@ void plStateDescriptor::IDeInit()
     for(i=0;i<fVarsList.size();i++)
         delete fVarsList[i];
     fVarsList.clear();
+    fVarIndexValid = false;
 }
 
-plVarDescriptor* plStateDescriptor::FindVar(const ST::string& name, int* idx) const
+void plStateDescriptor::IBuildVarIndex() const
 {
-    VarsList::const_iterator it;
-    for(it=fVarsList.begin(); it != fVarsList.end(); it++)
+    fVarIndex.clear();
+    fSimpleVarIndex.clear();
+    fSDVarIndex.clear();
+    fVarIndex.reserve(fVarsList.size());
+
+    // If there are duplicate names, the first var wins, just like a linear search
+    int numSimple = 0, numSD = 0;
+    for (size_t i = 0; i < fVarsList.size(); i++)
     {
-        if (!(*it)->GetName().compare_i(name))
-        {
-            if (idx)
-                *idx = (int)(it-fVarsList.begin());
-            return *it;
-        }
+        const plVarDescriptor* var = fVarsList[i];
+        if (!var)
+            continue;
+
+        fVarIndex.emplace(var->GetName(), (int)i);
+        if (var->GetAsSDVarDescriptor())
+            fSDVarIndex.emplace(var->GetName(), numSD++);
+        else
+            fSimpleVarIndex.emplace(var->GetName(), numSimple++);
     }
+    fVarIndexValid = true;
+}
+
+int plStateDescriptor::IFindVarIndex(const VarIndex& index, const ST::string& name) const
+{
+    if (!fVarIndexValid)
+        IBuildVarIndex();
+
+    auto it = index.find(name);
+    if (it != index.end())
+        return it->second;
+    else
+        return -1;
+}
+
+plVarDescriptor* plStateDescriptor::FindVar(const ST::string& name, int* idx) const
+{
+    int i = IFindVarIndex(fVarIndex, name);
+    if (i < 0)
+        return nullptr;
 
-    return nullptr;
+    if (idx)
+        *idx = i;
+    return fVarsList[i];
 }
 
 
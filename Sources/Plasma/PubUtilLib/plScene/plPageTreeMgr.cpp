@@ -60,7 +60,8 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 #include "plDrawable/plSpaceTree.h"
 #include "plMath/hsRadixSort.h"
 
-static std::vector<hsRadixSortElem> scratchList;
+static std::vector<float> scratchKeys;
+static hsArrayRadixSort<float> floatSort;
 
 bool plPageTreeMgr::fDisableVisMgr = false;
 
@@ -243,30 +244,18 @@ bool plPageTreeMgr::ISortByLevel(plPipeline* pipe, std::vector<plDrawVisList>& d
     if (drawList.empty())
         return false;
 
-    scratchList.resize(drawList.size());
+    static std::vector<uint32_t> levels;
+    static hsArrayRadixSort<uint32_t> levelSort;
 
-    hsRadixSort::Elem* listTrav = nullptr;
+    levels.resize(drawList.size());
     for (size_t i = 0; i < drawList.size(); i++)
-    {
-        listTrav = &scratchList[i];
-        listTrav->fBody = (intptr_t)&drawList[i];
-        listTrav->fNext = listTrav+1;
-        listTrav->fKey.fULong = drawList[i].fDrawable->GetRenderLevel().Level();
-    }
-    listTrav->fNext = nullptr;
+        levels[i] = drawList[i].fDrawable->GetRenderLevel().Level();
 
-    hsRadixSort rad;
-    hsRadixSort::Elem* sortedList = rad.Sort(scratchList.data(), hsRadixSort::kUnsigned);
+    const uint32_t* order = levelSort.Sort(levels);
 
-    listTrav = sortedList;
-
-    while( listTrav )
-    {
-        plDrawVisList& drawVis = *(plDrawVisList*)listTrav->fBody;
-        sortedDrawList.emplace_back(drawVis);
-        
-        listTrav = listTrav->fNext;
-    }
+    sortedDrawList.reserve(drawList.size());
+    for (size_t i = 0; i < drawList.size(); i++)
+        sortedDrawList.emplace_back(drawList[order[i]]);
 
     return true;
 }
@@ -330,41 +319,29 @@ bool plPageTreeMgr::IRenderSortingSpans(plPipeline* pipe, std::vector<plDrawVisL
     plProfile_BeginTiming(DrawObjSort);
     plProfile_IncCount(DrawObjSorted, pairs.size());
 
-    hsRadixSort::Elem* listTrav;
-    scratchList.resize(pairs.size());
+    scratchKeys.resize(pairs.size());
 
     // First, sort on distance to the camera (squared).
-    listTrav = nullptr;
-    int iSort = 0;
-    for (const plDrawSpanPair& pair : pairs)
+    for (size_t i = 0; i < pairs.size(); i++)
     {
+        const plDrawSpanPair& pair = pairs[i];
         plDrawable* drawable = drawList[pair.fDrawable]->fDrawable;
 
-        listTrav = &scratchList[iSort++];
-        listTrav->fBody = (intptr_t)&pair;
-        listTrav->fNext = listTrav + 1;
-
         if( drawable->GetNativeProperty(plDrawable::kPropSortAsOne) )
         {
             const hsBounds3Ext& bnd = drawable->GetSpaceTree()->GetNode(drawable->GetSpaceTree()->GetRoot()).fWorldBounds;
             plConst(float) kDistFudge(1.e-1f);
-            listTrav->fKey.fFloat = -(bnd.GetCenter() - viewPos).MagnitudeSquared() + float(pair.fSpan) * kDistFudge;
+            scratchKeys[i] = -(bnd.GetCenter() - viewPos).MagnitudeSquared() + float(pair.fSpan) * kDistFudge;
         }
         else
         {
             const hsBounds3Ext& bnd = drawable->GetSpaceTree()->GetNode(pair.fSpan).fWorldBounds;
-            listTrav->fKey.fFloat = -(bnd.GetCenter() - viewPos).MagnitudeSquared();
+            scratchKeys[i] = -(bnd.GetCenter() - viewPos).MagnitudeSquared();
         }
     }
-    if( !listTrav )
-    {
-        plProfile_EndTiming(DrawObjSort);
-        return false;
-    }
-    listTrav->fNext = nullptr;
 
-    hsRadixSort rad;
-    hsRadixSort::Elem* sortedList = rad.Sort(scratchList.data(), 0);
+    const uint32_t* order = floatSort.Sort(scratchKeys);
+    const size_t numPairs = pairs.size();
 
     plProfile_EndTiming(DrawObjSort);
 
@@ -386,12 +363,10 @@ bool plPageTreeMgr::IRenderSortingSpans(plPipeline* pipe, std::vector<plDrawVisL
     // face sorting).
     for (plDrawVisList* dvList : drawList)
         dvList->fVisList.clear();
-    listTrav = sortedList;
-    while( listTrav )
+    for (size_t i = 0; i < numPairs; i++)
     {
-        plDrawSpanPair& curPair = *(plDrawSpanPair*)listTrav->fBody;
+        const plDrawSpanPair& curPair = pairs[order[i]];
         drawList[curPair.fDrawable]->fVisList.emplace_back(curPair.fSpan);
-        listTrav = listTrav->fNext;
     }
     for (plDrawVisList* dvList : drawList)
     {
@@ -407,15 +382,12 @@ bool plPageTreeMgr::IRenderSortingSpans(plPipeline* pipe, std::vector<plDrawVisL
     // next drawable. Repeat until done.
 
 #if 0
-    listTrav = sortedList;
-    plDrawSpanPair& curPair = *(plDrawSpanPair*)listTrav->fBody;
-    int curDraw = curPair.fDrawable;
-    visList.emplace_back(curPair.fSpan);
-    listTrav = listTrav->fNext;
+    int curDraw = pairs[order[0]].fDrawable;
+    visList.emplace_back(pairs[order[0]].fSpan);
 
-    while( listTrav )
+    for (size_t i = 1; i < numPairs; i++)
     {
-        curPair = *(plDrawSpanPair*)listTrav->fBody;
+        const plDrawSpanPair& curPair = pairs[order[i]];
         if( curPair.fDrawable != curDraw )
         {
             pipe->Render(drawList[curDraw]->fDrawable, visList);
@@ -427,23 +399,19 @@ bool plPageTreeMgr::IRenderSortingSpans(plPipeline* pipe, std::vector<plDrawVisL
         {
             visList.emplace_back(curPair.fSpan);
         }
-        listTrav = listTrav->fNext;
     }
     pipe->Render(drawList[curDraw]->fDrawable, visList);
 #else
-    listTrav = sortedList;
-    plDrawSpanPair& curPair = *(plDrawSpanPair*)listTrav->fBody;
-    int curDraw = curPair.fDrawable;
-    listTrav = listTrav->fNext;
+    int curDraw = pairs[order[0]].fDrawable;
 
     static std::vector<uint32_t> numDrawn;
     numDrawn.assign(drawList.size(), 0);
 
     visList.emplace_back(drawList[curDraw]->fVisList[numDrawn[curDraw]++]);
 
-    while( listTrav )
+    for (size_t i = 1; i < numPairs; i++)
     {
-        curPair = *(plDrawSpanPair*)listTrav->fBody;
+        const plDrawSpanPair& curPair = pairs[order[i]];
         if( curPair.fDrawable != curDraw )
         {
             pipe->Render(drawList[curDraw]->fDrawable, visList);
@@ -451,7 +419,6 @@ bool plPageTreeMgr::IRenderSortingSpans(plPipeline* pipe, std::vector<plDrawVisL
             visList.clear();
         }
         visList.emplace_back(drawList[curDraw]->fVisList[numDrawn[curDraw]++]);
-        listTrav = listTrav->fNext;
     }
     pipe->Render(drawList[curDraw]->fDrawable, visList);
 #endif
@@ -544,8 +511,9 @@ void plPageTreeMgr::ISortCullPolys(plPipeline* pipe)
 
     hsPoint3 viewPos = pipe->GetViewPositionWorld();
 
-    hsRadixSort::Elem* listTrav;
-    scratchList.resize(fCullPolys.size());
+    static std::vector<const plCullPoly*> submitted;
+    submitted.clear();
+    scratchKeys.clear();
     for (const plCullPoly* poly : fCullPolys)
     {
         bool backFace = poly->fNorm.InnerProduct(viewPos) + poly->fDist <= 0;
@@ -560,21 +528,15 @@ void plPageTreeMgr::ISortCullPolys(plPipeline* pipe)
                 continue;
         }
 
-        listTrav = &scratchList[numSubmit];
-        listTrav->fBody = (intptr_t)poly;
-        listTrav->fNext = listTrav + 1;
-        listTrav->fKey.fFloat = (poly->GetCenter() - viewPos).MagnitudeSquared();
+        submitted.emplace_back(poly);
+        scratchKeys.emplace_back((poly->GetCenter() - viewPos).MagnitudeSquared());
 
         numSubmit++;
     }
     if( !numSubmit )
         return;
 
-    listTrav->fNext = nullptr;
-
-    hsRadixSort rad;
-    hsRadixSort::Elem* sortedList = rad.Sort(scratchList.data(), 0);
-    listTrav = sortedList;
+    const uint32_t* order = floatSort.Sort(scratchKeys);
 
     if( numSubmit > kMaxCullPolys )
         numSubmit = kMaxCullPolys;
@@ -582,10 +544,7 @@ void plPageTreeMgr::ISortCullPolys(plPipeline* pipe)
     fSortedCullPolys.resize(numSubmit);
 
     for (size_t i = 0; i < numSubmit; i++)
-    {
-        fSortedCullPolys[i] = (const plCullPoly*)listTrav->fBody;
-        listTrav = listTrav->fNext;
-    }
+        fSortedCullPolys[i] = submitted[order[i]];
 }
 
 bool plPageTreeMgr::IGetCullPolys(plPipeline* pipe)
@@ -595,8 +554,9 @@ bool plPageTreeMgr::IGetCullPolys(plPipeline* pipe)
 
     plProfile_BeginTiming(DrawOccSort);
 
-    hsRadixSort::Elem* listTrav = nullptr;
-    scratchList.resize(fOccluders.size());
+    static std::vector<const plOccluder*> submitted;
+    submitted.clear();
+    scratchKeys.clear();
 
     hsPoint3 viewPos = pipe->GetViewPositionWorld();
 
@@ -607,25 +567,19 @@ bool plPageTreeMgr::IGetCullPolys(plPipeline* pipe)
         if( pipe->TestVisibleWorld(occluder->GetWorldBounds()) )
         {
             float invDist = -hsFastMath::InvSqrtAppr((viewPos - occluder->GetWorldBounds().GetCenter()).MagnitudeSquared());
-            listTrav = &scratchList[numSubmit++];
-            listTrav->fBody = (intptr_t)occluder;
-            listTrav->fNext = listTrav+1;
-            listTrav->fKey.fFloat = occluder->GetPriority() * invDist;
+            submitted.emplace_back(occluder);
+            scratchKeys.emplace_back(occluder->GetPriority() * invDist);
+            numSubmit++;
         }
     }
-    if( !listTrav )
+    if( !numSubmit )
     {
         plProfile_EndTiming(DrawOccSort);
         return false;
     }
 
-    listTrav->fNext = nullptr;
-
-
     // Sort the occluders by priority
-    hsRadixSort rad;
-    hsRadixSort::Elem* sortedList = rad.Sort(scratchList.data(), 0);
-    listTrav = sortedList;
+    const uint32_t* order = floatSort.Sort(scratchKeys);
 
     constexpr uint32_t kMaxOccluders = 1000;
     if (numSubmit > kMaxOccluders)
@@ -636,10 +590,8 @@ bool plPageTreeMgr::IGetCullPolys(plPipeline* pipe)
     // Take the polys from the first N of them
     for (uint32_t i = 0; i < numSubmit; i++)
     {
-        plOccluder* occ = (plOccluder*)listTrav->fBody;
+        const plOccluder* occ = submitted[order[i]];
         IAddCullPolyList(occ->GetWorldPolyList());
-        
-        listTrav = listTrav->fNext;
     }
 
     plProfile_EndTiming(DrawOccSort);
@@ -52,6 +52,7 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 //  10.24.2002 eap  - Added kDebugOutput flag for writing to debug window   //
 //  10.25.2002 eap  - Updated to work under unix                            //
 //  12.13.2002 eap  - Added kStdout flag                                    //
+//  10.18.2026      - Added kAsyncLog flag and the status log writer thread //
 //                                                                          //
 //////////////////////////////////////////////////////////////////////////////
 
@@ -66,6 +67,297 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 
 #include "plUnifiedTime/plUnifiedTime.h"
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////////
+//// plStatusLogWriter ///////////////////////////////////////////////////////
+//  Owns the files of every kAsyncLog log. Producers push preformatted lines
+//  into a bounded multi-producer/single-consumer ring (one sequence number
+//  per slot, so pushing never takes a lock) and a single thread drains it,
+//  writing and flushing each file once per batch. When the ring is out of
+//  slots or bytes, the line is dropped and counted instead of blocking the
+//  caller.
+
+class plStatusLogWriter
+{
+    struct Slot
+    {
+        std::atomic<size_t> fSequence;
+        plStatusLog*        fLog;
+        ST::string          fLine;
+        bool                fReopen;
+    };
+
+    static constexpr size_t kNumSlots = 8192;                   // Must be a power of two
+    static constexpr size_t kMaxQueuedBytes = 4 * 1024 * 1024;
+    static constexpr size_t kMaxBatch = 512;
+    static constexpr std::chrono::milliseconds kIdleWait{ 10 };
+
+    std::unique_ptr<Slot[]> fSlots;
+    alignas(64) std::atomic<size_t> fEnqueuePos;
+    alignas(64) size_t              fDequeuePos;            // Writer thread only
+    std::atomic<size_t>             fWrittenPos;
+    std::atomic<size_t>             fQueuedBytes;
+    std::atomic<uint32_t>           fDropped;
+    std::atomic<bool>               fIdle;
+    std::atomic<bool>               fRunning;
+    std::atomic<uint32_t>           fPushers;               // Producers in the middle of Push()
+    bool                            fQuit;
+    bool                            fExited;
+
+    std::thread                 fThread;
+    std::mutex                  fMutex;
+    std::condition_variable     fWake;
+    std::condition_variable     fDrained;
+
+    std::vector<plStatusLog*>   fTouched;                   // Writer thread only
+
+    bool IHasPending() const
+    {
+        const Slot& slot = fSlots[fDequeuePos & (kNumSlots - 1)];
+        return slot.fSequence.load(std::memory_order_acquire) == fDequeuePos + 1;
+    }
+
+    size_t IWriteBatch();
+    void   IRun();
+    bool   IPush(plStatusLog* log, ST::string&& line, bool reopen);
+
+public:
+    enum PushResult
+    {
+        kQueued,
+        kDropped,   // Out of room; counted against the log
+        kStopped,   // The writer is gone (or going), so the line is still the caller's
+    };
+
+    plStatusLogWriter();
+    ~plStatusLogWriter() { Stop(); }
+
+    void Start();
+    void Stop();
+    bool IsRunning() const { return fRunning.load(std::memory_order_acquire); }
+
+    // Only takes the line if it's queued. Once Stop() has begun (or if the
+    // writer never started), every push comes back kStopped, and everything
+    // that was queued before then is written before the writer exits.
+    PushResult Push(plStatusLog* log, ST::string&& line, bool reopen = false);
+    void Flush();
+    // Waits for the writer thread to finish up, so the caller can have the
+    // files back after a kStopped.
+    void WaitForExit();
+
+    uint32_t GetNumDropped() const { return fDropped.load(std::memory_order_relaxed); }
+};
+
+plStatusLogWriter::plStatusLogWriter()
+    : fSlots(new Slot[kNumSlots]), fEnqueuePos(), fDequeuePos(), fWrittenPos(),
+      fQueuedBytes(), fDropped(), fIdle(), fRunning(), fPushers(), fQuit(), fExited(true)
+{
+    for (size_t i = 0; i < kNumSlots; i++)
+    {
+        fSlots[i].fSequence.store(i, std::memory_order_relaxed);
+        fSlots[i].fLog = nullptr;
+        fSlots[i].fReopen = false;
+    }
+}
+
+void plStatusLogWriter::Start()
+{
+    std::lock_guard<std::mutex> lock(fMutex);
+    if (fThread.joinable())
+        return;
+
+    fQuit = false;
+    fExited = false;
+    fRunning.store(true, std::memory_order_release);
+    fThread = hsThread::StartSimpleThread([this] {
+        hsThread::SetThisThreadName(ST_LITERAL("plStatusLogWr"));
+        IRun();
+    });
+}
+
+void plStatusLogWriter::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(fMutex);
+        if (!fThread.joinable())
+            return;
+
+        // Before the final drain, so nothing can be queued after it. Anybody
+        // logging from here on gets kStopped and writes synchronously.
+        fRunning.store(false);
+        fQuit = true;
+    }
+    fWake.notify_one();
+    fThread.join();
+}
+
+plStatusLogWriter::PushResult plStatusLogWriter::Push(plStatusLog* log, ST::string&& line, bool reopen)
+{
+    // Paired with Stop(): either we see it has begun, or the writer sees us
+    // and waits for our line before it quits.
+    fPushers.fetch_add(1);
+    PushResult result = kStopped;
+    if (fRunning.load())
+        result = IPush(log, std::move(line), reopen) ? kQueued : kDropped;
+    fPushers.fetch_sub(1);
+    return result;
+}
+
+void plStatusLogWriter::WaitForExit()
+{
+    std::unique_lock<std::mutex> lock(fMutex);
+    fDrained.wait(lock, [this] { return fExited; });
+}
+
+bool plStatusLogWriter::IPush(plStatusLog* log, ST::string&& line, bool reopen)
+{
+    size_t bytes = line.size();
+    if (fQueuedBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes > kMaxQueuedBytes && !reopen)
+    {
+        fQueuedBytes.fetch_sub(bytes, std::memory_order_relaxed);
+        fDropped.fetch_add(1, std::memory_order_relaxed);
+        log->fDroppedLines.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    Slot* slot;
+    size_t pos = fEnqueuePos.load(std::memory_order_relaxed);
+    for (;;)
+    {
+        slot = &fSlots[pos & (kNumSlots - 1)];
+        size_t seq = slot->fSequence.load(std::memory_order_acquire);
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+        if (diff == 0)
+        {
+            if (fEnqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+        {
+            // Full -- the writer hasn't released this slot from the last lap yet
+            fQueuedBytes.fetch_sub(bytes, std::memory_order_relaxed);
+            if (!reopen)
+            {
+                fDropped.fetch_add(1, std::memory_order_relaxed);
+                log->fDroppedLines.fetch_add(1, std::memory_order_relaxed);
+            }
+            return false;
+        }
+        else
+            pos = fEnqueuePos.load(std::memory_order_relaxed);
+    }
+
+    slot->fLog = log;
+    slot->fLine = std::move(line);
+    slot->fReopen = reopen;
+    slot->fSequence.store(pos + 1, std::memory_order_release);
+
+    // No lock here; if we lose the race with the writer going to sleep,
+    // it'll pick the line up when its wait times out.
+    if (fIdle.load(std::memory_order_acquire))
+        fWake.notify_one();
+
+    return true;
+}
+
+void plStatusLogWriter::Flush()
+{
+    if (!IsRunning())
+    {
+        // Stopping drains everything anyway
+        WaitForExit();
+        return;
+    }
+
+    size_t target = fEnqueuePos.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(fMutex);
+    fWake.notify_one();
+    fDrained.wait(lock, [this, target] {
+        return fWrittenPos.load(std::memory_order_acquire) >= target || fExited;
+    });
+}
+
+size_t plStatusLogWriter::IWriteBatch()
+{
+    size_t count = 0;
+    while (count < kMaxBatch && IHasPending())
+    {
+        Slot& slot = fSlots[fDequeuePos & (kNumSlots - 1)];
+        plStatusLog* log = slot.fLog;
+        ST::string line = std::move(slot.fLine);
+        bool reopen = slot.fReopen;
+        slot.fSequence.store(fDequeuePos + kNumSlots, std::memory_order_release);
+        fDequeuePos++;
+        fQueuedBytes.fetch_sub(line.size(), std::memory_order_relaxed);
+        count++;
+
+        if (reopen)
+        {
+            // Bounce() -- the next line rotates the files and starts over
+            log->ICloseFile();
+            continue;
+        }
+
+        uint32_t dropped = log->fDroppedLines.exchange(0, std::memory_order_relaxed);
+        if (dropped)
+            log->IWriteToFile(ST::format("--------- {} lines dropped ---------\n", dropped));
+
+        if (log->IWriteToFile(line) && std::find(fTouched.begin(), fTouched.end(), log) == fTouched.end())
+            fTouched.push_back(log);
+    }
+
+    // One flush per file per batch, rather than one per line
+    for (plStatusLog* log : fTouched)
+    {
+        if (!(log->fFlags & plStatusLog::kNonFlushedLog))
+            fflush(log->fFileHandle);
+
+        // Only the overgrown log rotates here; the synchronous path bounces
+        // every log, but the others belong to their own threads. A log that
+        // doesn't rotate would only reopen the same file and append to it
+        // again, so leave it be.
+        if (log->fSize >= plStatusLog::kMaxFileSize && !(log->fFlags & plStatusLog::kDontRotateLogs))
+            log->ICloseFile();
+    }
+    fTouched.clear();
+
+    if (count)
+    {
+        fWrittenPos.store(fDequeuePos, std::memory_order_release);
+        std::lock_guard<std::mutex> lock(fMutex);
+        fDrained.notify_all();
+    }
+    return count;
+}
+
+void plStatusLogWriter::IRun()
+{
+    for (;;)
+    {
+        if (IWriteBatch())
+            continue;
+
+        std::unique_lock<std::mutex> lock(fMutex);
+        if (fQuit && fPushers.load() == 0 && !IHasPending())
+            break;
+
+        fIdle.store(true, std::memory_order_release);
+        fWake.wait_for(lock, kIdleWait, [this] { return fQuit || IHasPending(); });
+        fIdle.store(false, std::memory_order_relaxed);
+    }
+
+    std::lock_guard<std::mutex> lock(fMutex);
+    fExited = true;
+    fDrained.notify_all();
+}
+
 //////////////////////////////////////////////////////////////////////////////
 //// plStatusLogMgr Stuff ////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////
@@ -81,10 +373,16 @@ plFileName plStatusLogMgr::IGetBasePath()
 plStatusLogMgr::plStatusLogMgr()
     : fDisplays(), fCurrDisplay(), fDrawer(), fLastLogChangeTime()
 {
+    fWriter = std::make_shared<plStatusLogWriter>();
 }
 
 plStatusLogMgr::~plStatusLogMgr()
 {
+    // Drain the async logs before anybody's file goes away. Async logs that
+    // outlive us keep the (stopped) writer alive, and go back to writing
+    // their files themselves.
+    fWriter->Stop();
+
     // Unlink all the displays, but don't delete them; leave that to whomever owns them
     while (fDisplays != nullptr)
     {
@@ -125,6 +423,12 @@ plStatusLog *plStatusLogMgr::CreateStatusLog( uint8_t numDisplayLines, const plF
     plFileSystem::CreateDir(IGetBasePath(), true);
     plStatusLog *log = new plStatusLog( numDisplayLines, filename, flags );
 
+    if (flags & plStatusLog::kAsyncLog)
+    {
+        log->fWriter = fWriter;
+        fWriter->Start();
+    }
+
     // Put the new log in its alphabetical position
     plStatusLog** nextLog = &fDisplays;
     while (*nextLog)
@@ -231,6 +535,18 @@ void plStatusLogMgr::BounceLogs()
     }
 }
 
+//// FlushAsyncLogs //////////////////////////////////////////////////////////
+
+void plStatusLogMgr::FlushAsyncLogs()
+{
+    fWriter->Flush();
+}
+
+uint32_t plStatusLogMgr::GetNumDroppedLines() const
+{
+    return fWriter->GetNumDropped();
+}
+
 //// DumpLogs ////////////////////////////////////////////////////////////////
 
 bool plStatusLogMgr::DumpLogs( const plFileName &newFolderName )
@@ -260,7 +576,7 @@ bool plStatusLogMgr::DumpLogs( const plFileName &newFolderName )
 uint32_t plStatusLog::fLoggingOff = false;
 
 plStatusLog::plStatusLog( uint8_t numDisplayLines, const plFileName &filename, uint32_t flags )
-    : fFileHandle(), fSize(), fForceLog(), fMaxNumLines(numDisplayLines),
+    : fFileHandle(), fSize(), fForceLog(), fDroppedLines(), fMaxNumLines(numDisplayLines),
       fDisplayPointer()
 {
     if (filename.IsValid())
@@ -352,11 +668,13 @@ void    plStatusLog::IFini()
 {
     int     i;
 
-    if (fFileHandle != nullptr)
-    {
-        fclose( fFileHandle );
-        fFileHandle = nullptr;
-    }
+    // Make sure the writer is done with us before we pull the file out from
+    // under it. This is our own reference, so it's still good even if the
+    // manager is already gone.
+    if (fWriter)
+        fWriter->Flush();
+
+    ICloseFile();
 
     if( *fDisplayPointer == this )
         *fDisplayPointer = nullptr;
@@ -426,11 +744,10 @@ bool plStatusLog::IAddLine(const ST::string& line, uint32_t color)
         return true;
 
     /// Scroll pointers up
-    hsFILELock fileLock(fFileHandle);
-    hsLockGuard(fileLock);
-
     if (fMaxNumLines > 0)
     {
+        hsLockGuard(fLineMutex);
+
         for( i = 0; i < fMaxNumLines - 1; i++ )
         {
             fLines[ i ] = std::move(fLines[ i + 1 ]);
@@ -482,6 +799,7 @@ void    plStatusLog::Clear()
 {
     int     i;
 
+    hsLockGuard(fLineMutex);
 
     for( i = 0; i < fMaxNumLines; i++ )
     {
@@ -497,80 +815,138 @@ void    plStatusLog::Bounce( uint32_t flags)
     if (flags)
         fOrigFlags=flags;
     Clear();
+
+    plStatusLogWriter* writer = fWriter.get();
+    plStatusLogWriter::PushResult pushed = plStatusLogWriter::kStopped;
+    if (writer)
+    {
+        // The close has to happen in order with the lines already queued,
+        // so hand it to the writer. Keep trying if it's backed up; this
+        // is not something we can drop.
+        while ((pushed = writer->Push(this, {}, true)) == plStatusLogWriter::kDropped)
+            std::this_thread::yield();
+
+        // It's stopped (or stopping); once it's written what it had, the
+        // file is ours again
+        if (pushed == plStatusLogWriter::kStopped)
+            writer->WaitForExit();
+    }
+
+    if (pushed == plStatusLogWriter::kStopped)
+        ICloseFile();
+
+    AddLine( "--------- Bounced Log ---------" );
+}
+
+//// ICloseFile //////////////////////////////////////////////////////////////
+
+void plStatusLog::ICloseFile()
+{
     if (fFileHandle != nullptr)
     {
         fclose( fFileHandle );
         fFileHandle = nullptr;
     }
-    AddLine( "--------- Bounced Log ---------" );
 }
 
-//// IPrintLineToFile ////////////////////////////////////////////////////////
+//// IFormatLine /////////////////////////////////////////////////////////////
+//  Builds the line as it will appear in the log file. Always runs on the
+//  thread that logged it, so the timestamps and thread ID are the caller's.
 
-bool plStatusLog::IPrintLineToFile(const ST::string& line)
+ST::string plStatusLog::IFormatLine(const ST::string& line) const
 {
-    if( fFlags & kDontWriteFile )
-        return true;
+    ST::string_stream buf;
 
+    if (!line.empty())
+    {
+        if ( fFlags & kTimestamp )
+        {
+            buf << '(' << plUnifiedTime::GetCurrent(plUnifiedTime::kLocal).Format("%m/%d %H:%M:%S") << ") ";
+        }
+        if ( fFlags & kTimestampGMT )
+        {
+            buf << '(' << plUnifiedTime::GetCurrent().Format("%m/%d %H:%M:%S UTC") << ") ";
+        }
+        if ( fFlags & kTimeInSeconds )
+        {
+            buf << '(' << plUnifiedTime::GetCurrent(plUnifiedTime::kLocal).GetSecs() << ") ";
+        }
+        if ( fFlags & kTimeAsDouble )
+        {
+            buf << '(' << plUnifiedTime::GetCurrent(plUnifiedTime::kLocal).GetSecsDouble() << ") ";
+        }
+        if (fFlags & kRawTimeStamp)
+        {
+            buf << ST::format("[t={10f}] ", hsTimer::GetSeconds());
+        }
+        if (fFlags & kThreadID)
+        {
+            buf << "[t=" << hsThread::ThisThreadHash() << "] ";
+        }
+
+        buf << line << '\n';
+    }
+
+    return buf.to_string();
+}
+
+//// IWriteToFile ////////////////////////////////////////////////////////////
+//  Writes an already formatted line, (re)opening the file if needed. Doesn't
+//  flush or rotate; that's up to the caller.
+
+bool plStatusLog::IWriteToFile(const ST::string& formatted)
+{
     if (!fFileHandle)
         IReOpen();
 
-    bool ret = (fFileHandle != nullptr);
+    if (fFileHandle == nullptr)
+        return false;
 
-    if (fFileHandle != nullptr)
-    {
-        ST::string_stream buf;
+    size_t written = fwrite(formatted.c_str(), 1, formatted.size(), fFileHandle);
+    if (ferror(fFileHandle) != 0)
+        return false;
 
-        //build line to write to log file
+    fSize += written;
+    return true;
+}
 
-        if (!line.empty())
-        {
-            if ( fFlags & kTimestamp )
-            {
-                buf << '(' << plUnifiedTime::GetCurrent(plUnifiedTime::kLocal).Format("%m/%d %H:%M:%S") << ") ";
-            }
-            if ( fFlags & kTimestampGMT )
-            {
-                buf << '(' << plUnifiedTime::GetCurrent().Format("%m/%d %H:%M:%S UTC") << ") ";
-            }
-            if ( fFlags & kTimeInSeconds )
-            {
-                buf << '(' << plUnifiedTime::GetCurrent(plUnifiedTime::kLocal).GetSecs() << ") ";
-            }
-            if ( fFlags & kTimeAsDouble )
-            {
-                buf << '(' << plUnifiedTime::GetCurrent(plUnifiedTime::kLocal).GetSecsDouble() << ") ";
-            }
-            if (fFlags & kRawTimeStamp)
-            {
-                buf << ST::format("[t={10f}] ", hsTimer::GetSeconds());
-            }
-            if (fFlags & kThreadID)
-            {
-                buf << "[t=" << hsThread::ThisThreadHash() << "] ";
-            }
+//// IPrintLineToFile ////////////////////////////////////////////////////////
 
-            buf << line << '\n';
-        }
+bool plStatusLog::IPrintLineToFile(const ST::string& line)
+{
+    if( fFlags & kDontWriteFile )
+        return true;
 
-        {
-            int err;
-            err = fwrite(buf.raw_buffer(), 1, buf.size(), fFileHandle);
-            ret = ( ferror( fFileHandle )==0 );
+    bool ret;
 
-            if ( ret )
-            {
-                fSize += err;
-                if (!(fFlags & kNonFlushedLog))
-                    fflush(fFileHandle);
-            }
-        }
+    ST::string formatted = IFormatLine(line);
+    plStatusLogWriter* writer = fWriter.get();
+    plStatusLogWriter::PushResult pushed = plStatusLogWriter::kStopped;
+    if (writer)
+    {
+        pushed = writer->Push(this, std::move(formatted));
+        ret = (pushed == plStatusLogWriter::kQueued);
+
+        // It's stopped (or stopping); wait until the file is ours again and
+        // write it here instead
+        if (pushed == plStatusLogWriter::kStopped)
+            writer->WaitForExit();
+    }
+
+    if (pushed == plStatusLogWriter::kStopped)
+    {
+        // Only once we know the file isn't the writer thread's
+        hsFILELock fileLock(fFileHandle);
+        hsLockGuard(fileLock);
+
+        ret = IWriteToFile(formatted);
+        if (ret && !(fFlags & kNonFlushedLog))
+            fflush(fFileHandle);
 
         if ( fSize>=kMaxFileSize )
         {
             plStatusLogMgr::GetInstance().BounceLogs();
         }
-
     }
 
     if (fFlags & kDebugOutput)
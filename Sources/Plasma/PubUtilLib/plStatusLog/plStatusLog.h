@@ -60,6 +60,9 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 #include "plFileSystem.h"
 #include "plLoggable.h"
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <string_theory/format>
 
 class plPipeline;
@@ -70,12 +73,14 @@ class plPipeline;
 
 class plStatusLogMgr;
 class plStatusLogDrawerStub;
+class plStatusLogWriter;
 
 class plStatusLog : public plLog
 {
     friend class plStatusLogMgr;
     friend class plStatusLogDrawerStub;
     friend class plStatusLogDrawer;
+    friend class plStatusLogWriter;
     
     protected:
 
@@ -91,6 +96,11 @@ class plStatusLog : public plLog
         uint32_t     fSize;
         bool         fForceLog;
 
+        std::atomic<uint32_t> fDroppedLines;    // kAsyncLog lines the writer hasn't reported yet
+        std::shared_ptr<plStatusLogWriter> fWriter; // kAsyncLog only; outlives the manager if need be
+
+        std::mutex   fLineMutex;                // Guards fLines and fColors
+
         plStatusLog *fNext, **fBack;
 
         plStatusLog **fDisplayPointer;      // Inside pfConsole
@@ -100,6 +110,9 @@ class plStatusLog : public plLog
 
         bool    IAddLine(const ST::string& line, uint32_t color);
         bool    IPrintLineToFile(const ST::string& line);
+        ST::string IFormatLine(const ST::string& line) const;
+        bool    IWriteToFile(const ST::string& formatted);
+        void    ICloseFile();
         void    IParseFileName(plFileName &fileNoExt, ST::string &ext) const;
         static plStatusLog* IFindLog(const plFileName& filename);
 
@@ -140,6 +153,10 @@ class plStatusLog : public plLog
             kThreadID           = 0x00002000,   // ID of current thread
             kTimestampGMT       = 0x00004000,   // Write a timestamp in GMT with each entry.
             kNonFlushedLog      = 0x00008000,   // Do not flush the log after each write
+            kAsyncLog           = 0x00010000,   // Format on the caller's thread, but leave the file
+                                                // writes (and rotation) to the status log writer
+                                                // thread. Lines are dropped if the writer falls too
+                                                // far behind.
         };
 
         enum
@@ -253,6 +270,7 @@ class plStatusLogMgr
         plStatusLog     *fCurrDisplay;
 
         plStatusLogDrawerStub   *fDrawer;
+        std::shared_ptr<plStatusLogWriter> fWriter;
 
         double fLastLogChangeTime;
 
@@ -282,6 +300,12 @@ class plStatusLogMgr
 
         void        BounceLogs();
 
+        // Block until every line queued to a kAsyncLog log so far has hit the disk
+        void        FlushAsyncLogs();
+
+        // Number of kAsyncLog lines thrown away because the writer's queue was full
+        uint32_t    GetNumDroppedLines() const;
+
         // Create a new folder and copy all log files into it (returns false on failure)
         bool        DumpLogs( const plFileName &newFolderName );
 };
@@ -45,12 +45,18 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 #include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <deque>
 #include <string_theory/string_stream>
 #include <thread>
 #include <unordered_map>
+#include <utility>
 
 #include "hsTimer.h"
+#include "plFileSystem.h"
 #include "plgDispatch.h"
+#include "plProfile.h"
+
+#include "pnNetBase/pnNbSrvs.h"
 
 #include "plMessage/plVaultNotifyMsg.h"
 #include "plNetClientComm/plNetClientComm.h"
@@ -63,6 +69,7 @@ You can contact Cyan Worlds, Inc. by email legal@cyan.com
 #include "plStatusLog/plStatusLog.h"
 
 #include "plVaultNodeAccess.h"
+#include "plVaultNodeCache.h"
 
 /*****************************************************************************
 *
@@ -108,16 +115,19 @@ struct VaultDownloadTrans {
     unsigned    nodesLeft;
     unsigned    vaultId;
     ENetError   result;
+    uint32_t    startMs;
 
     VaultDownloadTrans ()
         : callback(), progressCallback(),
-          nodeCount(), nodesLeft(), vaultId(), result(kNetSuccess)
+          nodeCount(), nodesLeft(), vaultId(), result(kNetSuccess),
+          startMs(hsTimer::GetMilliSeconds<uint32_t>())
     { }
 
     VaultDownloadTrans (const ST::string& _tag, FVaultDownloadCallback _callback,
                         FVaultProgressCallback _progressCallback, unsigned _vaultId)
         : callback(std::move(_callback)), progressCallback(std::move(_progressCallback)),
-          nodeCount(), nodesLeft(), vaultId(_vaultId), result(kNetSuccess), tag(_tag)
+          nodeCount(), nodesLeft(), vaultId(_vaultId), result(kNetSuccess), tag(_tag),
+          startMs(hsTimer::GetMilliSeconds<uint32_t>())
     { }
 
     virtual ~VaultDownloadTrans() = default;
@@ -196,6 +206,44 @@ static std::unordered_map<ST::string, ST::string, ST::hash> s_ageDeviceInboxes;
 
 static std::atomic<int> s_suppressCallbacks;
 
+// Nodes from previous sessions; see FetchCachedNode
+static plVaultNodeCache s_nodeCache;
+static bool s_nodeCacheLoaded;
+static unsigned s_nodeCacheHits;
+static unsigned s_nodeCacheMisses;
+static unsigned s_nodeCacheStale;
+
+// Cached copies we've handed out but not yet checked with the server
+static std::deque<std::pair<unsigned, uint32_t>> s_validateQueue;
+static unsigned s_validatesInFlight;
+
+// Checks only catch changes made while we were away, so they get a much
+// smaller window than real fetches
+static const unsigned kMaxValidatesInFlight = 8;
+
+// Forget about nodes we haven't seen in a month
+static const uint32_t kNodeCacheMaxAgeSecs = 30 * 24 * 60 * 60;
+
+// Pending node fetches; see QueueNodeFetch
+struct VaultFetchRequest {
+    std::vector<FNetCliAuthVaultNodeFetched> callbacks;
+};
+static std::unordered_map<unsigned, VaultFetchRequest> s_fetchRequests;
+static std::deque<unsigned> s_fetchQueue;
+static unsigned s_fetchesInFlight;
+static bool s_pumpingFetches;
+
+// Bumped by VaultDestroy, so replies to requests from before it are ignored
+static unsigned s_fetchGeneration;
+
+// Enough to keep the pipe to the auth server full without burying it
+static const unsigned kMaxFetchesInFlight = 64;
+
+plProfile_CreateCounter("Fetches Sent", "Vault", VaultFetchesSent);
+plProfile_CreateCounter("Fetches Coalesced", "Vault", VaultFetchesCoalesced);
+plProfile_CreateCounterNoReset("Fetches Queued", "Vault", VaultFetchesQueued);
+plProfile_CreateCounterNoReset("Fetches In Flight", "Vault", VaultFetchesInFlight);
+
 /*****************************************************************************
 *
 *   Local functions
@@ -214,6 +262,10 @@ static void VaultNodeFound (
     unsigned            nodeIdCount,
     const unsigned      nodeIds[]
 );
+static void ChangedVaultNodeFetched (
+    ENetError           result,
+    NetVaultNode *      node
+);
 
 //============================================================================
 static void VaultNodeAddedDownloadCallback(ENetError result, unsigned childId)
@@ -351,6 +403,202 @@ static void FetchRefOwners (
 }
 
 //============================================================================
+static plFileName GetNodeCachePath () {
+    // Node ids are only unique per shard, so each shard gets its own cache
+    const ST::string* addrs;
+    ST::string shard = "default";
+    if (GetAuthSrvHostnames(addrs) && !addrs[0].empty())
+        shard = addrs[0].replace(":", "_");
+    return plFileName::Join(plFileSystem::GetUserDataPath(), "VaultCache", shard + ".dat");
+}
+
+//============================================================================
+static void LoadNodeCache () {
+    if (s_nodeCacheLoaded)
+        return;
+    s_nodeCacheLoaded = true;
+
+    if (s_nodeCache.Load(GetNodeCachePath()))
+        s_log->AddLineF("Loaded {} nodes from the local node cache", s_nodeCache.GetCount());
+}
+
+//============================================================================
+static void SaveNodeCache () {
+    if (!s_nodeCacheLoaded)
+        return;
+
+    if (s_nodeCache.IsDirty())
+        s_nodeCache.Save(GetNodeCachePath(), kNodeCacheMaxAgeSecs);
+    s_log->AddLineF("Node cache: {} hits, {} misses, {} stale", s_nodeCacheHits, s_nodeCacheMisses, s_nodeCacheStale);
+
+    // The next login may well be to another shard
+    s_nodeCache.Clear();
+    s_nodeCacheLoaded = false;
+    s_nodeCacheHits = 0;
+    s_nodeCacheMisses = 0;
+    s_nodeCacheStale = 0;
+}
+
+//============================================================================
+// Hands out our local copy of a node, if we have one. The copy is trusted
+// until the server says otherwise: either through a change notification, or
+// when the check queued here finds a different modify time.
+static bool FetchCachedNode (
+    unsigned                nodeId,
+    hsRef<NetVaultNode> *   node
+) {
+    LoadNodeCache();
+
+    uint32_t modifyTime = s_nodeCache.GetModifyTime(nodeId);
+    if (!modifyTime)
+        return false;
+
+    hsRef<NetVaultNode> cached(new NetVaultNode(), hsStealRef);
+    if (!s_nodeCache.Get(nodeId, cached.Get()))
+        return false;
+
+    s_validateQueue.emplace_back(nodeId, modifyTime);
+    *node = std::move(cached);
+    return true;
+}
+
+//============================================================================
+static void PumpNodeFetches ();
+
+//============================================================================
+// Asks the server whether a node we handed out from the cache has changed
+// since. The find reply is just a node id, which is a lot less traffic than
+// the text notes and images that make up the bulk of an old vault.
+static void ValidateCachedNode (
+    unsigned    nodeId,
+    uint32_t    modifyTime
+) {
+    NetVaultNode templateNode;
+    templateNode.SetNodeId(nodeId);
+    templateNode.SetModifyTime(modifyTime);
+
+    ++s_validatesInFlight;
+    NetCliAuthVaultNodeFind(
+        &templateNode,
+        [nodeId, generation = s_fetchGeneration](auto result, auto nodeIdCount, auto nodeIds) {
+            // The vault was torn down while this was out
+            if (generation != s_fetchGeneration)
+                return;
+            --s_validatesInFlight;
+
+            if (IS_NET_SUCCESS(result) && !(nodeIdCount == 1 && nodeIds[0] == nodeId)) {
+                // Changed (or gone) since we cached it; pick up the real
+                // thing the same way as when we're told about a change.
+                s_nodeCache.Remove(nodeId);
+                ++s_nodeCacheStale;
+                if (s_nodes.find(nodeId) != s_nodes.end())
+                    NetCliAuthVaultNodeFetch(nodeId, ChangedVaultNodeFetched);
+            }
+
+            PumpNodeFetches();
+        }
+    );
+}
+
+//============================================================================
+static void DeliverFetchedNode (
+    unsigned            nodeId,
+    ENetError           result,
+    NetVaultNode *      node
+) {
+    // Pull the callbacks out first; they are free to queue more fetches
+    std::vector<FNetCliAuthVaultNodeFetched> callbacks;
+    auto it = s_fetchRequests.find(nodeId);
+    if (it != s_fetchRequests.end()) {
+        callbacks = std::move(it->second.callbacks);
+        s_fetchRequests.erase(it);
+    }
+
+    for (const auto& callback : callbacks)
+        callback(result, node);
+}
+
+//============================================================================
+static void NodeFetchComplete (
+    unsigned            nodeId,
+    ENetError           result,
+    NetVaultNode *      node
+) {
+    --s_fetchesInFlight;
+    plProfile_Set(VaultFetchesInFlight, s_fetchesInFlight);
+
+    DeliverFetchedNode(nodeId, result, node);
+    PumpNodeFetches();
+}
+
+//============================================================================
+static void PumpNodeFetches () {
+    // Cached nodes are delivered from in here, and their callbacks may well
+    // queue more fetches. The loop below picks those up, so don't recurse.
+    if (s_pumpingFetches)
+        return;
+    s_pumpingFetches = true;
+
+    while (s_fetchesInFlight < kMaxFetchesInFlight && !s_fetchQueue.empty()) {
+        unsigned nodeId = s_fetchQueue.front();
+        s_fetchQueue.pop_front();
+
+        hsRef<NetVaultNode> node;
+        if (FetchCachedNode(nodeId, &node)) {
+            ++s_nodeCacheHits;
+            DeliverFetchedNode(nodeId, kNetSuccess, node.Get());
+            continue;
+        }
+
+        ++s_nodeCacheMisses;
+        ++s_fetchesInFlight;
+        plProfile_Inc(VaultFetchesSent);
+        NetCliAuthVaultNodeFetch(nodeId, [nodeId, generation = s_fetchGeneration](auto result, auto node) {
+            // The vault was torn down while this was out
+            if (generation == s_fetchGeneration)
+                NodeFetchComplete(nodeId, result, node);
+        });
+    }
+
+    // Checking cached copies only matters for changes made while we were
+    // away, so it waits until the real fetches are out of the way
+    while (s_fetchQueue.empty() && s_validatesInFlight < kMaxValidatesInFlight && !s_validateQueue.empty()) {
+        auto [nodeId, modifyTime] = s_validateQueue.front();
+        s_validateQueue.pop_front();
+        ValidateCachedNode(nodeId, modifyTime);
+    }
+
+    s_pumpingFetches = false;
+
+    plProfile_Set(VaultFetchesQueued, (uint32_t)s_fetchQueue.size());
+    plProfile_Set(VaultFetchesInFlight, s_fetchesInFlight);
+}
+
+//============================================================================
+// Queues a node fetch. Requests for a node that is already on its way are
+// folded into the outstanding one, and no more than kMaxFetchesInFlight are
+// sent at once; the rest go out as earlier ones complete.
+// Nothing is sent from in here: the caller pumps the queue once it's ready
+// for the callbacks, which come straight out of PumpNodeFetches() for nodes
+// we have cached.
+static void QueueNodeFetch (
+    unsigned                    nodeId,
+    FNetCliAuthVaultNodeFetched fetchCallback
+) {
+    auto [it, inserted] = s_fetchRequests.try_emplace(nodeId);
+    it->second.callbacks.emplace_back(std::move(fetchCallback));
+    if (!inserted) {
+        plProfile_Inc(VaultFetchesCoalesced);
+        return;
+    }
+
+    s_fetchQueue.push_back(nodeId);
+    plProfile_Set(VaultFetchesQueued, (uint32_t)s_fetchQueue.size());
+}
+
+//============================================================================
+// Queues fetches for the nodes we don't have yet; see QueueNodeFetch. The
+// caller pumps them once it has counted *fetchCount toward its callbacks.
 static void FetchNodesFromRefs (
     NetVaultNodeRef *           refs,
     unsigned                    refCount,
@@ -385,7 +633,7 @@ static void FetchNodesFromRefs (
             continue;
         }
         prevId = node->GetNodeId();
-        NetCliAuthVaultNodeFetch(nodeId, fetchCallback);
+        QueueNodeFetch(nodeId, fetchCallback);
         ++(*fetchCount);
     }
 }
@@ -406,12 +654,13 @@ static void VaultNodeFound (
         
         // See if we already have this node
         if (s_nodes.find(nodeIds[i]) != s_nodes.end()) {
-            return;
+            continue;
         }
 
-        // Start fetching the node          
-        NetCliAuthVaultNodeFetch(nodeIds[i], VaultNodeFetched);
+        // Start fetching the node
+        QueueNodeFetch(nodeIds[i], VaultNodeFetched);
     }
+    PumpNodeFetches();
 }
 
 //============================================================================
@@ -435,6 +684,8 @@ static void VaultNodeFetched (
     globalNode->CopyFrom(node);
     InitFetchedNode(globalNode);
 
+    s_nodeCache.Store(node);
+
     globalNode->Print("Fetched", 0);
 }
 
@@ -492,6 +743,8 @@ static void VaultNodeChanged (
         }
     } else {
         // We have the node and we weren't the one that changed it, so fetch it.
+        // Our cached copy is stale now; the fetch will cache the new one.
+        s_nodeCache.Remove(nodeId);
         NetCliAuthVaultNodeFetch(nodeId, ChangedVaultNodeFetched);
     }
 }
@@ -598,6 +851,7 @@ static void VaultNodeDeleted (
     unsigned        nodeId
 ) {
     s_log->AddLineF("Notify: Node deleted: {}", nodeId);
+    s_nodeCache.Remove(nodeId);
     VaultCull(nodeId);
 }
 
@@ -616,6 +870,8 @@ static void SaveDirtyNodes () {
                 break;
             if (node->IsDirty()) {
                 if (unsigned bytes = NetCliAuthVaultNodeSave(node.Get(), [](auto result) {}); bytes) {
+                    // The server's copy is about to get a new modify time
+                    s_nodeCache.Remove(nodeId);
                     bytesWritten += bytes;
                     node->Print("Saving", 0);
                 }
@@ -675,6 +931,13 @@ void VaultDownloadTrans::VaultNodeFetched (
     }
 
     if (!nodesLeft) {
+        uint32_t elapsedMs = hsTimer::GetMilliSeconds<uint32_t>() - startMs;
+        s_log->AddLineF(
+            "(Download) {}: {} nodes in {} ms ({.1f} nodes/sec)",
+            tag, nodeCount, elapsedMs,
+            elapsedMs ? nodeCount * 1000.0 / elapsedMs : 0.0
+        );
+
         VaultDump(tag, vaultId);
 
         if (callback)
@@ -709,7 +972,7 @@ void VaultDownloadTrans::VaultNodeRefsFetched (
             // root node has no child heirarchy? Make sure we still d/l the root node if necessary.
             auto rootNodeIt = s_nodes.find(vaultId);
             if (rootNodeIt == s_nodes.end() || rootNodeIt->second->GetNodeType() == 0) {
-                NetCliAuthVaultNodeFetch(vaultId, [this](auto result, auto node) {
+                QueueNodeFetch(vaultId, [this](auto result, auto node) {
                     VaultNodeFetched(result, node);
                 });
                 nodesLeft = 1;
@@ -724,6 +987,10 @@ void VaultDownloadTrans::VaultNodeRefsFetched (
 
         delete this;
     }
+
+    // Only now that nodesLeft is right; cached nodes are delivered from in here
+    // (and the last one deletes us)
+    PumpNodeFetches();
 }
 
 
@@ -760,6 +1027,10 @@ void AddChildNodeFetchTrans::VaultNodeRefsFetched (
             callback(result);
         delete this;
     }
+
+    // Only now that opCount is right; cached nodes are delivered from in here
+    // (and the last one deletes us)
+    PumpNodeFetches();
 }
 
 //============================================================================
@@ -1301,6 +1572,18 @@ void VaultDestroy () {
 
     VaultClearDeviceInboxMap();
 
+    SaveNodeCache();
+
+    // Anything still queued or out belongs to the old vault
+    s_fetchRequests.clear();
+    s_fetchQueue.clear();
+    s_fetchesInFlight = 0;
+    s_validateQueue.clear();
+    s_validatesInFlight = 0;
+    ++s_fetchGeneration;
+    plProfile_Set(VaultFetchesQueued, 0);
+    plProfile_Set(VaultFetchesInFlight, 0);
+
     for (auto it = s_nodes.begin(); it != s_nodes.end();) {
         it->second->state->UnlinkFromRelatives();
         it = s_nodes.erase(it);
@@ -0,0 +1,218 @@
+/*==LICENSE==*
+
+CyanWorlds.com Engine - MMOG client, server and tools
+Copyright (C) 2011  Cyan Worlds, Inc.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Additional permissions under GNU GPL version 3 section 7
+
+If you modify this Program, or any covered work, by linking or
+combining it with any of RAD Game Tools Bink SDK, Autodesk 3ds Max SDK,
+NVIDIA PhysX SDK, Microsoft DirectX SDK, OpenSSL library, Independent
+JPEG Group JPEG library, Microsoft Windows Media SDK, or Apple QuickTime SDK
+(or a modified version of those libraries),
+containing parts covered by the terms of the Bink SDK EULA, 3ds Max EULA,
+PhysX SDK EULA, DirectX SDK EULA, OpenSSL and SSLeay licenses, IJG
+JPEG Library README, Windows Media SDK EULA, or QuickTime SDK EULA, the
+licensors of this Program grant you additional
+permission to convey the resulting work. Corresponding Source for a
+non-source form of such a combination shall include the source code for
+the parts of OpenSSL and IJG JPEG Library used as well as that of the covered
+work.
+
+You can contact Cyan Worlds, Inc. by email legal@cyan.com
+ or by snail mail at:
+      Cyan Worlds, Inc.
+      14617 N Newport Hwy
+      Mead, WA   99021
+
+*==LICENSE==*/
+
+#include "plVaultNodeCache.h"
+
+#include <ctime>
+#include <iterator>
+#include <memory>
+#include <string_theory/format>
+
+#include "hsStream.h"
+#include "plFileSystem.h"
+
+#include "pnNetProtocol/pnNpCommon.h"
+
+#include "plFile/plSecureStream.h"
+
+static const uint32_t kCacheMagic   = 0x434E5650;   // 'PVNC'
+static const uint32_t kCacheVersion = 2;
+
+// Modify times only have a resolution of one second, so a node that changes
+// again in the second we fetched it would look current forever. Don't keep
+// nodes that changed this recently; this also soaks up some clock skew
+// between us and the server.
+static const uint32_t kRacyWindowSecs = 10 * 60;
+
+// Anything bigger than this in the file is corruption, not a vault node
+static const uint32_t kMaxNodeSize  = 16 * 1024 * 1024;
+
+//============================================================================
+static uint32_t CurrentTime() {
+    return (uint32_t)time(nullptr);
+}
+
+//============================================================================
+bool plVaultNodeCache::Load(const plFileName& path) {
+    Clear();
+
+    // KI mail and the like lives in here, so it's encrypted like our other data files
+    uint32_t key[4];
+    plSecureStream::GetSecureEncryptionKey(path, key, std::size(key));
+    std::unique_ptr<hsStream> stream = plSecureStream::OpenSecureFile(path, plSecureStream::kRequireEncryption, key);
+    if (!stream)
+        return false;
+
+    if (stream->GetSizeLeft() < 3 * sizeof(uint32_t))
+        return false;
+    if (stream->ReadLE32() != kCacheMagic || stream->ReadLE32() != kCacheVersion)
+        return false;
+
+    uint32_t count = stream->ReadLE32();
+    fEntries.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (stream->GetSizeLeft() < 4 * sizeof(uint32_t))
+            break;
+
+        uint32_t nodeId = stream->ReadLE32();
+        Entry entry;
+        entry.fModifyTime = stream->ReadLE32();
+        entry.fLastUsed = stream->ReadLE32();
+
+        uint32_t size = stream->ReadLE32();
+        if (size > kMaxNodeSize || size > stream->GetSizeLeft())
+            break;
+        entry.fData.resize(size);
+        stream->Read(size, entry.fData.data());
+
+        fEntries[nodeId] = std::move(entry);
+    }
+
+    // A truncated file still gave us everything before the damage
+    fDirty = false;
+    return true;
+}
+
+//============================================================================
+bool plVaultNodeCache::Save(const plFileName& path, uint32_t maxAgeSecs) {
+    uint32_t now = CurrentTime();
+    for (auto it = fEntries.begin(); it != fEntries.end();) {
+        if (now - it->second.fLastUsed > maxAgeSecs)
+            it = fEntries.erase(it);
+        else
+            ++it;
+    }
+
+    plFileSystem::CreateDir(path.StripFileName(), true);
+
+    // Write to the side and move it into place, so a crash halfway through
+    // doesn't cost us the old cache
+    plFileName tempPath = ST::format("{}.tmp", path);
+
+    uint32_t key[4];
+    plSecureStream::GetSecureEncryptionKey(path, key, std::size(key));
+    // Not OpenSecureFileWrite, which only encrypts in external builds
+    auto stream = std::make_unique<plSecureStream>(false, key);
+    if (!stream->Open(tempPath, "wb"))
+        return false;
+
+    stream->WriteLE32(kCacheMagic);
+    stream->WriteLE32(kCacheVersion);
+    stream->WriteLE32((uint32_t)fEntries.size());
+    for (const auto& [nodeId, entry] : fEntries) {
+        stream->WriteLE32(nodeId);
+        stream->WriteLE32(entry.fModifyTime);
+        stream->WriteLE32(entry.fLastUsed);
+        stream->WriteLE32((uint32_t)entry.fData.size());
+        stream->Write((uint32_t)entry.fData.size(), entry.fData.data());
+    }
+    stream->Close();
+    stream.reset();
+
+    if (!plFileSystem::Move(tempPath, path)) {
+        plFileSystem::Unlink(tempPath);
+        return false;
+    }
+
+    fDirty = false;
+    return true;
+}
+
+//============================================================================
+uint32_t plVaultNodeCache::GetModifyTime(uint32_t nodeId) const {
+    auto it = fEntries.find(nodeId);
+    return it == fEntries.end() ? 0 : it->second.fModifyTime;
+}
+
+//============================================================================
+bool plVaultNodeCache::Get(uint32_t nodeId, NetVaultNode* node) {
+    auto it = fEntries.find(nodeId);
+    if (it == fEntries.end())
+        return false;
+
+    node->Clear();
+    if (!node->Read(it->second.fData.data(), it->second.fData.size()) || node->GetNodeId() != nodeId) {
+        // Garbage; make sure we don't try it again
+        node->Clear();
+        fEntries.erase(it);
+        fDirty = true;
+        return false;
+    }
+
+    it->second.fLastUsed = CurrentTime();
+    fDirty = true;
+    return true;
+}
+
+//============================================================================
+void plVaultNodeCache::Store(NetVaultNode* node) {
+    // Without a modify time we'd have nothing to validate the copy against
+    if (!node->GetNodeId() || !node->GetModifyTime())
+        return;
+
+    uint32_t now = CurrentTime();
+    if (node->GetModifyTime() > now || now - node->GetModifyTime() < kRacyWindowSecs) {
+        Remove(node->GetNodeId());
+        return;
+    }
+
+    Entry& entry = fEntries[node->GetNodeId()];
+    entry.fLastUsed = now;
+    if (entry.fModifyTime != node->GetModifyTime() || entry.fData.empty()) {
+        entry.fModifyTime = node->GetModifyTime();
+        entry.fData.clear();
+        node->Write(&entry.fData);
+    }
+    fDirty = true;
+}
+
+//============================================================================
+void plVaultNodeCache::Remove(uint32_t nodeId) {
+    if (fEntries.erase(nodeId))
+        fDirty = true;
+}
+
+//============================================================================
+void plVaultNodeCache::Clear() {
+    fDirty = !fEntries.empty();
+    fEntries.clear();
+}
@@ -0,0 +1,102 @@
+/*==LICENSE==*
+
+CyanWorlds.com Engine - MMOG client, server and tools
+Copyright (C) 2011  Cyan Worlds, Inc.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Additional permissions under GNU GPL version 3 section 7
+
+If you modify this Program, or any covered work, by linking or
+combining it with any of RAD Game Tools Bink SDK, Autodesk 3ds Max SDK,
+NVIDIA PhysX SDK, Microsoft DirectX SDK, OpenSSL library, Independent
+JPEG Group JPEG library, Microsoft Windows Media SDK, or Apple QuickTime SDK
+(or a modified version of those libraries),
+containing parts covered by the terms of the Bink SDK EULA, 3ds Max EULA,
+PhysX SDK EULA, DirectX SDK EULA, OpenSSL and SSLeay licenses, IJG
+JPEG Library README, Windows Media SDK EULA, or QuickTime SDK EULA, the
+licensors of this Program grant you additional
+permission to convey the resulting work. Corresponding Source for a
+non-source form of such a combination shall include the source code for
+the parts of OpenSSL and IJG JPEG Library used as well as that of the covered
+work.
+
+You can contact Cyan Worlds, Inc. by email legal@cyan.com
+ or by snail mail at:
+      Cyan Worlds, Inc.
+      14617 N Newport Hwy
+      Mead, WA   99021
+
+*==LICENSE==*/
+
+#ifndef PLASMA20_SOURCES_PLASMA_PUBUTILLIB_PLVAULT_PLVAULTNODECACHE_H
+#define PLASMA20_SOURCES_PLASMA_PUBUTILLIB_PLVAULT_PLVAULTNODECACHE_H
+
+#include "HeadSpin.h"
+
+#include <unordered_map>
+#include <vector>
+
+class NetVaultNode;
+class plFileName;
+
+//============================================================================
+// plVaultNodeCache
+//
+// Local copy of vault nodes from previous sessions, keyed by node id and the
+// node's modify time. Nodes are kept in their wire format and are only
+// decoded when one is actually used. The file on disk is encrypted with the
+// plSecureStream key for its directory.
+//============================================================================
+class plVaultNodeCache
+{
+    struct Entry
+    {
+        uint32_t fModifyTime;
+        uint32_t fLastUsed;     // unix time, for expiring nodes we never see again
+        std::vector<uint8_t> fData;
+    };
+
+    std::unordered_map<uint32_t, Entry> fEntries;
+    bool fDirty;
+
+public:
+    plVaultNodeCache() : fDirty() { }
+
+    bool Load(const plFileName& path);
+
+    /** Writes the cache out, dropping nodes that haven't been used in \a maxAgeSecs */
+    bool Save(const plFileName& path, uint32_t maxAgeSecs);
+
+    /** Returns the modify time of the cached copy of a node, or 0 if we don't have one */
+    uint32_t GetModifyTime(uint32_t nodeId) const;
+
+    /** Decodes the cached copy of a node into \a node */
+    bool Get(uint32_t nodeId, NetVaultNode* node);
+
+    /**
+     * Caches a node fetched from the server. Nodes modified in the last few
+     * minutes are dropped instead, because a second change within the same
+     * second wouldn't show up in the modify time.
+     */
+    void Store(NetVaultNode* node);
+
+    void Remove(uint32_t nodeId);
+    void Clear();
+
+    size_t GetCount() const { return fEntries.size(); }
+    bool IsDirty() const { return fDirty; }
+};
+
+#endif // PLASMA20_SOURCES_PLASMA_PUBUTILLIB_PLVAULT_PLVAULTNODECACHE_H
@@ -0,0 +1,128 @@
+/*==LICENSE==*
+
+CyanWorlds.com Engine - MMOG client, server and tools
+Copyright (C) 2011  Cyan Worlds, Inc.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Additional permissions under GNU GPL version 3 section 7
+
+If you modify this Program, or any covered work, by linking or
+combining it with any of RAD Game Tools Bink SDK, Autodesk 3ds Max SDK,
+NVIDIA PhysX SDK, Microsoft DirectX SDK, OpenSSL library, Independent
+JPEG Group JPEG library, Microsoft Windows Media SDK, or Apple QuickTime SDK
+(or a modified version of those libraries),
+containing parts covered by the terms of the Bink SDK EULA, 3ds Max EULA,
+PhysX SDK EULA, DirectX SDK EULA, OpenSSL and SSLeay licenses, IJG
+JPEG Library README, Windows Media SDK EULA, or QuickTime SDK EULA, the
+licensors of this Program grant you additional
+permission to convey the resulting work. Corresponding Source for a
+non-source form of such a combination shall include the source code for
+the parts of OpenSSL and IJG JPEG Library used as well as that of the covered
+work.
+
+You can contact Cyan Worlds, Inc. by email legal@cyan.com
+ or by snail mail at:
+      Cyan Worlds, Inc.
+      14617 N Newport Hwy
+      Mead, WA   99021
+
+*==LICENSE==*/
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "hsStream.h"
+#include "plFileSystem.h"
+
+TEST(hsMappedFileStream, readsWholeFile)
+{
+    const plFileName path = "test_hsMappedFileStream.dat";
+    {
+        hsUNIXStream s;
+        ASSERT_TRUE(s.Open(path, "wb"));
+        s.WriteLE32(0xDEADBEEF);
+        s.WriteSafeString(ST_LITERAL("hsMappedFileStream"));
+        s.WriteLE16(1234);
+    }
+
+    {
+        hsMappedFileStream s;
+        ASSERT_TRUE(s.Open(path));
+        EXPECT_EQ(s.GetEOF(), 4U + 2U + 18U + 2U);
+        EXPECT_EQ(s.ReadLE32(), 0xDEADBEEFU);
+        EXPECT_EQ(s.ReadSafeString(), ST_LITERAL("hsMappedFileStream"));
+        EXPECT_EQ(s.ReadLE16(), 1234);
+        EXPECT_TRUE(s.AtEnd());
+
+        // Seeking backwards should just move around in the mapping
+        s.SetPosition(4);
+        EXPECT_EQ(s.ReadSafeString(), ST_LITERAL("hsMappedFileStream"));
+        s.Rewind();
+        EXPECT_EQ(s.ReadLE32(), 0xDEADBEEFU);
+    }
+
+    plFileSystem::Unlink(path);
+}
+
+TEST(hsMappedFileStream, emptyFile)
+{
+    const plFileName path = "test_hsMappedFileStream_empty.dat";
+    {
+        hsUNIXStream s;
+        ASSERT_TRUE(s.Open(path, "wb"));
+    }
+
+    {
+        hsMappedFileStream s;
+        ASSERT_TRUE(s.Open(path));
+        EXPECT_EQ(s.GetEOF(), 0U);
+        EXPECT_TRUE(s.AtEnd());
+    }
+
+    plFileSystem::Unlink(path);
+}
+
+TEST(hsMappedFileStream, missingFile)
+{
+    hsMappedFileStream s;
+    EXPECT_FALSE(s.Open("test_hsMappedFileStream_missing.dat"));
+}
+
+TEST(hsMappedFileStream, shortReadPastEnd)
+{
+    const plFileName path = "test_hsMappedFileStream_short.dat";
+    {
+        hsUNIXStream s;
+        ASSERT_TRUE(s.Open(path, "wb"));
+        s.WriteLE32(0xDEADBEEF);
+    }
+
+    {
+        hsMappedFileStream s;
+        ASSERT_TRUE(s.Open(path));
+
+        // Reading past the end comes up short instead of throwing, like hsBufferedStream
+        uint8_t buffer[16];
+        EXPECT_EQ(s.Read(sizeof(buffer), buffer), 4U);
+        EXPECT_TRUE(s.AtEnd());
+        EXPECT_EQ(s.Read(sizeof(buffer), buffer), 0U);
+
+        s.Rewind();
+        s.Skip(100);
+        EXPECT_EQ(s.GetPosition(), 4U);
+    }
+
+    plFileSystem::Unlink(path);
+}
@@ -0,0 +1,130 @@
+/*==LICENSE==*
+
+CyanWorlds.com Engine - MMOG client, server and tools
+Copyright (C) 2011  Cyan Worlds, Inc.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Additional permissions under GNU GPL version 3 section 7
+
+If you modify this Program, or any covered work, by linking or
+combining it with any of RAD Game Tools Bink SDK, Autodesk 3ds Max SDK,
+NVIDIA PhysX SDK, Microsoft DirectX SDK, OpenSSL library, Independent
+JPEG Group JPEG library, Microsoft Windows Media SDK, or Apple QuickTime SDK
+(or a modified version of those libraries),
+containing parts covered by the terms of the Bink SDK EULA, 3ds Max EULA,
+PhysX SDK EULA, DirectX SDK EULA, OpenSSL and SSLeay licenses, IJG
+JPEG Library README, Windows Media SDK EULA, or QuickTime SDK EULA, the
+licensors of this Program grant you additional
+permission to convey the resulting work. Corresponding Source for a
+non-source form of such a combination shall include the source code for
+the parts of OpenSSL and IJG JPEG Library used as well as that of the covered
+work.
+
+You can contact Cyan Worlds, Inc. by email legal@cyan.com
+ or by snail mail at:
+      Cyan Worlds, Inc.
+      14617 N Newport Hwy
+      Mead, WA   99021
+
+*==LICENSE==*/
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "hsWorkerPool.h"
+
+TEST(hsWorkerPool, runsEveryIndexOnce)
+{
+    hsWorkerPool pool;
+    std::vector<std::atomic<int>> hits(1000);
+    pool.Run(hits.size(), 4, [&hits](size_t i) { hits[i]++; });
+
+    EXPECT_EQ(pool.GetNumWorkers(), 3U);
+    for (const std::atomic<int>& hit : hits)
+        EXPECT_EQ(hit, 1);
+}
+
+TEST(hsWorkerPool, keepsWorkersBetweenBatches)
+{
+    hsWorkerPool pool;
+    std::atomic<size_t> total = 0;
+    for (size_t batch = 0; batch < 500; batch++)
+    {
+        // Lots of small batches, some smaller than the pool itself
+        size_t count = batch % 7;
+        pool.Run(count, 4, [&total](size_t i) { total += i + 1; });
+        EXPECT_EQ(pool.GetNumWorkers(), 3U);
+    }
+
+    size_t expected = 0;
+    for (size_t batch = 0; batch < 500; batch++)
+    {
+        size_t count = batch % 7;
+        expected += count * (count + 1) / 2;
+    }
+    EXPECT_EQ(total, expected);
+}
+
+TEST(hsWorkerPool, singleThreadRunsInline)
+{
+    hsWorkerPool pool;
+    pool.Run(8, 3, [](size_t) {});
+    EXPECT_EQ(pool.GetNumWorkers(), 2U);
+
+    // Dropping to one thread stops the workers and runs on the caller, in order
+    std::vector<size_t> order;
+    std::thread::id caller = std::this_thread::get_id();
+    bool onCaller = true;
+    pool.Run(16, 1, [&](size_t i) {
+        order.push_back(i);
+        onCaller &= std::this_thread::get_id() == caller;
+    });
+    EXPECT_EQ(pool.GetNumWorkers(), 0U);
+    EXPECT_TRUE(onCaller);
+    ASSERT_EQ(order.size(), 16U);
+    for (size_t i = 0; i < order.size(); i++)
+        EXPECT_EQ(order[i], i);
+}
+
+TEST(hsWorkerPool, groupsStayTogetherUnlessTooBig)
+{
+    hsWorkerPool pool;
+    std::vector<size_t> sizes = { 3, 0, 10, 1, 7 };
+    std::vector<std::vector<std::atomic<int>>> hits;
+    for (size_t size : sizes)
+        hits.emplace_back(size);
+    std::vector<std::set<std::thread::id>> threads(sizes.size());
+    std::mutex threadsMutex;
+
+    pool.RunGroups(sizes, 4, 4, [&](size_t group, size_t i) {
+        hits[group][i]++;
+        std::lock_guard<std::mutex> lock(threadsMutex);
+        threads[group].insert(std::this_thread::get_id());
+    });
+
+    for (size_t group = 0; group < sizes.size(); group++)
+    {
+        for (const std::atomic<int>& hit : hits[group])
+            EXPECT_EQ(hit, 1);
+
+        // Groups that fit in one item are never shared between threads
+        if (sizes[group] <= 4)
+            EXPECT_LE(threads[group].size(), 1U);
+    }
+}
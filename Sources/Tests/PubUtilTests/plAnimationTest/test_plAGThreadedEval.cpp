@@ -0,0 +1,162 @@
+/*==LICENSE==*
+
+CyanWorlds.com Engine - MMOG client, server and tools
+Copyright (C) 2011  Cyan Worlds, Inc.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Additional permissions under GNU GPL version 3 section 7
+
+If you modify this Program, or any covered work, by linking or
+combining it with any of RAD Game Tools Bink SDK, Autodesk 3ds Max SDK,
+NVIDIA PhysX SDK, Microsoft DirectX SDK, OpenSSL library, Independent
+JPEG Group JPEG library, Microsoft Windows Media SDK, or Apple QuickTime SDK
+(or a modified version of those libraries),
+containing parts covered by the terms of the Bink SDK EULA, 3ds Max EULA,
+PhysX SDK EULA, DirectX SDK EULA, OpenSSL and SSLeay licenses, IJG
+JPEG Library README, Windows Media SDK EULA, or QuickTime SDK EULA, the
+licensors of this Program grant you additional
+permission to convey the resulting work. Corresponding Source for a
+non-source form of such a combination shall include the source code for
+the parts of OpenSSL and IJG JPEG Library used as well as that of the covered
+work.
+
+You can contact Cyan Worlds, Inc. by email legal@cyan.com
+ or by snail mail at:
+      Cyan Worlds, Inc.
+      14617 N Newport Hwy
+      Mead, WA   99021
+
+*==LICENSE==*/
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include "hsMatrix44.h"
+#include "hsWorkerPool.h"
+#include "plAnimation/plMatrixChannel.h"
+#include "plAnimation/plScalarChannel.h"
+#include "plTransform/hsAffineParts.h"
+
+TEST(plAGThreadedEval, threadedBlendMatchesSerial)
+{
+    hsMatrix44 a, b;
+    hsVector3 transA(1.f, 2.f, 3.f), transB(-4.f, 0.5f, 10.f);
+    a.MakeTranslateMat(&transA);
+    b.MakeTranslateMat(&transB);
+
+    plMatrixConstant* chanA = new plMatrixConstant(a);
+    plMatrixConstant* chanB = new plMatrixConstant(b);
+    plScalarConstant* bias = new plScalarConstant(0.25f);
+    plMatrixBlend* blend = new plMatrixBlend(chanA, chanB, bias, 0);
+
+    hsMatrix44 serial;
+    blend->AffineValue(0.0).ComposeMatrix(&serial);
+
+    // Many workers reading the same graph at once all get the serial answer
+    hsWorkerPool pool;
+    std::vector<hsMatrix44> results(256);
+    std::vector<int> ok(results.size());
+    pool.Run(results.size(), 4, [&](size_t i) {
+        hsAffineParts parts;
+        ok[i] = blend->AffineValueThreaded(0.0, parts);
+        parts.ComposeMatrix(&results[i]);
+    });
+
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        ASSERT_TRUE(ok[i]);
+        for (int row = 0; row < 4; row++)
+        {
+            for (int col = 0; col < 4; col++)
+                EXPECT_FLOAT_EQ(results[i].fMap[row][col], serial.fMap[row][col]);
+        }
+    }
+
+    delete blend;
+    delete bias;
+    delete chanB;
+    delete chanA;
+}
+
+TEST(plAGThreadedEval, smallMastersSpreadOverWorkers)
+{
+    // Lots of small masters, like a room full of avatars: a few blends each
+    constexpr size_t kNumMasters = 64;
+    constexpr size_t kChannelsPerMaster = 8;
+
+    std::vector<plMatrixConstant*> constants;
+    std::vector<plScalarConstant*> biases;
+    std::vector<plMatrixBlend*> blends;
+    for (size_t i = 0; i < kNumMasters * kChannelsPerMaster; i++)
+    {
+        hsMatrix44 a, b;
+        hsVector3 transA((float)i, 1.f, 2.f), transB(-3.f, (float)i * 0.5f, 4.f);
+        a.MakeTranslateMat(&transA);
+        b.MakeTranslateMat(&transB);
+
+        plMatrixConstant* chanA = constants.emplace_back(new plMatrixConstant(a));
+        plMatrixConstant* chanB = constants.emplace_back(new plMatrixConstant(b));
+        plScalarConstant* bias = biases.emplace_back(new plScalarConstant((float)(i % 5) / 4.f));
+        blends.push_back(new plMatrixBlend(chanA, chanB, bias, 0));
+    }
+
+    std::vector<hsMatrix44> serial(blends.size());
+    for (size_t i = 0; i < blends.size(); i++)
+        blends[i]->AffineValue(0.0).ComposeMatrix(&serial[i]);
+
+    hsWorkerPool pool;
+    std::vector<size_t> sizes(kNumMasters, kChannelsPerMaster);
+    std::vector<hsMatrix44> results(blends.size());
+    std::vector<int> ok(blends.size());
+    std::set<std::thread::id> threads;
+    std::mutex threadsMutex;
+    pool.RunGroups(sizes, 128, 4, [&](size_t master, size_t i) {
+        if (i == 0)
+        {
+            // Give the workers a chance to wake up before the caller has
+            // done everything itself
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            std::lock_guard<std::mutex> lock(threadsMutex);
+            threads.insert(std::this_thread::get_id());
+        }
+
+        size_t channel = master * kChannelsPerMaster + i;
+        hsAffineParts parts;
+        ok[channel] = blends[channel]->AffineValueThreaded(0.0, parts);
+        parts.ComposeMatrix(&results[channel]);
+    });
+
+    EXPECT_GT(threads.size(), 1U);
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        ASSERT_TRUE(ok[i]);
+        for (int row = 0; row < 4; row++)
+        {
+            for (int col = 0; col < 4; col++)
+                EXPECT_FLOAT_EQ(results[i].fMap[row][col], serial[i].fMap[row][col]);
+        }
+    }
+
+    for (plMatrixBlend* blend : blends)
+        delete blend;
+    for (plScalarConstant* bias : biases)
+        delete bias;
+    for (plMatrixConstant* constant : constants)
+        delete constant;
+}
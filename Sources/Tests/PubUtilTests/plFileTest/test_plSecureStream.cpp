@@ -0,0 +1,149 @@
+/*==LICENSE==*
+
+CyanWorlds.com Engine - MMOG client, server and tools
+Copyright (C) 2011  Cyan Worlds, Inc.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Additional permissions under GNU GPL version 3 section 7
+
+If you modify this Program, or any covered work, by linking or
+combining it with any of RAD Game Tools Bink SDK, Autodesk 3ds Max SDK,
+NVIDIA PhysX SDK, Microsoft DirectX SDK, OpenSSL library, Independent
+JPEG Group JPEG library, Microsoft Windows Media SDK, or Apple QuickTime SDK
+(or a modified version of those libraries),
+containing parts covered by the terms of the Bink SDK EULA, 3ds Max EULA,
+PhysX SDK EULA, DirectX SDK EULA, OpenSSL and SSLeay licenses, IJG
+JPEG Library README, Windows Media SDK EULA, or QuickTime SDK EULA, the
+licensors of this Program grant you additional
+permission to convey the resulting work. Corresponding Source for a
+non-source form of such a combination shall include the source code for
+the parts of OpenSSL and IJG JPEG Library used as well as that of the covered
+work.
+
+You can contact Cyan Worlds, Inc. by email legal@cyan.com
+ or by snail mail at:
+      Cyan Worlds, Inc.
+      14617 N Newport Hwy
+      Mead, WA   99021
+
+*==LICENSE==*/
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "hsStream.h"
+#include "plFileSystem.h"
+#include "plFile/plSecureStream.h"
+
+static std::vector<uint8_t> MakeSecureFile(const plFileName& path, uint32_t size)
+{
+    std::vector<uint8_t> data(size);
+    for (uint32_t i = 0; i < size; ++i)
+        data[i] = uint8_t((i * 7) ^ (i >> 8));
+
+    plSecureStream s;
+    EXPECT_TRUE(s.Open(path, "wb"));
+    s.Write(size, data.data());
+    // The file is encrypted and written out when the stream goes away
+    return data;
+}
+
+static void ExpectRead(plSecureStream& s, const std::vector<uint8_t>& data, uint32_t pos, uint32_t bytes)
+{
+    std::vector<uint8_t> buf(bytes);
+    s.SetPosition(pos);
+    uint32_t expected = std::min(bytes, uint32_t(data.size()) - pos);
+    ASSERT_EQ(s.Read(bytes, buf.data()), expected) << "pos " << pos;
+    EXPECT_EQ(s.GetPosition(), pos + expected);
+    EXPECT_TRUE(std::equal(buf.begin(), buf.begin() + expected, data.begin() + pos)) << "pos " << pos;
+}
+
+TEST(plSecureStream, smallFileIsBuffered)
+{
+    const plFileName path = "test_plSecureStream_small.dat";
+    std::vector<uint8_t> data = MakeSecureFile(path, 101);
+    ASSERT_TRUE(plSecureStream::IsSecureFile(path));
+
+    plSecureStream s;
+    ASSERT_TRUE(s.Open(path, "rb"));
+    EXPECT_EQ(s.GetActualFileSize(), 101U);
+    ExpectRead(s, data, 0, 101);
+    EXPECT_TRUE(s.AtEnd());
+    ExpectRead(s, data, 13, 50);
+
+    plFileSystem::Unlink(path);
+}
+
+TEST(plSecureStream, randomAccess)
+{
+    // Big enough to skip the small file buffering, and not a multiple of the
+    // cipher chunk, so the padding at the end has to be trimmed.
+    const plFileName path = "test_plSecureStream_random.dat";
+    std::vector<uint8_t> data = MakeSecureFile(path, 100003);
+
+    plSecureStream s;
+    ASSERT_TRUE(s.Open(path, "rb"));
+    EXPECT_EQ(s.GetEOF(), 100003U);
+
+    ExpectRead(s, data, 0, 100003);
+    EXPECT_TRUE(s.AtEnd());
+
+    // Small unaligned reads, reads spanning decrypt blocks, and big reads that
+    // start unaligned and run past the end of the file
+    ExpectRead(s, data, 3, 5);
+    ExpectRead(s, data, 16381, 9);
+    ExpectRead(s, data, 99999, 16);
+    ExpectRead(s, data, 8, 40000);
+    ExpectRead(s, data, 5, 70000);
+    ExpectRead(s, data, 32768, 100000);
+
+    s.Rewind();
+    EXPECT_EQ(s.GetPosition(), 0U);
+    s.Skip(1000);
+    uint8_t byte;
+    ASSERT_EQ(s.Read(1, &byte), 1U);
+    EXPECT_EQ(byte, data[1000]);
+
+    s.FastFwd();
+    EXPECT_TRUE(s.AtEnd());
+    EXPECT_EQ(s.Read(1, &byte), 0U);
+
+    plFileSystem::Unlink(path);
+}
+
+TEST(plSecureStream, parallelBulkRead)
+{
+    const plFileName path = "test_plSecureStream_bulk.dat";
+    std::vector<uint8_t> data = MakeSecureFile(path, 2 * 1024 * 1024 + 5);
+
+    uint32_t oldThreads = plSecureStream::GetMaxDecryptThreads();
+    plSecureStream::SetMaxDecryptThreads(4);
+    {
+        plSecureStream s;
+        ASSERT_TRUE(s.Open(path, "rb"));
+        ExpectRead(s, data, 0, uint32_t(data.size()));
+    }
+    {
+        hsUNIXStream base;
+        ASSERT_TRUE(base.Open(path, "rb"));
+        plSecureStream s(&base);
+        ExpectRead(s, data, 0, uint32_t(data.size()));
+        ExpectRead(s, data, 123457, 4096);
+    }
+    plSecureStream::SetMaxDecryptThreads(oldThreads);
+
+    plFileSystem::Unlink(path);
+}
@@ -0,0 +1,125 @@
+/*==LICENSE==*
+
+CyanWorlds.com Engine - MMOG client, server and tools
+Copyright (C) 2011  Cyan Worlds, Inc.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Additional permissions under GNU GPL version 3 section 7
+
+If you modify this Program, or any covered work, by linking or
+combining it with any of RAD Game Tools Bink SDK, Autodesk 3ds Max SDK,
+NVIDIA PhysX SDK, Microsoft DirectX SDK, OpenSSL library, Independent
+JPEG Group JPEG library, Microsoft Windows Media SDK, or Apple QuickTime SDK
+(or a modified version of those libraries),
+containing parts covered by the terms of the Bink SDK EULA, 3ds Max EULA,
+PhysX SDK EULA, DirectX SDK EULA, OpenSSL and SSLeay licenses, IJG
+JPEG Library README, Windows Media SDK EULA, or QuickTime SDK EULA, the
+licensors of this Program grant you additional
+permission to convey the resulting work. Corresponding Source for a
+non-source form of such a combination shall include the source code for
+the parts of OpenSSL and IJG JPEG Library used as well as that of the covered
+work.
+
+You can contact Cyan Worlds, Inc. by email legal@cyan.com
+ or by snail mail at:
+      Cyan Worlds, Inc.
+      14617 N Newport Hwy
+      Mead, WA   99021
+
+*==LICENSE==*/
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <random>
+
+#include "hsEndian.h"
+#include "plGImage/hsDXTSoftwareCodec.h"
+
+using ExpandFunc = hsDXTSoftwareCodec::expand_block32_ptr;
+
+// Runs a batch of random blocks (with and without DXT5 alpha) through both
+// functions and requires identical output, including the pixels outside the
+// block that must not be touched.
+static void CompareExpanders(ExpandFunc expected, ExpandFunc actual)
+{
+    constexpr uint32_t kStride = 7;
+    std::mt19937 rng(0x44585431);
+
+    for (int n = 0; n < 10000; n++) {
+        uint32_t colors[4], alphas[8];
+        for (uint32_t& c : colors)
+            c = rng();
+        for (uint32_t& a : alphas)
+            a = rng();
+        uint32_t colorBits = rng();
+        uint64_t alphaBits = (uint64_t(rng()) << 32 | rng()) & 0xFFFFFFFFFFFFULL;
+        const uint32_t* alphaPal = (n & 1) ? alphas : nullptr;
+
+        uint32_t want[kStride * 4], got[kStride * 4];
+        memset(want, 0xCD, sizeof(want));
+        memset(got, 0xCD, sizeof(got));
+        expected(want, kStride, colors, colorBits, alphaPal, alphaBits);
+        actual(got, kStride, colors, colorBits, alphaPal, alphaBits);
+        ASSERT_EQ(0, memcmp(want, got, sizeof(want))) << "block " << n;
+    }
+}
+
+TEST(hsDXTSoftwareCodec, expand_block32_fpu)
+{
+    // Four color block, pixel i uses index i % 4
+    const uint32_t colors[4] = { 0xFF000000, 0xFF0000FF, 0xFF00FF00, 0xFFFF0000 };
+    uint32_t dest[16];
+    hsDXTSoftwareCodec::expand_block32_fpu(dest, 4, colors, 0xE4E4E4E4, nullptr, 0);
+    for (int i = 0; i < 16; i++)
+        EXPECT_EQ(hsToLE32(colors[i % 4]), dest[i]);
+
+    // DXT5 alpha indices are ORed in on top, pixel i uses alpha index 7 - (i % 8)
+    const uint32_t alphas[8] = { 0x00000000, 0x10000000, 0x20000000, 0x30000000,
+                                 0x40000000, 0x50000000, 0x60000000, 0x70000000 };
+    uint64_t alphaBits = 0;
+    for (int i = 15; i >= 0; i--)
+        alphaBits = (alphaBits << 3) | (7 - (i % 8));
+    const uint32_t rgb[4] = { 0x000000, 0x0000FF, 0x00FF00, 0xFF0000 };
+    hsDXTSoftwareCodec::expand_block32_fpu(dest, 4, rgb, 0xE4E4E4E4, alphas, alphaBits);
+    for (int i = 0; i < 16; i++)
+        EXPECT_EQ(hsToLE32(rgb[i % 4] | alphas[7 - (i % 8)]), dest[i]);
+}
+
+TEST(hsDXTSoftwareCodec, expand_block32_dispatch)
+{
+    CompareExpanders(hsDXTSoftwareCodec::expand_block32_fpu,
+                     hsDXTSoftwareCodec::expand_block32.call);
+}
+
+#ifdef HAVE_SSE2
+TEST(hsDXTSoftwareCodec, expand_block32_sse2)
+{
+    if (!hsCpuId::Instance().has_sse2)
+        GTEST_SKIP() << "CPU does not support SSE2";
+    CompareExpanders(hsDXTSoftwareCodec::expand_block32_fpu,
+                     hsDXTSoftwareCodec::expand_block32_sse2);
+}
+#endif
+
+#ifdef HAVE_AVX2
+TEST(hsDXTSoftwareCodec, expand_block32_avx2)
+{
+    if (!hsCpuId::Instance().has_avx2)
+        GTEST_SKIP() << "CPU does not support AVX2";
+    CompareExpanders(hsDXTSoftwareCodec::expand_block32_fpu,
+                     hsDXTSoftwareCodec::expand_block32_avx2);
+}
+#endif
@@ -0,0 +1,183 @@
+/*==LICENSE==*
+
+CyanWorlds.com Engine - MMOG client, server and tools
+Copyright (C) 2011  Cyan Worlds, Inc.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Additional permissions under GNU GPL version 3 section 7
+
+If you modify this Program, or any covered work, by linking or
+combining it with any of RAD Game Tools Bink SDK, Autodesk 3ds Max SDK,
+NVIDIA PhysX SDK, Microsoft DirectX SDK, OpenSSL library, Independent
+JPEG Group JPEG library, Microsoft Windows Media SDK, or Apple QuickTime SDK
+(or a modified version of those libraries),
+containing parts covered by the terms of the Bink SDK EULA, 3ds Max EULA,
+PhysX SDK EULA, DirectX SDK EULA, OpenSSL and SSLeay licenses, IJG
+JPEG Library README, Windows Media SDK EULA, or QuickTime SDK EULA, the
+licensors of this Program grant you additional
+permission to convey the resulting work. Corresponding Source for a
+non-source form of such a combination shall include the source code for
+the parts of OpenSSL and IJG JPEG Library used as well as that of the covered
+work.
+
+You can contact Cyan Worlds, Inc. by email legal@cyan.com
+ or by snail mail at:
+      Cyan Worlds, Inc.
+      14617 N Newport Hwy
+      Mead, WA   99021
+
+*==LICENSE==*/
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <vector>
+
+#include "HeadSpin.h"
+#include "plMath/hsRadixSort.h"
+
+// Builds the order std::stable_sort gives, which a stable radix sort must match exactly.
+template <typename KeyT>
+static std::vector<uint32_t> ReferenceOrder(const std::vector<KeyT>& keys, bool reverse)
+{
+    std::vector<uint32_t> order(keys.size());
+    std::iota(order.begin(), order.end(), 0);
+    if (reverse)
+        std::stable_sort(order.begin(), order.end(), [&keys](uint32_t a, uint32_t b) { return keys[a] > keys[b]; });
+    else
+        std::stable_sort(order.begin(), order.end(), [&keys](uint32_t a, uint32_t b) { return keys[a] < keys[b]; });
+    return order;
+}
+
+template <typename SortT, typename KeyT>
+static void CheckSort(SortT& sorter, const std::vector<KeyT>& keys, bool reverse)
+{
+    const uint32_t* order = sorter.Sort(keys, reverse);
+    std::vector<uint32_t> want = ReferenceOrder(keys, reverse);
+    for (size_t i = 0; i < keys.size(); i++)
+        ASSERT_EQ(want[i], order[i]) << "at " << i << " of " << keys.size();
+}
+
+static std::vector<float> RandomFloats(std::mt19937& rng, size_t count)
+{
+    std::uniform_real_distribution<float> dist(-1000.f, 1000.f);
+    std::vector<float> keys(count);
+    for (float& key : keys)
+        key = dist(rng);
+    // Throw in some duplicates, zeroes, and tiny values to poke at stability and
+    // the sign handling.
+    for (size_t i = 0; i + 7 < count; i += 7) {
+        keys[i + 1] = keys[i];
+        keys[i + 2] = 0.f;
+        keys[i + 3] *= 1.e-6f;
+    }
+    return keys;
+}
+
+TEST(hsArrayRadixSort, Empty)
+{
+    hsArrayRadixSort<float> sorter;
+    std::vector<float> keys;
+    sorter.Sort(keys);
+
+    keys.push_back(42.f);
+    EXPECT_EQ(0, sorter.Sort(keys)[0]);
+}
+
+TEST(hsArrayRadixSort, Float)
+{
+    std::mt19937 rng(0x52616478);
+    hsArrayRadixSort<float> sorter;
+    for (size_t count : { 2, 3, 17, 256, 5000 }) {
+        std::vector<float> keys = RandomFloats(rng, count);
+        CheckSort(sorter, keys, false);
+        CheckSort(sorter, keys, true);
+    }
+}
+
+TEST(hsArrayRadixSort, Float11BitDigits)
+{
+    std::mt19937 rng(0x31314269);
+    hsArrayRadixSort<float, 11> sorter;
+    for (size_t count : { 2, 100, 20000 }) {
+        std::vector<float> keys = RandomFloats(rng, count);
+        CheckSort(sorter, keys, false);
+        CheckSort(sorter, keys, true);
+    }
+}
+
+TEST(hsArrayRadixSort, SignedInt)
+{
+    std::mt19937 rng(0x53696E74);
+    hsArrayRadixSort<int32_t> sorter;
+    std::vector<int32_t> keys(3000);
+    for (int32_t& key : keys)
+        key = int32_t(rng());
+    keys[10] = std::numeric_limits<int32_t>::min();
+    keys[11] = std::numeric_limits<int32_t>::max();
+    keys[12] = 0;
+    keys[13] = -1;
+    CheckSort(sorter, keys, false);
+    CheckSort(sorter, keys, true);
+}
+
+TEST(hsArrayRadixSort, Unsigned)
+{
+    std::mt19937 rng(0x556E7369);
+    hsArrayRadixSort<uint32_t> sorter;
+    std::vector<uint32_t> keys(3000);
+    // Small values, like render levels, leave the high digits all the same.
+    for (size_t i = 0; i < keys.size(); i++)
+        keys[i] = (i & 1) ? rng() : rng() & 0xff;
+    CheckSort(sorter, keys, false);
+    CheckSort(sorter, keys, true);
+}
+
+TEST(hsArrayRadixSort, AllEqual)
+{
+    hsArrayRadixSort<uint32_t> sorter;
+    std::vector<uint32_t> keys(100, 7);
+    CheckSort(sorter, keys, false);
+    CheckSort(sorter, keys, true);
+}
+
+TEST(hsArrayRadixSort, MatchesLinkedListSort)
+{
+    std::mt19937 rng(0x4C697374);
+    std::vector<float> keys = RandomFloats(rng, 1000);
+
+    std::vector<hsRadixSortElem> elems(keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+        elems[i].fKey.fFloat = keys[i];
+        elems[i].fBody = (intptr_t)i;
+        elems[i].fNext = &elems[i] + 1;
+    }
+    elems.back().fNext = nullptr;
+
+    hsRadixSort rad;
+    hsRadixSortElem* sorted = rad.Sort(elems.data(), hsRadixSort::kFloat);
+
+    hsArrayRadixSort<float> sorter;
+    const uint32_t* order = sorter.Sort(keys);
+
+    // The old sort isn't stable, so only the keys have to agree.
+    for (size_t i = 0; i < keys.size(); i++, sorted = sorted->fNext) {
+        ASSERT_NE(nullptr, sorted);
+        EXPECT_EQ(keys[(size_t)sorted->fBody], keys[order[i]]) << "at " << i;
+    }
+}
@@ -0,0 +1,100 @@
+/*==LICENSE==*
+
+CyanWorlds.com Engine - MMOG client, server and tools
+Copyright (C) 2011  Cyan Worlds, Inc.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Additional permissions under GNU GPL version 3 section 7
+
+If you modify this Program, or any covered work, by linking or
+combining it with any of RAD Game Tools Bink SDK, Autodesk 3ds Max SDK,
+NVIDIA PhysX SDK, Microsoft DirectX SDK, OpenSSL library, Independent
+JPEG Group JPEG library, Microsoft Windows Media SDK, or Apple QuickTime SDK
+(or a modified version of those libraries),
+containing parts covered by the terms of the Bink SDK EULA, 3ds Max EULA,
+PhysX SDK EULA, DirectX SDK EULA, OpenSSL and SSLeay licenses, IJG
+JPEG Library README, Windows Media SDK EULA, or QuickTime SDK EULA, the
+licensors of this Program grant you additional
+permission to convey the resulting work. Corresponding Source for a
+non-source form of such a combination shall include the source code for
+the parts of OpenSSL and IJG JPEG Library used as well as that of the covered
+work.
+
+You can contact Cyan Worlds, Inc. by email legal@cyan.com
+ or by snail mail at:
+      Cyan Worlds, Inc.
+      14617 N Newport Hwy
+      Mead, WA   99021
+
+*==LICENSE==*/
+
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <string_theory/format>
+#include <thread>
+#include <vector>
+
+#include "plFileSystem.h"
+#include "plStatusLog/plStatusLog.h"
+
+TEST(plStatusLog, asyncMultipleProducers)
+{
+    constexpr unsigned kNumThreads = 4;
+    constexpr unsigned kLinesPerThread = 2000;
+
+    plStatusLogMgr& mgr = plStatusLogMgr::GetInstance();
+    uint32_t droppedBefore = mgr.GetNumDroppedLines();
+
+    // Keep a few display lines around so the producers fight over them too
+    plStatusLog* log = mgr.CreateStatusLog(16, "test_plStatusLog.log",
+                                           plStatusLog::kAsyncLog | plStatusLog::kDontRotateLogs);
+    ASSERT_NE(log, nullptr);
+
+    std::vector<std::thread> producers;
+    for (unsigned t = 0; t < kNumThreads; t++) {
+        producers.emplace_back([log, t] {
+            for (unsigned i = 0; i < kLinesPerThread; i++)
+                log->AddLine(ST::format("{} {}", t, i));
+        });
+    }
+    for (std::thread& producer : producers)
+        producer.join();
+
+    mgr.FlushAsyncLogs();
+    uint32_t dropped = mgr.GetNumDroppedLines() - droppedBefore;
+    delete log;
+
+    plFileName path = plFileName::Join(plFileSystem::GetLogPath(), "test_plStatusLog.0.log");
+    FILE* file = plFileSystem::Open(path, "rt");
+    ASSERT_NE(file, nullptr);
+
+    // Lines may be dropped, but never reordered within one producer
+    std::vector<int> lastLine(kNumThreads, -1);
+    unsigned numLines = 0;
+    char buf[256];
+    while (fgets(buf, sizeof(buf), file)) {
+        unsigned t, i;
+        if (sscanf(buf, "%u %u", &t, &i) != 2)
+            continue;
+        ASSERT_LT(t, kNumThreads);
+        EXPECT_GT((int)i, lastLine[t]);
+        lastLine[t] = i;
+        numLines++;
+    }
+    fclose(file);
+    plFileSystem::Unlink(path);
+
+    EXPECT_EQ(numLines + dropped, kNumThreads * kLinesPerThread);
+}
@@ -0,0 +1,162 @@
+/*==LICENSE==*
+
+CyanWorlds.com Engine - MMOG client, server and tools
+Copyright (C) 2011  Cyan Worlds, Inc.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Additional permissions under GNU GPL version 3 section 7
+
+If you modify this Program, or any covered work, by linking or
+combining it with any of RAD Game Tools Bink SDK, Autodesk 3ds Max SDK,
+NVIDIA PhysX SDK, Microsoft DirectX SDK, OpenSSL library, Independent
+JPEG Group JPEG library, Microsoft Windows Media SDK, or Apple QuickTime SDK
+(or a modified version of those libraries),
+containing parts covered by the terms of the Bink SDK EULA, 3ds Max EULA,
+PhysX SDK EULA, DirectX SDK EULA, OpenSSL and SSLeay licenses, IJG
+JPEG Library README, Windows Media SDK EULA, or QuickTime SDK EULA, the
+licensors of this Program grant you additional
+permission to convey the resulting work. Corresponding Source for a
+non-source form of such a combination shall include the source code for
+the parts of OpenSSL and IJG JPEG Library used as well as that of the covered
+work.
+
+You can contact Cyan Worlds, Inc. by email legal@cyan.com
+ or by snail mail at:
+      Cyan Worlds, Inc.
+      14617 N Newport Hwy
+      Mead, WA   99021
+
+*==LICENSE==*/
+
+#include <ctime>
+#include <gtest/gtest.h>
+#include <string_theory/format>
+
+#include "hsRefCnt.h"
+#include "hsStream.h"
+#include "plFileSystem.h"
+#include "pnNetProtocol/pnNpCommon.h"
+#include "plFile/plSecureStream.h"
+#include "plVault/plVaultNodeCache.h"
+
+static hsRef<NetVaultNode> MakeNode(uint32_t nodeId, uint32_t modifyTime, const ST::string& text)
+{
+    hsRef<NetVaultNode> node(new NetVaultNode(), hsStealRef);
+    node->SetNodeId_NoDirty(nodeId);
+    node->SetModifyTime(modifyTime);
+    node->SetNodeType(26);
+    node->SetText_1(text);
+    return node;
+}
+
+TEST(plVaultNodeCache, storeAndGet)
+{
+    plVaultNodeCache cache;
+    hsRef<NetVaultNode> node = MakeNode(1234, 1000, ST_LITERAL("Hello"));
+    cache.Store(node.Get());
+    EXPECT_EQ(cache.GetModifyTime(1234), 1000U);
+    EXPECT_EQ(cache.GetModifyTime(4321), 0U);
+
+    NetVaultNode copy;
+    ASSERT_TRUE(cache.Get(1234, &copy));
+    EXPECT_EQ(copy.GetNodeId(), 1234U);
+    EXPECT_EQ(copy.GetNodeType(), 26U);
+    EXPECT_EQ(copy.GetText_1(), ST_LITERAL("Hello"));
+    EXPECT_FALSE(copy.IsDirty());
+
+    // A newer copy of the node replaces the old one
+    hsRef<NetVaultNode> changed = MakeNode(1234, 2000, ST_LITERAL("Goodbye"));
+    cache.Store(changed.Get());
+    EXPECT_EQ(cache.GetModifyTime(1234), 2000U);
+    ASSERT_TRUE(cache.Get(1234, &copy));
+    EXPECT_EQ(copy.GetText_1(), ST_LITERAL("Goodbye"));
+
+    cache.Remove(1234);
+    EXPECT_EQ(cache.GetModifyTime(1234), 0U);
+    EXPECT_FALSE(cache.Get(1234, &copy));
+}
+
+TEST(plVaultNodeCache, unversionedNodesAreNotCached)
+{
+    plVaultNodeCache cache;
+    hsRef<NetVaultNode> node(new NetVaultNode(), hsStealRef);
+    node->SetNodeId_NoDirty(77);
+    node->SetText_1(ST_LITERAL("No modify time"));
+    cache.Store(node.Get());
+    EXPECT_EQ(cache.GetCount(), 0U);
+}
+
+TEST(plVaultNodeCache, recentlyModifiedNodesAreNotCached)
+{
+    // Another change in this same second would keep the same modify time
+    plVaultNodeCache cache;
+    hsRef<NetVaultNode> node = MakeNode(1234, 1000, ST_LITERAL("Old"));
+    cache.Store(node.Get());
+    EXPECT_EQ(cache.GetCount(), 1U);
+
+    hsRef<NetVaultNode> changed = MakeNode(1234, (uint32_t)time(nullptr), ST_LITERAL("New"));
+    cache.Store(changed.Get());
+    EXPECT_EQ(cache.GetCount(), 0U);
+}
+
+TEST(plVaultNodeCache, saveAndLoad)
+{
+    const plFileName path = "test_plVaultNodeCache.dat";
+
+    {
+        plVaultNodeCache cache;
+        for (uint32_t i = 1; i <= 100; ++i) {
+            hsRef<NetVaultNode> node = MakeNode(i, 5000 + i, ST::format("Node {}", i));
+            cache.Store(node.Get());
+        }
+        ASSERT_TRUE(cache.Save(path, 60));
+        EXPECT_FALSE(cache.IsDirty());
+    }
+
+    // Saved encrypted, and nothing left lying around from the save
+    EXPECT_TRUE(plSecureStream::IsSecureFile(path));
+    EXPECT_FALSE(plFileInfo(ST::format("{}.tmp", path)).Exists());
+
+    plVaultNodeCache cache;
+    ASSERT_TRUE(cache.Load(path));
+    EXPECT_EQ(cache.GetCount(), 100U);
+    for (uint32_t i = 1; i <= 100; ++i) {
+        EXPECT_EQ(cache.GetModifyTime(i), 5000 + i);
+
+        NetVaultNode node;
+        ASSERT_TRUE(cache.Get(i, &node));
+        EXPECT_EQ(node.GetText_1(), ST::format("Node {}", i));
+    }
+
+    plFileSystem::Unlink(path);
+}
+
+TEST(plVaultNodeCache, rejectsGarbage)
+{
+    const plFileName path = "test_plVaultNodeCache_garbage.dat";
+    {
+        hsUNIXStream s;
+        ASSERT_TRUE(s.Open(path, "wb"));
+        s.WriteLE32(0xDEADBEEF);
+        s.WriteLE32(1);
+        s.WriteLE32(1);
+    }
+
+    plVaultNodeCache cache;
+    EXPECT_FALSE(cache.Load(path));
+    EXPECT_EQ(cache.GetCount(), 0U);
+
+    plFileSystem::Unlink(path);
+}
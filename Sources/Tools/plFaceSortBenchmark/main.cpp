@@ -0,0 +1,221 @@
+/*==LICENSE==*
+
+CyanWorlds.com Engine - MMOG client, server and tools
+Copyright (C) 2011  Cyan Worlds, Inc.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Additional permissions under GNU GPL version 3 section 7
+
+If you modify this Program, or any covered work, by linking or
+combining it with any of RAD Game Tools Bink SDK, Autodesk 3ds Max SDK,
+NVIDIA PhysX SDK, Microsoft DirectX SDK, OpenSSL library, Independent
+JPEG Group JPEG library, Microsoft Windows Media SDK, or Apple QuickTime SDK
+(or a modified version of those libraries),
+containing parts covered by the terms of the Bink SDK EULA, 3ds Max EULA,
+PhysX SDK EULA, DirectX SDK EULA, OpenSSL and SSLeay licenses, IJG
+JPEG Library README, Windows Media SDK EULA, or QuickTime SDK EULA, the
+licensors of this Program grant you additional
+permission to convey the resulting work. Corresponding Source for a
+non-source form of such a combination shall include the source code for
+the parts of OpenSSL and IJG JPEG Library used as well as that of the covered
+work.
+
+You can contact Cyan Worlds, Inc. by email legal@cyan.com
+ or by snail mail at:
+      Cyan Worlds, Inc.
+      14617 N Newport Hwy
+      Mead, WA   99021
+
+*==LICENSE==*/
+
+#include <chrono>
+#include <string_theory/stdio>
+#include <vector>
+
+#include "plCmdParser.h"
+#include "hsBounds.h"
+#include "hsGeometry3.h"
+#include "hsMain.inl"
+
+#include "plDrawable/plFaceSorter.h"
+#include "plDrawable/plGBufferGroup.h"
+#include "plMath/hsRadixSort.h"
+
+enum CmdLineArgs
+{
+    kArgFrames,
+};
+
+static const plCmdArgDef s_cmdLineArgs[] = {
+    { (kCmdTypeUint | kCmdArgFlagged), "Frames", kArgFrames },
+};
+
+using ClockT = std::chrono::steady_clock;
+
+// A flat grid of quads, like a water surface seen from the shore.
+static std::vector<plGBufferTriangle> IMakeWater(uint16_t gridSize, float spacing)
+{
+    std::vector<plGBufferTriangle> tris;
+    tris.reserve(gridSize * gridSize * 2);
+    for (uint16_t y = 0; y < gridSize; ++y) {
+        for (uint16_t x = 0; x < gridSize; ++x) {
+            uint16_t v = y * (gridSize + 1) + x;
+            for (int half = 0; half < 2; ++half) {
+                plGBufferTriangle& tri = tris.emplace_back();
+                tri.fIndex1 = v;
+                tri.fIndex2 = half ? v + gridSize + 2 : v + 1;
+                tri.fIndex3 = half ? v + gridSize + 1 : v + gridSize + 2;
+                tri.fSpanIndex = 0;
+                tri.fCenter.Set((x + (half ? 0.33f : 0.67f)) * spacing,
+                                (y + (half ? 0.67f : 0.33f)) * spacing,
+                                0.f);
+            }
+        }
+    }
+    return tris;
+}
+
+// Panes scattered through a box, like a glass-heavy interior.
+static std::vector<plGBufferTriangle> IMakeGlass(uint32_t numTris, float size)
+{
+    std::vector<plGBufferTriangle> tris(numTris);
+    uint32_t seed = 0x1234567;
+    auto rand01 = [&seed]() {
+        seed = seed * 1664525 + 1013904223;
+        return (seed >> 8) / float(1 << 24);
+    };
+    for (uint32_t i = 0; i < numTris; ++i) {
+        tris[i].fIndex1 = uint16_t(i * 3);
+        tris[i].fIndex2 = uint16_t(i * 3 + 1);
+        tris[i].fIndex3 = uint16_t(i * 3 + 2);
+        tris[i].fSpanIndex = 0;
+        tris[i].fCenter.Set(rand01() * size, rand01() * size, rand01() * size * 0.25f);
+    }
+    return tris;
+}
+
+// Mostly standing still or creeping along, with the odd quick turn.
+static hsPoint3 IViewPos(int32_t frame)
+{
+    float t = float(frame / 4) * 0.05f;
+    if ((frame / 60) & 1)
+        t += float(frame % 60);
+    return hsPoint3(-20.f + t, -30.f + 0.5f * t, 6.f);
+}
+
+static double IRunLegacy(const std::vector<plGBufferTriangle>& tris, int32_t frames)
+{
+    std::vector<hsRadixSort::Elem> elems(tris.size());
+    std::vector<uint16_t> indices(tris.size() * 3);
+
+    auto elapsed = ClockT::duration::zero();
+    for (int32_t f = 0; f < frames; ++f) {
+        const hsPoint3 viewPos = IViewPos(f);
+        auto begin = ClockT::now();
+        for (size_t i = 0; i < tris.size(); ++i) {
+            elems[i].fKey.fFloat = -(viewPos - tris[i].fCenter).MagnitudeSquared();
+            elems[i].fBody = (intptr_t)&tris[i];
+            elems[i].fNext = &elems[i] + 1;
+        }
+        elems.back().fNext = nullptr;
+
+        hsRadixSort rad;
+        uint16_t* idx = indices.data();
+        for (hsRadixSort::Elem* e = rad.Sort(elems.data(), 0); e; e = e->fNext) {
+            const plGBufferTriangle* tri = (const plGBufferTriangle*)e->fBody;
+            *idx++ = tri->fIndex1;
+            *idx++ = tri->fIndex2;
+            *idx++ = tri->fIndex3;
+        }
+        elapsed += ClockT::now() - begin;
+    }
+    return std::chrono::duration<double, std::milli>(elapsed).count();
+}
+
+static double IRunSorter(std::vector<plGBufferTriangle> tris, int32_t frames, bool coherent, uint32_t& numSorts)
+{
+    plFaceSorter sorter;
+    std::vector<uint16_t> indices(tris.size() * 3);
+
+    hsBounds3Ext bounds;
+    bounds.MakeEmpty();
+    for (const plGBufferTriangle& tri : tris)
+        bounds.Union(&tri.fCenter);
+
+    hsPoint3 lastViewPos;
+    bool valid = false;
+    numSorts = 0;
+
+    auto elapsed = ClockT::duration::zero();
+    for (int32_t f = 0; f < frames; ++f) {
+        const hsPoint3 viewPos = IViewPos(f);
+        auto begin = ClockT::now();
+        if (!coherent || !valid || !plFaceSorter::IsCoherent(lastViewPos, viewPos, bounds)) {
+            sorter.SortBackToFront(tris.data(), uint32_t(tris.size()), viewPos);
+            lastViewPos = viewPos;
+            valid = true;
+            numSorts++;
+        }
+
+        uint16_t* idx = indices.data();
+        for (const plGBufferTriangle& tri : tris) {
+            *idx++ = tri.fIndex1;
+            *idx++ = tri.fIndex2;
+            *idx++ = tri.fIndex3;
+        }
+        elapsed += ClockT::now() - begin;
+    }
+    return std::chrono::duration<double, std::milli>(elapsed).count();
+}
+
+static void IBenchmark(const char* name, const std::vector<plGBufferTriangle>& tris, int32_t frames)
+{
+    const double totTris = double(tris.size()) * frames;
+    uint32_t numSorts;
+
+    ST::printf("{} ({} triangles):\n", name, tris.size());
+
+    double ms = IRunLegacy(tris, frames);
+    ST::printf("  Linked list radix: {.3f} ms ({.1f} tris/ms)\n", ms, totTris / ms);
+
+    ms = IRunSorter(tris, frames, false, numSorts);
+    ST::printf("  Array radix:       {.3f} ms ({.1f} tris/ms)\n", ms, totTris / ms);
+
+    ms = IRunSorter(tris, frames, true, numSorts);
+    ST::printf("  Array + coherence: {.3f} ms ({.1f} tris/ms, sorted {} of {} frames)\n\n",
+               ms, totTris / ms, numSorts, frames);
+}
+
+static int hsMain(std::vector<ST::string> args)
+{
+    plCmdParser parser(s_cmdLineArgs, std::size(s_cmdLineArgs));
+    parser.Parse(args);
+
+    int32_t frames = 600;
+    if (parser.IsSpecified(kArgFrames))
+        frames = parser.GetInt(kArgFrames);
+    if (frames <= 0) {
+        ST::printf(stderr, "Cannot sort less than 1 frame.\n");
+        return 1;
+    }
+
+    ST::printf("Sorting {} frames of blended spans...\n\n", frames);
+
+    IBenchmark("Water", IMakeWater(128, 2.f), frames);
+    IBenchmark("Glass", IMakeGlass(4000, 40.f), frames);
+
+    ST::printf("Have a nice day!\n");
+    return 0;
+}
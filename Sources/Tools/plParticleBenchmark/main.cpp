@@ -0,0 +1,191 @@
+/*==LICENSE==*
+
+CyanWorlds.com Engine - MMOG client, server and tools
+Copyright (C) 2011  Cyan Worlds, Inc.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Additional permissions under GNU GPL version 3 section 7
+
+If you modify this Program, or any covered work, by linking or
+combining it with any of RAD Game Tools Bink SDK, Autodesk 3ds Max SDK,
+NVIDIA PhysX SDK, Microsoft DirectX SDK, OpenSSL library, Independent
+JPEG Group JPEG library, Microsoft Windows Media SDK, or Apple QuickTime SDK
+(or a modified version of those libraries),
+containing parts covered by the terms of the Bink SDK EULA, 3ds Max EULA,
+PhysX SDK EULA, DirectX SDK EULA, OpenSSL and SSLeay licenses, IJG
+JPEG Library README, Windows Media SDK EULA, or QuickTime SDK EULA, the
+licensors of this Program grant you additional
+permission to convey the resulting work. Corresponding Source for a
+non-source form of such a combination shall include the source code for
+the parts of OpenSSL and IJG JPEG Library used as well as that of the covered
+work.
+
+You can contact Cyan Worlds, Inc. by email legal@cyan.com
+ or by snail mail at:
+      Cyan Worlds, Inc.
+      14617 N Newport Hwy
+      Mead, WA   99021
+
+*==LICENSE==*/
+
+#include <chrono>
+#include <memory>
+#include <string_theory/stdio>
+
+#include "plCmdParser.h"
+#include "hsGeometry3.h"
+#include "hsMath.h"
+#include "hsMatrix44.h"
+#include "hsMain.inl"
+
+#include "plParticleSystem/plParticleEffect.h"
+#include "plParticleSystem/plParticleEmitter.h"
+#include "plParticleSystem/plParticleGenerator.h"
+#include "plParticleSystem/plParticleSystem.h"
+
+enum CmdLineArgs
+{
+    kArgFrames,
+    kArgParticles,
+};
+
+static const plCmdArgDef s_cmdLineArgs[] = {
+    { (kCmdTypeUint | kCmdArgFlagged), "Frames", kArgFrames },
+    { (kCmdTypeUint | kCmdArgFlagged), "Particles", kArgParticles },
+};
+
+using ClockT = std::chrono::steady_clock;
+
+static constexpr float kFrameDelta = 1.f / 60.f;
+
+// A canned emitter setup, roughly matching the kinds of systems the ages ship with.
+struct CannedEmitter
+{
+    const char* fName;
+    float fGravity;
+    float fDrag;
+    float fVelMin, fVelMax;
+    float fPartLife;
+    float fRadsPerSec;
+    uint32_t fEmitterFlags;
+    bool fUniformWind;
+    bool fLocalWind;
+};
+
+static const CannedEmitter s_emitters[] = {
+    { "Fountain", 1.f,    0.1f, 20.f, 30.f, 4.f, 0.f, 0,                                             false, false },
+    { "Smoke",    -0.05f, 0.5f, 2.f,  4.f,  8.f, 1.f, 0,                                             true,  false },
+    { "Leaves",   0.2f,   1.f,  1.f,  3.f,  6.f, 0.f, plParticleEmitter::kOrientationVelocityBased, false, true  },
+};
+
+static plSimpleParticleGenerator* IMakeGenerator(const CannedEmitter& canned, uint32_t maxParticles)
+{
+    hsPoint3* pos = new hsPoint3[1];
+    pos[0].Set(0.f, 0.f, 0.f);
+    float* pitch = new float[1];
+    pitch[0] = 0.f;
+    float* yaw = new float[1];
+    yaw[0] = 0.f;
+
+    // Emit fast enough to keep the pool full for the whole run.
+    float perSecond = 2.f * maxParticles / canned.fPartLife;
+
+    auto gen = new plSimpleParticleGenerator();
+    gen->Init(-1.f, canned.fPartLife, canned.fPartLife, perSecond, 1, pos, pitch, yaw,
+              hsConstants::pi<float> / 4.f, canned.fVelMin, canned.fVelMax,
+              0.5f, 0.5f, 0.8f, 1.2f, 0.5f, canned.fRadsPerSec);
+    return gen;
+}
+
+static int hsMain(std::vector<ST::string> args)
+{
+    plCmdParser parser(s_cmdLineArgs, std::size(s_cmdLineArgs));
+    parser.Parse(args);
+
+    int32_t frames = 600;
+    if (parser.IsSpecified(kArgFrames))
+        frames = parser.GetInt(kArgFrames);
+    if (frames <= 0) {
+        ST::printf(stderr, "Cannot simulate less than 1 frame.\n");
+        return 1;
+    }
+
+    int32_t maxParticles = 10000;
+    if (parser.IsSpecified(kArgParticles))
+        maxParticles = parser.GetInt(kArgParticles);
+    if (maxParticles <= 0) {
+        ST::printf(stderr, "Cannot simulate less than 1 particle.\n");
+        return 1;
+    }
+
+    ST::printf("Stepping {} frames of up to {} particles per emitter...\n\n", frames, maxParticles);
+
+    for (const CannedEmitter& canned : s_emitters) {
+        auto system = std::make_unique<plParticleSystem>();
+        system->Init(1, 1, maxParticles, 1, nullptr, nullptr, nullptr, nullptr, nullptr);
+        system->SetGravity(canned.fGravity);
+        system->SetDrag(canned.fDrag);
+
+        std::unique_ptr<plParticleUniformWind> uniformWind;
+        if (canned.fUniformWind) {
+            uniformWind = std::make_unique<plParticleUniformWind>();
+            uniformWind->SetStrength(10.f);
+            uniformWind->SetConstancy(0.5f);
+            uniformWind->SetRefDirection(hsVector3(1.f, 0.f, 0.f));
+            uniformWind->SetFrequencyRange(1.f, 4.f);
+            system->AddEffect(uniformWind.get(), plParticleSystem::kEffectForce);
+        }
+
+        std::unique_ptr<plParticleLocalWind> localWind;
+        if (canned.fLocalWind) {
+            localWind = std::make_unique<plParticleLocalWind>();
+            localWind->SetStrength(10.f);
+            localWind->SetConstancy(0.2f);
+            localWind->SetScale(hsVector3(20.f, 20.f, 0.f));
+            localWind->SetSpeed(5.f);
+            localWind->SetRefDirection(hsVector3(0.f, 1.f, 0.f));
+            system->AddEffect(localWind.get(), plParticleSystem::kEffectForce);
+        }
+
+        system->AddEmitter(maxParticles, IMakeGenerator(canned, maxParticles), canned.fEmitterFlags);
+        plParticleEmitter* emitter = system->GetEmitter(system->GetNumEmitters() - 1);
+        emitter->OverrideLocalToWorld(hsMatrix44::IdentityMatrix());
+
+        // Let the pool fill before we start timing.
+        double secs = 0.0;
+        for (int32_t i = 0; i < frames; ++i, secs += kFrameDelta)
+            system->Simulate(secs, kFrameDelta);
+
+        uint64_t stepped = 0;
+        auto elapsed = ClockT::duration::zero();
+        for (int32_t i = 0; i < frames; ++i, secs += kFrameDelta) {
+            stepped += emitter->GetParticleCount();
+            auto begin = ClockT::now();
+            system->Simulate(secs, kFrameDelta);
+            elapsed += ClockT::now() - begin;
+        }
+
+        auto elapsed_ms = std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(elapsed);
+        double rate = elapsed_ms.count() > 0.0 ? stepped / elapsed_ms.count() : 0.0;
+        ST::printf("{>10}: {} particle steps in {.3f} ms ({.1f} particles/ms)\n",
+                   canned.fName, stepped, elapsed_ms.count(), rate);
+
+        // The system doesn't own its effects, so drop it before they go.
+        system.reset();
+    }
+
+    ST::printf("\nHave a nice day!\n");
+    return 0;
+}
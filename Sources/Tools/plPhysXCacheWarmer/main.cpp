@@ -0,0 +1,175 @@
+/*==LICENSE==*
+
+CyanWorlds.com Engine - MMOG client, server and tools
+Copyright (C) 2011  Cyan Worlds, Inc.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Additional permissions under GNU GPL version 3 section 7
+
+If you modify this Program, or any covered work, by linking or
+combining it with any of RAD Game Tools Bink SDK, Autodesk 3ds Max SDK,
+NVIDIA PhysX SDK, Microsoft DirectX SDK, OpenSSL library, Independent
+JPEG Group JPEG library, Microsoft Windows Media SDK, or Apple QuickTime SDK
+(or a modified version of those libraries),
+containing parts covered by the terms of the Bink SDK EULA, 3ds Max EULA,
+PhysX SDK EULA, DirectX SDK EULA, OpenSSL and SSLeay licenses, IJG
+JPEG Library README, Windows Media SDK EULA, or QuickTime SDK EULA, the
+licensors of this Program grant you additional
+permission to convey the resulting work. Corresponding Source for a
+non-source form of such a combination shall include the source code for
+the parts of OpenSSL and IJG JPEG Library used as well as that of the covered
+work.
+
+You can contact Cyan Worlds, Inc. by email legal@cyan.com
+ or by snail mail at:
+      Cyan Worlds, Inc.
+      14617 N Newport Hwy
+      Mead, WA   99021
+
+*==LICENSE==*/
+
+#include <chrono>
+#include <string_theory/stdio>
+#include <vector>
+
+#include "plCmdParser.h"
+#include "plFileSystem.h"
+#include "hsMain.inl"
+
+#include "pnKeyedObject/plKey.h"
+#include "pnNetCommon/plSynchedObject.h"
+
+#include "plGImage/plFontCache.h"
+#include "plPhysX/plPXPhysical.h"
+#include "plPhysX/plPXSimulation.h"
+#include "plPhysX/plSimulationMgr.h"
+#include "plResMgr/plRegistryHelpers.h"
+#include "plResMgr/plRegistryNode.h"
+#include "plResMgr/plResManager.h"
+
+#include "pfPython/plPythonFileMod.h"
+
+enum CmdLineArgs
+{
+    kArgCacheDir,
+    kArgDirectory,
+};
+
+static const plCmdArgDef s_cmdLineArgs[] = {
+    { (kCmdTypeString | kCmdArgFlagged), "CacheDir", kArgCacheDir },
+    { (kCmdTypeString | kCmdArgRequired), "Directory", kArgDirectory },
+};
+
+using ClockT = std::chrono::steady_clock;
+
+class plPhysicalKeyCollector : public plRegistryKeyIterator
+{
+public:
+    std::vector<plKey> fKeys;
+
+    bool EatKey(const plKey& key) override
+    {
+        fKeys.push_back(key);
+        return true;
+    }
+};
+
+/** Loads (and therefore cooks) every physical in the page, then lets them go again. */
+static uint32_t IWarmPage(plResManager* resMgr, const plFileName& pagePath)
+{
+    resMgr->AddSinglePage(pagePath);
+    plRegistryPageNode* page = resMgr->FindSinglePage(pagePath);
+    if (!page || !page->IsValid()) {
+        ST::printf(stderr, "{}: not a valid page, skipping\n", pagePath.GetFileName());
+        resMgr->RemoveSinglePage(pagePath);
+        return 0;
+    }
+
+    resMgr->LoadPageKeys(page);
+
+    plPhysicalKeyCollector collector;
+    page->IterateKeys(&collector, plPXPhysical::Index());
+    for (const plKey& key : collector.fKeys) {
+        key->VerifyLoaded();
+        key->RefObject();
+        key->UnRefObject();
+    }
+
+    uint32_t numPhysicals = (uint32_t)collector.fKeys.size();
+    collector.fKeys.clear();
+    resMgr->RemoveSinglePage(pagePath);
+    return numPhysicals;
+}
+
+static int hsMain(std::vector<ST::string> args)
+{
+    plCmdParser parser(s_cmdLineArgs, std::size(s_cmdLineArgs));
+    if (!parser.Parse(args)) {
+        ST::printf(stderr, "Usage: plPhysXCacheWarmer [-CacheDir=path] <data directory>\n");
+        return 1;
+    }
+
+    plFileName dataDir = parser.GetString(kArgDirectory);
+    if (!dataDir.IsValid() || !plFileInfo(dataDir).IsDirectory()) {
+        ST::printf(stderr, "The directory '{}' does not exist.\n", dataDir);
+        return 1;
+    }
+
+    if (parser.IsSpecified(kArgCacheDir))
+        plPXSimulation::SetCookedMeshCacheDir(parser.GetString(kArgCacheDir));
+
+    // Same setup plPageOptimizer needs to be able to read objects out of a page
+    plResManager* resMgr = new plResManager;
+    hsgResMgr::Init(resMgr);
+    plSimulationMgr::Init();
+    if (!plSimulationMgr::GetInstance()) {
+        ST::printf(stderr, "PhysX failed to initialize, check Simulation.log.\n");
+        hsgResMgr::Shutdown();
+        return 2;
+    }
+    plFontCache* fontCache = new plFontCache;
+    plPythonFileMod::SetAtConvertTime();
+
+    plPXMeshCache& cache = plSimulationMgr::GetInstance()->GetPhysX()->GetMeshCache();
+    ST::printf("Warming cooked mesh cache in '{}' from '{}'...\n", cache.GetDirectory(), dataDir);
+
+    auto begin = ClockT::now();
+    uint32_t numPhysicals = 0;
+    std::vector<plFileName> pages = plFileSystem::ListDir(dataDir, "*.prp");
+    for (size_t i = 0; i < pages.size(); ++i) {
+        ST::printf("\r... Page {} of {}", i + 1, pages.size());
+        numPhysicals += IWarmPage(resMgr, pages[i]);
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(ClockT::now() - begin);
+
+    const plPXMeshCache::Stats& stats = cache.GetStats();
+    ST::printf("\n... Done!\n\n");
+    ST::printf("Pages: {}, physicals: {}\n", pages.size(), numPhysicals);
+    ST::printf("Already cached: {}, cooked and stored: {}, bad entries replaced: {}\n",
+               stats.fHits, stats.fStores, stats.fFailures);
+    ST::printf("Took {.2f} seconds\n", elapsed.count());
+
+    fontCache->UnRegisterAs(kFontCache_KEY);
+    plSimulationMgr::Shutdown();
+
+    // Reading in objects may have generated dirty state which we're obviously
+    // not sending out. Clear it so that we don't have leaked keys before the
+    // ResMgr goes away.
+    std::vector<plSynchedObject::StateDefn> carryOvers;
+    plSynchedObject::ClearDirtyState(carryOvers);
+
+    hsgResMgr::Shutdown();
+    return 0;
+}
@@ -0,0 +1,149 @@
+/*==LICENSE==*
+
+CyanWorlds.com Engine - MMOG client, server and tools
+Copyright (C) 2011  Cyan Worlds, Inc.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Additional permissions under GNU GPL version 3 section 7
+
+If you modify this Program, or any covered work, by linking or
+combining it with any of RAD Game Tools Bink SDK, Autodesk 3ds Max SDK,
+NVIDIA PhysX SDK, Microsoft DirectX SDK, OpenSSL library, Independent
+JPEG Group JPEG library, Microsoft Windows Media SDK, or Apple QuickTime SDK
+(or a modified version of those libraries),
+containing parts covered by the terms of the Bink SDK EULA, 3ds Max EULA,
+PhysX SDK EULA, DirectX SDK EULA, OpenSSL and SSLeay licenses, IJG
+JPEG Library README, Windows Media SDK EULA, or QuickTime SDK EULA, the
+licensors of this Program grant you additional
+permission to convey the resulting work. Corresponding Source for a
+non-source form of such a combination shall include the source code for
+the parts of OpenSSL and IJG JPEG Library used as well as that of the covered
+work.
+
+You can contact Cyan Worlds, Inc. by email legal@cyan.com
+ or by snail mail at:
+      Cyan Worlds, Inc.
+      14617 N Newport Hwy
+      Mead, WA   99021
+
+*==LICENSE==*/
+
+#include <chrono>
+#include <random>
+#include <string_theory/stdio>
+#include <vector>
+
+#include "plCmdParser.h"
+#include "hsMain.inl"
+
+#include "plMath/hsRadixSort.h"
+
+enum CmdLineArgs
+{
+    kArgCount,
+};
+
+static const plCmdArgDef s_cmdLineArgs[] = {
+    { (kCmdTypeUint | kCmdArgFlagged), "Count", kArgCount },
+};
+
+using ClockT = std::chrono::steady_clock;
+
+// Sort every size this many times and report the average.
+static constexpr int32_t kDefaultCount = 200;
+
+static double IElapsedUs(ClockT::duration elapsed, int32_t count)
+{
+    return std::chrono::duration<double, std::micro>(elapsed).count() / count;
+}
+
+static double ITimeLinkedList(const std::vector<float>& keys, int32_t count)
+{
+    std::vector<hsRadixSortElem> elems(keys.size());
+    uint64_t check = 0;
+
+    auto elapsed = ClockT::duration::zero();
+    for (int32_t n = 0; n < count; ++n) {
+        auto begin = ClockT::now();
+        for (size_t i = 0; i < keys.size(); ++i) {
+            elems[i].fKey.fFloat = keys[i];
+            elems[i].fBody = (intptr_t)i;
+            elems[i].fNext = &elems[i] + 1;
+        }
+        elems.back().fNext = nullptr;
+
+        hsRadixSort rad;
+        hsRadixSortElem* sorted = rad.Sort(elems.data(), hsRadixSort::kFloat);
+        check += (uint64_t)sorted->fBody;
+        elapsed += ClockT::now() - begin;
+    }
+
+    // Keep the optimizer honest.
+    if (check == uint64_t(-1))
+        ST::printf("");
+    return IElapsedUs(elapsed, count);
+}
+
+template <uint32_t kDigitBits>
+static double ITimeArray(const std::vector<float>& keys, int32_t count)
+{
+    hsArrayRadixSort<float, kDigitBits> sorter;
+    uint64_t check = 0;
+
+    auto elapsed = ClockT::duration::zero();
+    for (int32_t n = 0; n < count; ++n) {
+        auto begin = ClockT::now();
+        check += sorter.Sort(keys)[0];
+        elapsed += ClockT::now() - begin;
+    }
+
+    if (check == uint64_t(-1))
+        ST::printf("");
+    return IElapsedUs(elapsed, count);
+}
+
+static int hsMain(std::vector<ST::string> args)
+{
+    plCmdParser parser(s_cmdLineArgs, std::size(s_cmdLineArgs));
+    parser.Parse(args);
+
+    int32_t count = kDefaultCount;
+    if (parser.IsSpecified(kArgCount))
+        count = parser.GetInt(kArgCount);
+    if (count <= 0) {
+        ST::printf(stderr, "Cannot iterate less than 1 time.\n");
+        return 1;
+    }
+
+    std::mt19937 rng(0x536F7274);
+    std::uniform_real_distribution<float> dist(-10000.f, 0.f);
+
+    ST::printf("Average of {} sorts of negative squared distances (like the span sort):\n\n", count);
+    ST::printf("{>8}  {>12}  {>12}  {>12}\n", "Keys", "Linked (us)", "8 bit (us)", "11 bit (us)");
+
+    for (size_t size : { 16, 256, 1000, 4000, 16000, 64000 }) {
+        std::vector<float> keys(size);
+        for (float& key : keys)
+            key = dist(rng);
+
+        double linked = ITimeLinkedList(keys, count);
+        double array8 = ITimeArray<8>(keys, count);
+        double array11 = ITimeArray<11>(keys, count);
+        ST::printf("{>8}  {>12.2f}  {>12.2f}  {>12.2f}\n", size, linked, array8, array11);
+    }
+
+    ST::printf("\nHave a nice day!\n");
+    return 0;
+}
@@ -0,0 +1,259 @@
+/*==LICENSE==*
+
+CyanWorlds.com Engine - MMOG client, server and tools
+Copyright (C) 2011  Cyan Worlds, Inc.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Additional permissions under GNU GPL version 3 section 7
+
+If you modify this Program, or any covered work, by linking or
+combining it with any of RAD Game Tools Bink SDK, Autodesk 3ds Max SDK,
+NVIDIA PhysX SDK, Microsoft DirectX SDK, OpenSSL library, Independent
+JPEG Group JPEG library, Microsoft Windows Media SDK, or Apple QuickTime SDK
+(or a modified version of those libraries),
+containing parts covered by the terms of the Bink SDK EULA, 3ds Max EULA,
+PhysX SDK EULA, DirectX SDK EULA, OpenSSL and SSLeay licenses, IJG
+JPEG Library README, Windows Media SDK EULA, or QuickTime SDK EULA, the
+licensors of this Program grant you additional
+permission to convey the resulting work. Corresponding Source for a
+non-source form of such a combination shall include the source code for
+the parts of OpenSSL and IJG JPEG Library used as well as that of the covered
+work.
+
+You can contact Cyan Worlds, Inc. by email legal@cyan.com
+ or by snail mail at:
+      Cyan Worlds, Inc.
+      14617 N Newport Hwy
+      Mead, WA   99021
+
+*==LICENSE==*/
+
+#include <chrono>
+#include <string_theory/stdio>
+
+#include "plCmdParser.h"
+#include "plFileSystem.h"
+#include "hsMain.inl"
+#include "hsStream.h"
+
+#include "plSDL/plSDL.h"
+
+enum CmdLineArgs
+{
+    kArgCount,
+    kArgRepeat,
+    kArgStream,
+    kArgSave,
+    kArgDirectory,
+};
+
+static const plCmdArgDef s_cmdLineArgs[] = {
+    { (kCmdTypeUint | kCmdArgFlagged), "Count", kArgCount },
+    { (kCmdTypeUint | kCmdArgFlagged), "Repeat", kArgRepeat },
+    { (kCmdTypeString | kCmdArgFlagged), "Stream", kArgStream },
+    { (kCmdTypeString | kCmdArgFlagged), "Save", kArgSave },
+    { (kCmdTypeString | kCmdArgOptional), "Directory", kArgDirectory },
+};
+
+using ClockT = std::chrono::steady_clock;
+
+// Stand-in for a recording: every descriptor, set to its defaults, 'repeat' times over
+static uint32_t GenerateStream(hsStream* s, uint32_t repeat)
+{
+    uint32_t numRecs = 0;
+    for (uint32_t i = 0; i < repeat; ++i) {
+        for (plStateDescriptor* desc : *plSDLMgr::GetInstance()->GetDescriptors()) {
+            plStateDataRecord rec(desc);
+            rec.SetFromDefaults(false);
+            rec.WriteStreamHeader(s);
+            rec.Write(s, 0);
+            numRecs++;
+        }
+    }
+    return numRecs;
+}
+
+static bool LoadStream(const plFileName& fileName, hsRAMStream* s)
+{
+    hsUNIXStream file;
+    if (!file.Open(fileName, "rb"))
+        return false;
+
+    std::vector<uint8_t> buf(file.GetEOF());
+    file.Read((uint32_t)buf.size(), buf.data());
+    s->Write((uint32_t)buf.size(), buf.data());
+    return true;
+}
+
+static bool SaveStream(const plFileName& fileName, hsRAMStream* s)
+{
+    hsUNIXStream file;
+    if (!file.Open(fileName, "wb"))
+        return false;
+
+    std::vector<uint8_t> buf(s->GetEOF());
+    s->CopyToMem(buf.data());
+    file.Write((uint32_t)buf.size(), buf.data());
+    return true;
+}
+
+// Read every record in the stream the way a modifier receiving state would,
+// then write it back out the way a modifier sending state would
+static bool RoundTrip(hsStream* in, hsStream* out, uint32_t& numRecs)
+{
+    numRecs = 0;
+    in->Rewind();
+    while (in->GetPosition() < in->GetEOF()) {
+        ST::string name;
+        int version;
+        if (!plStateDataRecord::ReadStreamHeader(in, &name, &version))
+            return false;
+
+        plStateDataRecord rec(name, version);
+        if (!rec.GetDescriptor() || !rec.Read(in, 0))
+            return false;
+
+        rec.WriteStreamHeader(out);
+        rec.Write(out, 0);
+        numRecs++;
+    }
+    return true;
+}
+
+// Look up every descriptor and var in the stream by name
+static void FindAll(hsStream* in)
+{
+    in->Rewind();
+    while (in->GetPosition() < in->GetEOF()) {
+        ST::string name;
+        int version;
+        plStateDataRecord::ReadStreamHeader(in, &name, &version);
+
+        plStateDataRecord rec(name, version);
+        rec.Read(in, 0);
+
+        plSDLMgr::GetInstance()->FindDescriptor(name, plSDL::kLatestVersion);
+        for (int i = 0; i < rec.GetNumVars(); ++i)
+            rec.FindVar(rec.GetVar(i)->GetVarDescriptor()->GetName());
+        for (int i = 0; i < rec.GetNumSDVars(); ++i)
+            rec.FindSDVar(rec.GetSDVar(i)->GetVarDescriptor()->GetName());
+    }
+}
+
+static void PrintResults(const char* label, ClockT::duration elapsed, int32_t count, uint32_t numRecs)
+{
+    auto total_us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed);
+    auto avg_us = std::chrono::duration_cast<std::chrono::microseconds>(elapsed / count);
+    auto total_sec = std::chrono::duration_cast<std::chrono::duration<double>>(elapsed);
+    auto avg_sec = std::chrono::duration_cast<std::chrono::duration<double>>(elapsed / count);
+
+    ST::printf("{}:\n", label);
+    ST::printf("  Total: {.4f} seconds ({} us)\n", total_sec.count(), total_us.count());
+    ST::printf("  Average: {.4f} seconds ({} us)\n", avg_sec.count(), avg_us.count());
+    ST::printf("  Per record: {.3f} us\n", double(avg_us.count()) / numRecs);
+}
+
+static int hsMain(std::vector<ST::string> args)
+{
+    plCmdParser parser(s_cmdLineArgs, std::size(s_cmdLineArgs));
+    parser.Parse(args);
+
+    plFileName sdlDir;
+    if (parser.IsSpecified(kArgDirectory))
+        sdlDir = parser.GetString(kArgDirectory);
+    else
+        sdlDir = plFileName::Join(plFileSystem::GetCWD(), "SDL");
+
+    if (!sdlDir.IsValid() || !plFileInfo(sdlDir).IsDirectory()) {
+        ST::printf(stderr, "The directory '{}' does not exist.\n", sdlDir);
+        return 1;
+    }
+
+    int32_t count = 100;
+    if (parser.IsSpecified(kArgCount))
+        count = parser.GetInt(kArgCount);
+    if (count <= 0) {
+        ST::printf(stderr, "Cannot iterate less than 1 time.\n");
+        return 1;
+    }
+
+    ST::printf("Parsing the SDL descriptors from '{}'...\n", sdlDir);
+    plSDLMgr::GetInstance()->SetSDLDir(sdlDir);
+    if (!plSDLMgr::GetInstance()->Init(plSDL::kDisallowTimeStamping)) {
+        ST::printf(stderr, "Failed to parse the SDL descriptors.\n");
+        return 1;
+    }
+    ST::printf("Loaded {} descriptors\n", plSDLMgr::GetInstance()->GetDescriptors()->size());
+
+    hsRAMStream stream;
+    if (parser.IsSpecified(kArgStream)) {
+        plFileName streamFile = parser.GetString(kArgStream);
+        if (!LoadStream(streamFile, &stream)) {
+            ST::printf(stderr, "Could not read the SDL stream '{}'.\n", streamFile);
+            return 1;
+        }
+    } else {
+        uint32_t repeat = 64;
+        if (parser.IsSpecified(kArgRepeat))
+            repeat = parser.GetInt(kArgRepeat);
+        GenerateStream(&stream, repeat);
+    }
+
+    if (parser.IsSpecified(kArgSave)) {
+        plFileName saveFile = parser.GetString(kArgSave);
+        if (!SaveStream(saveFile, &stream))
+            ST::printf(stderr, "Could not write the SDL stream '{}'.\n", saveFile);
+    }
+
+    // Make sure the stream is something we can actually chew on
+    hsRAMStream out;
+    uint32_t numRecs;
+    if (!RoundTrip(&stream, &out, numRecs) || numRecs == 0) {
+        ST::printf(stderr, "The SDL stream doesn't match the loaded descriptors.\n");
+        return 1;
+    }
+    ST::printf("Stream has {} records, {} bytes in, {} bytes out\n", numRecs, stream.GetEOF(), out.GetEOF());
+
+    auto rwElapsed = ClockT::duration::zero();
+    for (int32_t i = 0; i < count; ++i) {
+        ST::printf("\r... Read/Write: running iteration {} of {}", i + 1, count);
+        out.Reset();
+        auto begin = ClockT::now();
+        RoundTrip(&stream, &out, numRecs);
+        auto end = ClockT::now();
+        rwElapsed += end - begin;
+    }
+    ST::printf("\n");
+
+    auto findElapsed = ClockT::duration::zero();
+    for (int32_t i = 0; i < count; ++i) {
+        ST::printf("\r... Read/Find: running iteration {} of {}", i + 1, count);
+        auto begin = ClockT::now();
+        FindAll(&stream);
+        auto end = ClockT::now();
+        findElapsed += end - begin;
+    }
+    ST::printf("\n");
+
+    plSDLMgr::GetInstance()->DeInit();
+
+    ST::printf("... Done!\n\n");
+
+    ST::printf("Results:\n");
+    PrintResults("Read/Write", rwElapsed, count, numRecs);
+    PrintResults("Read/Find", findElapsed, count, numRecs);
+    ST::printf("Have a nice day!\n");
+    return 0;
+}